@@ -0,0 +1,121 @@
+#ifndef TREE_SITTER_KOKA_BENCH_H_
+#define TREE_SITTER_KOKA_BENCH_H_
+
+// Shared helpers for the benchmarks in this directory.
+
+#define _POSIX_C_SOURCE 200809L
+
+#include <stdarg.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+static inline double bench_now(void) {
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (double)ts.tv_sec + (double)ts.tv_nsec / 1e9;
+}
+
+struct bench_buffer {
+  char *data;
+  size_t len;
+  size_t cap;
+};
+
+static inline void bench_buffer_reserve(struct bench_buffer *buffer,
+                                        size_t extra) {
+  if (buffer->len + extra + 1 > buffer->cap) {
+    size_t cap = buffer->cap == 0 ? 4096 : buffer->cap;
+    while (buffer->len + extra + 1 > cap) {
+      cap *= 2;
+    }
+    buffer->data = (char *)realloc(buffer->data, cap);
+    buffer->cap = cap;
+  }
+}
+
+static inline void bench_buffer_append(struct bench_buffer *buffer,
+                                       const char *data, size_t len) {
+  bench_buffer_reserve(buffer, len);
+  memcpy(buffer->data + buffer->len, data, len);
+  buffer->len += len;
+  buffer->data[buffer->len] = '\0';
+}
+
+static inline void bench_buffer_printf(struct bench_buffer *buffer,
+                                       const char *format, ...) {
+  va_list args;
+  va_start(args, format);
+  int len = vsnprintf(NULL, 0, format, args);
+  va_end(args);
+
+  bench_buffer_reserve(buffer, (size_t)len);
+  va_start(args, format);
+  vsnprintf(buffer->data + buffer->len, (size_t)len + 1, format, args);
+  va_end(args);
+  buffer->len += (size_t)len;
+}
+
+// Appends one unit of layout-based Koka, exercising effects, externs,
+// comments, matches and handlers. Each unit is BENCH_UNIT_LINES lines long.
+#define BENCH_UNIT_LINES 25
+
+static inline void bench_append_unit(struct bench_buffer *buffer, size_t i) {
+  bench_buffer_printf(
+      buffer,
+      "// Unit %zu.\n"
+      "effect ask%zu\n"
+      "  ctl ask%zu() : int\n"
+      "\n"
+      "extern prim%zu( x : int ) : int\n"
+      "  c  \"kk_prim_%zu\"\n"
+      "  js \"prim%zu\"\n"
+      "\n"
+      "/* Adds the elements of xs that are larger than\n"
+      "   twice k plus one. */\n"
+      "fun compute%zu( xs : list<int>, k : int ) : int\n"
+      "  val base = k * 2 + 1\n"
+      "  match xs\n"
+      "    Cons(x, rest) ->\n"
+      "      if x > base then x - base\n"
+      "      else compute%zu(rest, k + x)\n"
+      "    Nil -> base\n"
+      "\n"
+      "fun run%zu() : console ()\n"
+      "  with handler\n"
+      "    ctl ask%zu() resume(%zu)\n"
+      "  val total = compute%zu([1, 2, 3], ask%zu())\n"
+      "  println(total.show ++ \" \" ++ prim%zu(total).show)\n"
+      "\n"
+      "\n",
+      i, i, i, i, i, i, i, i, i, i, i, i, i, i);
+}
+
+// Generates at least lines lines of Koka.
+static inline char *bench_generate_source(size_t lines, size_t *len) {
+  struct bench_buffer buffer = {NULL, 0, 0};
+  for (size_t i = 0; i * BENCH_UNIT_LINES < lines; i++) {
+    bench_append_unit(&buffer, i);
+  }
+  *len = buffer.len;
+  return buffer.data;
+}
+
+static inline char *bench_read_file(const char *path, size_t *len) {
+  FILE *file = fopen(path, "rb");
+  if (!file) {
+    return NULL;
+  }
+  struct bench_buffer buffer = {NULL, 0, 0};
+  char chunk[65536];
+  size_t read;
+  while ((read = fread(chunk, 1, sizeof(chunk), file)) > 0) {
+    bench_buffer_append(&buffer, chunk, read);
+  }
+  fclose(file);
+  *len = buffer.len;
+  return buffer.data;
+}
+
+#endif // TREE_SITTER_KOKA_BENCH_H_
@@ -0,0 +1,88 @@
+// Benchmarks reassociating every operator expression in a large file with
+// tree_sitter_koka_reassociate, against just walking the tree.
+//
+// Usage: bench-fixity [file.kk]
+//
+// Without a file, a 20k line file is generated.
+
+#include "bench.h"
+#include "tree-sitter-koka-utils.h"
+#include "tree-sitter-koka.h"
+
+#define ITERATIONS 20
+
+// Walks the tree, reassociating every opexpr if table isn't NULL, and returns
+// the number of operators that combine two operands.
+static uint32_t walk(TSTreeCursor *cursor, TSNode root, TSSymbol opexpr,
+                     const TSKokaFixityTable *table, const char *source,
+                     TSKokaOperatorNode *nodes, uint32_t capacity) {
+  uint32_t operators = 0;
+  ts_tree_cursor_reset(cursor, root);
+  while (true) {
+    TSNode node = ts_tree_cursor_current_node(cursor);
+    if (table && ts_node_symbol(node) == opexpr) {
+      uint32_t count =
+          tree_sitter_koka_reassociate(table, node, source, nodes, capacity);
+      operators += count / 2;
+    }
+
+    if (ts_tree_cursor_goto_first_child(cursor)) {
+      continue;
+    }
+    while (!ts_tree_cursor_goto_next_sibling(cursor)) {
+      if (!ts_tree_cursor_goto_parent(cursor)) {
+        return operators;
+      }
+    }
+  }
+}
+
+int main(int argc, char **argv) {
+  size_t len;
+  char *source = argc > 1 ? bench_read_file(argv[1], &len)
+                          : bench_generate_source(20000, &len);
+  if (!source) {
+    fprintf(stderr, "could not read %s\n", argv[1]);
+    return 1;
+  }
+
+  TSParser *parser = ts_parser_new();
+  ts_parser_set_language(parser, tree_sitter_koka());
+  TSTree *tree = ts_parser_parse_string(parser, NULL, source, (uint32_t)len);
+  TSNode root = ts_tree_root_node(tree);
+  TSSymbol opexpr =
+      ts_language_symbol_for_name(tree_sitter_koka(), "opexpr", 6, true);
+
+  TSKokaFixityTable *table =
+      tree_sitter_koka_fixity_table_new(tree_sitter_koka());
+  tree_sitter_koka_fixity_table_add_module(table, root, source, (uint32_t)len);
+  uint32_t capacity = 1024;
+  TSKokaOperatorNode *nodes = malloc(sizeof(TSKokaOperatorNode) * capacity);
+  TSTreeCursor cursor = ts_tree_cursor_new(root);
+
+  double start = bench_now();
+  for (int i = 0; i < ITERATIONS; i++) {
+    walk(&cursor, root, opexpr, NULL, source, nodes, capacity);
+  }
+  double walked = (bench_now() - start) / ITERATIONS;
+
+  uint32_t operators = 0;
+  start = bench_now();
+  for (int i = 0; i < ITERATIONS; i++) {
+    operators = walk(&cursor, root, opexpr, table, source, nodes, capacity);
+  }
+  double reassociated = (bench_now() - start) / ITERATIONS;
+
+  printf("%zu bytes, %u lines, %u operators\n", len,
+         ts_node_end_point(root).row + 1, operators);
+  printf("walk:          %8.3f ms/pass\n", walked * 1e3);
+  printf("reassociating: %8.3f ms/pass\n", reassociated * 1e3);
+
+  ts_tree_cursor_delete(&cursor);
+  free(nodes);
+  tree_sitter_koka_fixity_table_delete(table);
+  ts_tree_delete(tree);
+  ts_parser_delete(parser);
+  free(source);
+  return 0;
+}
@@ -0,0 +1,159 @@
+// Benchmarks full-tree passes over a large file with a TSTreeCursor against
+// the same passes over a tree flattened by tree_sitter_koka_flatten, and over
+// the flattened tree serialized to a file and mapped back in, the way another
+// process would load it. Each pass builds a histogram of node symbols and sums
+// the depth of every node.
+//
+// Usage: bench-flat [file.kk]
+//
+// Without a file, a 20k line file is generated.
+
+#include "bench.h"
+#include "tree-sitter-koka-utils.h"
+#include "tree-sitter-koka.h"
+#include <sys/mman.h>
+
+#define PASSES 20
+
+static uint64_t cursor_pass(TSTreeCursor *cursor, TSNode root,
+                            uint32_t *histogram) {
+  uint64_t depths = 0;
+  uint32_t depth = 0;
+  ts_tree_cursor_reset(cursor, root);
+  while (true) {
+    histogram[ts_node_symbol(ts_tree_cursor_current_node(cursor))]++;
+    depths += depth;
+
+    if (ts_tree_cursor_goto_first_child(cursor)) {
+      depth++;
+      continue;
+    }
+    while (!ts_tree_cursor_goto_next_sibling(cursor)) {
+      if (!ts_tree_cursor_goto_parent(cursor)) {
+        return depths;
+      }
+      depth--;
+    }
+  }
+}
+
+static uint64_t flat_pass(const TSKokaFlatTree *tree, uint32_t *depth,
+                          uint32_t *histogram) {
+  uint64_t depths = 0;
+  for (uint32_t i = 0; i < tree->node_count; i++) {
+    histogram[tree->symbols[i]]++;
+    // Parents precede their children.
+    uint32_t parent = tree->parents[i];
+    depth[i] = parent == TS_KOKA_FLAT_NONE ? 0 : depth[parent] + 1;
+    depths += depth[i];
+  }
+  return depths;
+}
+
+int main(int argc, char **argv) {
+  size_t len;
+  char *source = argc > 1 ? bench_read_file(argv[1], &len)
+                          : bench_generate_source(20000, &len);
+  if (!source) {
+    fprintf(stderr, "could not read %s\n", argv[1]);
+    return 1;
+  }
+
+  TSParser *parser = ts_parser_new();
+  ts_parser_set_language(parser, tree_sitter_koka());
+  TSTree *tree = ts_parser_parse_string(parser, NULL, source, (uint32_t)len);
+  TSNode root = ts_tree_root_node(tree);
+
+  uint32_t symbol_count = ts_language_symbol_count(tree_sitter_koka());
+  uint32_t *cursor_histogram = calloc(symbol_count, sizeof(uint32_t));
+  uint32_t *flat_histogram = calloc(symbol_count, sizeof(uint32_t));
+
+  size_t arena_size = tree_sitter_koka_flat_tree_size(root);
+  void *arena = malloc(arena_size);
+  TSKokaFlatTree flat;
+  double start = bench_now();
+  tree_sitter_koka_flatten(root, arena, arena_size, &flat);
+  double flatten = bench_now() - start;
+
+  TSTreeCursor cursor = ts_tree_cursor_new(root);
+  uint64_t cursor_depths = 0;
+  start = bench_now();
+  for (int i = 0; i < PASSES; i++) {
+    cursor_depths = cursor_pass(&cursor, root, cursor_histogram);
+  }
+  double cursor_time = (bench_now() - start) / PASSES;
+  ts_tree_cursor_delete(&cursor);
+
+  uint32_t *depth = malloc(sizeof(uint32_t) * flat.node_count);
+  uint64_t flat_depths = 0;
+  start = bench_now();
+  for (int i = 0; i < PASSES; i++) {
+    flat_depths = flat_pass(&flat, depth, flat_histogram);
+  }
+  double flat_time = (bench_now() - start) / PASSES;
+
+  if (cursor_depths != flat_depths ||
+      memcmp(cursor_histogram, flat_histogram,
+             sizeof(uint32_t) * symbol_count) != 0) {
+    fprintf(stderr, "cursor and flat passes disagree\n");
+    return 1;
+  }
+
+  start = bench_now();
+  size_t serialized_size =
+      tree_sitter_koka_flat_tree_serialize(&flat, tree_sitter_koka(), NULL, 0);
+  void *serialized = malloc(serialized_size);
+  tree_sitter_koka_flat_tree_serialize(&flat, tree_sitter_koka(), serialized,
+                                       serialized_size);
+  double serialize = bench_now() - start;
+
+  FILE *file = tmpfile();
+  if (!file || fwrite(serialized, 1, serialized_size, file) != serialized_size ||
+      fflush(file) != 0) {
+    fprintf(stderr, "could not write serialized tree\n");
+    return 1;
+  }
+
+  start = bench_now();
+  void *mapped =
+      mmap(NULL, serialized_size, PROT_READ, MAP_PRIVATE, fileno(file), 0);
+  TSKokaFlatTree loaded;
+  if (mapped == MAP_FAILED ||
+      !tree_sitter_koka_flat_tree_load(mapped, serialized_size,
+                                       tree_sitter_koka(), &loaded)) {
+    fprintf(stderr, "could not load serialized tree\n");
+    return 1;
+  }
+  double load = bench_now() - start;
+
+  memset(flat_histogram, 0, sizeof(uint32_t) * symbol_count);
+  start = bench_now();
+  uint64_t loaded_depths = flat_pass(&loaded, depth, flat_histogram);
+  double first_pass = bench_now() - start;
+  if (loaded_depths != flat_depths) {
+    fprintf(stderr, "loaded tree differs\n");
+    return 1;
+  }
+
+  printf("%zu bytes, %u nodes, %zu byte arena\n", len, flat.node_count,
+         arena_size);
+  printf("flatten:          %8.3f ms\n", flatten * 1e3);
+  printf("cursor pass:      %8.3f ms/pass\n", cursor_time * 1e3);
+  printf("flat pass:        %8.3f ms/pass\n", flat_time * 1e3);
+  printf("serialize:        %8.3f ms, %zu bytes\n", serialize * 1e3,
+         serialized_size);
+  printf("mmap and load:    %8.3f ms\n", load * 1e3);
+  printf("mapped pass:      %8.3f ms\n", first_pass * 1e3);
+
+  munmap(mapped, serialized_size);
+  fclose(file);
+  free(serialized);
+  free(depth);
+  free(arena);
+  free(flat_histogram);
+  free(cursor_histogram);
+  ts_tree_delete(tree);
+  ts_parser_delete(parser);
+  free(source);
+  return 0;
+}
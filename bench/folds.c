@@ -0,0 +1,71 @@
+// Benchmarks tree_sitter_koka_folding_ranges against running
+// queries/folds.scm on a large file.
+//
+// Usage: bench-folds [file.kk]
+//
+// Without a file, a 20k line file is generated.
+
+#include "bench.h"
+#include "tree-sitter-koka-utils.h"
+#include "tree-sitter-koka.h"
+
+#define ITERATIONS 50
+
+int main(int argc, char **argv) {
+  size_t len;
+  char *source = argc > 1 ? bench_read_file(argv[1], &len)
+                          : bench_generate_source(20000, &len);
+  if (!source) {
+    fprintf(stderr, "could not read %s\n", argv[1]);
+    return 1;
+  }
+
+  TSParser *parser = ts_parser_new();
+  ts_parser_set_language(parser, tree_sitter_koka());
+  TSTree *tree = ts_parser_parse_string(parser, NULL, source, (uint32_t)len);
+  TSNode root = ts_tree_root_node(tree);
+
+  uint32_t capacity =
+      tree_sitter_koka_folding_ranges(root, source, (uint32_t)len, NULL, 0);
+  TSKokaFoldingRange *ranges = malloc(sizeof(TSKokaFoldingRange) * capacity);
+
+  double start = bench_now();
+  uint32_t count = 0;
+  for (int i = 0; i < ITERATIONS; i++) {
+    count = tree_sitter_koka_folding_ranges(root, source, (uint32_t)len, ranges,
+                                            capacity);
+  }
+  double native = (bench_now() - start) / ITERATIONS;
+
+  const char *query_source = tree_sitter_koka_folds_query();
+  uint32_t error_offset;
+  TSQueryError error_type;
+  TSQuery *query =
+      ts_query_new(tree_sitter_koka(), query_source,
+                   (uint32_t)strlen(query_source), &error_offset, &error_type);
+  TSQueryCursor *cursor = ts_query_cursor_new();
+  uint32_t captures = 0;
+  start = bench_now();
+  for (int i = 0; i < ITERATIONS; i++) {
+    TSQueryMatch match;
+    uint32_t capture_index;
+    captures = 0;
+    ts_query_cursor_exec(cursor, query, root);
+    while (ts_query_cursor_next_capture(cursor, &match, &capture_index)) {
+      captures++;
+    }
+  }
+  double queried = (bench_now() - start) / ITERATIONS;
+
+  printf("%zu bytes, %u lines\n", len, ts_node_end_point(root).row + 1);
+  printf("native:     %8.3f ms/call, %u ranges\n", native * 1e3, count);
+  printf("folds.scm:  %8.3f ms/call, %u captures\n", queried * 1e3, captures);
+
+  ts_query_cursor_delete(cursor);
+  ts_query_delete(query);
+  free(ranges);
+  ts_tree_delete(tree);
+  ts_parser_delete(parser);
+  free(source);
+  return 0;
+}
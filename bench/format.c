@@ -0,0 +1,103 @@
+// Benchmarks tree_sitter_koka_format on a large file, formatting all of it,
+// formatting it again once it's formatted, as on save, and formatting a
+// single declaration, as after an edit.
+//
+// Usage: bench-format [file.kk]
+//
+// Without a file, a 20k line file is generated.
+
+#include "bench.h"
+#include "tree-sitter-koka-utils.h"
+#include "tree-sitter-koka.h"
+
+#define ITERATIONS 20
+#define INDENT_WIDTH 2
+
+static char *apply_edits(const char *source, size_t len,
+                         const TSKokaFormatResult *result, size_t *new_len) {
+  struct bench_buffer buffer = {NULL, 0, 0};
+  uint32_t copied = 0;
+  for (uint32_t i = 0; i < result->edit_count; i++) {
+    const TSKokaFormatEdit *edit = &result->edits[i];
+    bench_buffer_append(&buffer, source + copied, edit->start_byte - copied);
+    bench_buffer_append(&buffer, result->text + edit->text_start,
+                        edit->text_length);
+    copied = edit->end_byte;
+  }
+  bench_buffer_append(&buffer, source + copied, len - copied);
+  *new_len = buffer.len;
+  return buffer.data;
+}
+
+static double time_format(const TSTree *tree, const char *source, size_t len,
+                          const TSRange *ranges, uint32_t range_count,
+                          uint32_t *edit_count) {
+  double start = bench_now();
+  for (int i = 0; i < ITERATIONS; i++) {
+    TSKokaFormatResult result;
+    tree_sitter_koka_format(tree, source, (uint32_t)len, INDENT_WIDTH, ranges,
+                            range_count, &result);
+    *edit_count = result.edit_count;
+    tree_sitter_koka_format_result_delete(&result);
+  }
+  return (bench_now() - start) / ITERATIONS;
+}
+
+int main(int argc, char **argv) {
+  size_t len;
+  char *source = argc > 1 ? bench_read_file(argv[1], &len)
+                          : bench_generate_source(20000, &len);
+  if (!source) {
+    fprintf(stderr, "could not read %s\n", argv[1]);
+    return 1;
+  }
+
+  TSParser *parser = ts_parser_new();
+  ts_parser_set_language(parser, tree_sitter_koka());
+  double start = bench_now();
+  TSTree *tree = ts_parser_parse_string(parser, NULL, source, (uint32_t)len);
+  double parse = bench_now() - start;
+  TSNode root = ts_tree_root_node(tree);
+
+  uint32_t edits;
+  double whole = time_format(tree, source, len, NULL, 0, &edits);
+
+  TSKokaFormatResult result;
+  tree_sitter_koka_format(tree, source, (uint32_t)len, INDENT_WIDTH, NULL, 0,
+                          &result);
+  size_t formatted_len;
+  char *formatted = apply_edits(source, len, &result, &formatted_len);
+  tree_sitter_koka_format_result_delete(&result);
+  TSTree *formatted_tree = ts_parser_parse_string(parser, NULL, formatted,
+                                                  (uint32_t)formatted_len);
+
+  uint32_t reformat_edits;
+  double reformat = time_format(formatted_tree, formatted, formatted_len, NULL,
+                                0, &reformat_edits);
+  if (reformat_edits != 0) {
+    fprintf(stderr, "formatting a formatted file changed %u declarations\n",
+            reformat_edits);
+    return 1;
+  }
+
+  // An edit in the middle of the unformatted file.
+  TSRange range = {.start_byte = (uint32_t)len / 2,
+                   .end_byte = (uint32_t)len / 2};
+  uint32_t range_edits;
+  double ranged = time_format(tree, source, len, &range, 1, &range_edits);
+
+  printf("%zu bytes, %u lines\n", len, ts_node_end_point(root).row + 1);
+  printf("parse:          %8.3f ms\n", parse * 1e3);
+  printf("whole file:     %8.3f ms/call, %u declarations changed\n",
+         whole * 1e3, edits);
+  printf("formatted file: %8.3f ms/call\n", reformat * 1e3);
+  printf("one range:      %8.3f ms/call, %u declarations changed\n",
+         ranged * 1e3, range_edits);
+
+  ts_tree_delete(formatted_tree);
+  free(formatted);
+  ts_tree_delete(tree);
+  ts_parser_delete(parser);
+  free(source);
+  return 0;
+}
@@ -0,0 +1,97 @@
+// Benchmarks tree_sitter_koka_parse_header against parsing a whole file to
+// find its imports.
+//
+// Usage: bench-header [file.kk]
+//
+// Without a file, a 20k line file with 20 imports is generated.
+
+#include "bench.h"
+#include "tree-sitter-koka-utils.h"
+#include "tree-sitter-koka.h"
+
+#define ITERATIONS 20
+
+// Counts the imports in the modulebody children of the root.
+static uint32_t count_imports(TSTree *tree, TSSymbol modulebody,
+                              TSSymbol importdecl) {
+  uint32_t count = 0;
+  TSNode root = ts_tree_root_node(tree);
+  uint32_t child_count = ts_node_named_child_count(root);
+  for (uint32_t i = 0; i < child_count; i++) {
+    TSNode body = ts_node_named_child(root, i);
+    if (ts_node_symbol(body) != modulebody) {
+      continue;
+    }
+    uint32_t decl_count = ts_node_named_child_count(body);
+    for (uint32_t j = 0; j < decl_count; j++) {
+      if (ts_node_symbol(ts_node_named_child(body, j)) == importdecl) {
+        count++;
+      }
+    }
+  }
+  return count;
+}
+
+int main(int argc, char **argv) {
+  size_t len;
+  char *source;
+  if (argc > 1) {
+    source = bench_read_file(argv[1], &len);
+  } else {
+    struct bench_buffer buffer = {NULL, 0, 0};
+    bench_buffer_printf(&buffer, "module bench/header\n\n");
+    for (int i = 0; i < 20; i++) {
+      bench_buffer_printf(&buffer, "import std/module%d\n", i);
+    }
+    bench_buffer_printf(&buffer, "\ninfixl 6 (+++)\n\n");
+    size_t body_len;
+    char *body = bench_generate_source(20000, &body_len);
+    bench_buffer_append(&buffer, body, body_len);
+    free(body);
+    source = buffer.data;
+    len = buffer.len;
+  }
+  if (!source) {
+    fprintf(stderr, "could not read %s\n", argv[1]);
+    return 1;
+  }
+
+  TSParser *parser = ts_parser_new();
+  ts_parser_set_language(parser, tree_sitter_koka());
+  TSSymbol modulebody =
+      ts_language_symbol_for_name(tree_sitter_koka(), "modulebody", 10, true);
+  TSSymbol importdecl =
+      ts_language_symbol_for_name(tree_sitter_koka(), "importdecl", 10, true);
+
+  uint32_t full_imports = 0;
+  double start = bench_now();
+  for (int i = 0; i < ITERATIONS; i++) {
+    TSTree *tree = ts_parser_parse_string(parser, NULL, source, (uint32_t)len);
+    full_imports = count_imports(tree, modulebody, importdecl);
+    ts_tree_delete(tree);
+  }
+  double full = (bench_now() - start) / ITERATIONS;
+
+  uint32_t header_imports = 0;
+  start = bench_now();
+  for (int i = 0; i < ITERATIONS; i++) {
+    TSTree *tree = tree_sitter_koka_parse_header(parser, source, (uint32_t)len);
+    header_imports = count_imports(tree, modulebody, importdecl);
+    ts_tree_delete(tree);
+  }
+  double header = (bench_now() - start) / ITERATIONS;
+
+  if (header_imports != full_imports) {
+    fprintf(stderr, "header and full parses disagree\n");
+    return 1;
+  }
+
+  printf("%zu bytes, %u of them in the header, %u imports\n", len,
+         tree_sitter_koka_header_length(source, (uint32_t)len), full_imports);
+  printf("whole file: %8.3f ms/parse\n", full * 1e3);
+  printf("header:     %8.3f ms/parse\n", header * 1e3);
+
+  ts_parser_delete(parser);
+  free(source);
+  return 0;
+}
@@ -0,0 +1,116 @@
+// Benchmarks re-highlighting after single-character edits, comparing a full
+// pass of queries/highlights.scm with tree_sitter_koka_highlight_delta.
+//
+// Usage: bench-highlight [file.kk]
+//
+// Without a file, a 20k line file is generated.
+
+#include "bench.h"
+#include "tree-sitter-koka-utils.h"
+#include "tree-sitter-koka.h"
+
+#define EDITS 200
+
+static TSPoint point_for_byte(const char *source, uint32_t byte) {
+  TSPoint point = {0, 0};
+  for (uint32_t i = 0; i < byte; i++) {
+    if (source[i] == '\n') {
+      point.row++;
+      point.column = 0;
+    } else {
+      point.column++;
+    }
+  }
+  return point;
+}
+
+int main(int argc, char **argv) {
+  size_t len;
+  char *source = argc > 1 ? bench_read_file(argv[1], &len)
+                          : bench_generate_source(20000, &len);
+  if (!source || len == 0) {
+    fprintf(stderr, "could not read %s\n", argv[1]);
+    return 1;
+  }
+  source = realloc(source, len + EDITS + 1);
+
+  TSParser *parser = ts_parser_new();
+  ts_parser_set_language(parser, tree_sitter_koka());
+  TSTree *tree = ts_parser_parse_string(parser, NULL, source, (uint32_t)len);
+
+  const char *query_source = tree_sitter_koka_highlights_query();
+  uint32_t error_offset;
+  TSQueryError error_type;
+  TSQuery *query =
+      ts_query_new(tree_sitter_koka(), query_source,
+                   (uint32_t)strlen(query_source), &error_offset, &error_type);
+  TSQueryCursor *cursor = ts_query_cursor_new();
+
+  double full = 0, delta_total = 0, reparse = 0;
+  uint64_t full_spans = 0, delta_spans = 0;
+  uint64_t seed = 0x2545F4914F6CDD1Du;
+  for (int i = 0; i < EDITS; i++) {
+    // Insert a space at a random position.
+    seed = seed * 6364136223846793005u + 1442695040888963407u;
+    uint32_t position = (uint32_t)((seed >> 33) % len);
+    memmove(source + position + 1, source + position, len - position);
+    source[position] = ' ';
+    len++;
+
+    TSPoint point = point_for_byte(source, position);
+    TSInputEdit edit = {
+        .start_byte = position,
+        .old_end_byte = position,
+        .new_end_byte = position + 1,
+        .start_point = point,
+        .old_end_point = point,
+        .new_end_point = {point.row, point.column + 1},
+    };
+    ts_tree_edit(tree, &edit);
+
+    double start = bench_now();
+    TSTree *new_tree =
+        ts_parser_parse_string(parser, tree, source, (uint32_t)len);
+    reparse += bench_now() - start;
+
+    start = bench_now();
+    TSQueryMatch match;
+    uint32_t capture_index;
+    ts_query_cursor_exec(cursor, query, ts_tree_root_node(new_tree));
+    while (ts_query_cursor_next_capture(cursor, &match, &capture_index)) {
+      full_spans++;
+    }
+    full += bench_now() - start;
+
+    TSRange edited = {
+        .start_point = edit.start_point,
+        .end_point = edit.new_end_point,
+        .start_byte = edit.start_byte,
+        .end_byte = edit.new_end_byte,
+    };
+    TSKokaHighlightDelta delta;
+    start = bench_now();
+    tree_sitter_koka_highlight_delta(tree, new_tree, query, cursor, &edited, 1,
+                                     &delta);
+    delta_total += bench_now() - start;
+    delta_spans += delta.span_count;
+    tree_sitter_koka_highlight_delta_delete(&delta);
+
+    ts_tree_delete(tree);
+    tree = new_tree;
+  }
+
+  printf("%zu bytes, %d edits\n", len, EDITS);
+  printf("incremental reparse: %8.3f ms/edit\n", reparse / EDITS * 1e3);
+  printf("full highlight:      %8.3f ms/edit, %llu spans/edit\n",
+         full / EDITS * 1e3, (unsigned long long)(full_spans / EDITS));
+  printf("highlight delta:     %8.3f ms/edit, %llu spans/edit\n",
+         delta_total / EDITS * 1e3, (unsigned long long)(delta_spans / EDITS));
+
+  ts_query_cursor_delete(cursor);
+  ts_query_delete(query);
+  ts_tree_delete(tree);
+  ts_parser_delete(parser);
+  free(source);
+  return 0;
+}
@@ -0,0 +1,68 @@
+// Benchmarks parsing generated code with thousands of braces on one line,
+// which is quadratic if the scanner asks for the column of every brace, as
+// get_column rescans the line up to the lexer's position.
+//
+// Usage: bench-longline [declarations]
+//
+// The same declarations are parsed on one line and one per line, at several
+// sizes up to the given number of declarations (4000 by default). The time
+// per byte should stay flat as the line grows.
+
+#include "bench.h"
+#include "tree-sitter-koka.h"
+#include <tree_sitter/api.h>
+
+#define ITERATIONS 5
+
+static char *generate(size_t declarations, const char *separator,
+                      size_t *len) {
+  struct bench_buffer buffer = {NULL, 0, 0};
+  for (size_t i = 0; i < declarations; i++) {
+    bench_buffer_printf(&buffer,
+                        "%sfun f%zu(x : int) : int { if x > %zu then { x - "
+                        "1 } else { val y = { x + 1 }; y * 2 } }",
+                        i > 0 ? separator : "", i, i);
+  }
+  bench_buffer_append(&buffer, "\n", 1);
+  *len = buffer.len;
+  return buffer.data;
+}
+
+static double time_parse(TSParser *parser, const char *source, size_t len,
+                         bool *has_error) {
+  double start = bench_now();
+  for (int i = 0; i < ITERATIONS; i++) {
+    TSTree *tree = ts_parser_parse_string(parser, NULL, source, (uint32_t)len);
+    *has_error = ts_node_has_error(ts_tree_root_node(tree));
+    ts_tree_delete(tree);
+  }
+  return (bench_now() - start) / ITERATIONS;
+}
+
+int main(int argc, char **argv) {
+  size_t max_declarations = argc > 1 ? strtoul(argv[1], NULL, 10) : 4000;
+  TSParser *parser = ts_parser_new();
+  ts_parser_set_language(parser, tree_sitter_koka());
+
+  printf("%8s %10s %14s %14s\n", "decls", "bytes", "one line", "many lines");
+  for (size_t declarations = max_declarations / 8;
+       declarations <= max_declarations && declarations > 0;
+       declarations *= 2) {
+    size_t long_len, short_len;
+    char *long_source = generate(declarations, "; ", &long_len);
+    char *short_source = generate(declarations, "\n", &short_len);
+    bool long_error, short_error;
+    double long_time = time_parse(parser, long_source, long_len, &long_error);
+    double short_time =
+        time_parse(parser, short_source, short_len, &short_error);
+    printf("%8zu %10zu %9.1f ns/B%s %9.1f ns/B%s\n", declarations, long_len,
+           long_time * 1e9 / (double)long_len, long_error ? "*" : " ",
+           short_time * 1e9 / (double)short_len, short_error ? "*" : " ");
+    free(long_source);
+    free(short_source);
+  }
+  printf("(* the tree has errors)\n");
+
+  ts_parser_delete(parser);
+  return 0;
+}
@@ -0,0 +1,113 @@
+// Benchmarks parsing and incrementally reparsing a file that embeds a large
+// raw string, which the scanner lexes as a single token. An edit inside the
+// string rescans all of it, while an edit to the code after it should reuse
+// the string from the old tree.
+//
+// Usage: bench-rawstring [megabytes]
+//
+// The raw string is 10 MB by default, followed by a few hundred lines of code.
+
+#include "bench.h"
+#include "tree-sitter-koka.h"
+#include <tree_sitter/api.h>
+
+#define ITERATIONS 5
+
+static char *generate(size_t string_len, size_t *string_start,
+                      size_t *string_end, size_t *len) {
+  struct bench_buffer buffer = {NULL, 0, 0};
+  bench_buffer_append(&buffer, "val text = r##\"", 15);
+  *string_start = buffer.len;
+  static const char line[] =
+      "Embedded text, with \"quotes\", # signs and \"# near-ends.\n";
+  while (buffer.len - *string_start < string_len) {
+    bench_buffer_append(&buffer, line, sizeof(line) - 1);
+  }
+  *string_end = buffer.len;
+  bench_buffer_append(&buffer, "\"##\n\n", 5);
+  for (int i = 0; i < 100; i++) {
+    bench_buffer_printf(&buffer,
+                        "fun f%d(x : int) : int\n  val y = x + %d\n  y * 2\n\n",
+                        i, i);
+  }
+  *len = buffer.len;
+  return buffer.data;
+}
+
+static TSPoint point_at(const char *source, size_t offset) {
+  TSPoint point = {0, 0};
+  for (size_t i = 0; i < offset; i++) {
+    if (source[i] == '\n') {
+      point.row++;
+      point.column = 0;
+    } else {
+      point.column++;
+    }
+  }
+  return point;
+}
+
+// Times replacing the byte at offset with a different one and reparsing with
+// the old tree, which is what an editor does after a keystroke.
+static double time_edit(TSParser *parser, TSTree *tree, char *source,
+                        size_t len, size_t offset, char replacement) {
+  TSPoint point = point_at(source, offset);
+  TSInputEdit edit = {
+      .start_byte = (uint32_t)offset,
+      .old_end_byte = (uint32_t)offset + 1,
+      .new_end_byte = (uint32_t)offset + 1,
+      .start_point = point,
+      .old_end_point = {point.row, point.column + 1},
+      .new_end_point = {point.row, point.column + 1},
+  };
+  char original = source[offset];
+  double total = 0;
+  for (int i = 0; i < ITERATIONS; i++) {
+    TSTree *old_tree = ts_tree_copy(tree);
+    source[offset] = replacement;
+    ts_tree_edit(old_tree, &edit);
+    double start = bench_now();
+    TSTree *new_tree =
+        ts_parser_parse_string(parser, old_tree, source, (uint32_t)len);
+    total += bench_now() - start;
+    ts_tree_delete(new_tree);
+    ts_tree_delete(old_tree);
+    source[offset] = original;
+  }
+  return total / ITERATIONS;
+}
+
+int main(int argc, char **argv) {
+  size_t megabytes = argc > 1 ? strtoul(argv[1], NULL, 10) : 10;
+  size_t string_start, string_end, len;
+  char *source = generate(megabytes << 20, &string_start, &string_end, &len);
+
+  TSParser *parser = ts_parser_new();
+  ts_parser_set_language(parser, tree_sitter_koka());
+
+  double start = bench_now();
+  for (int i = 0; i < ITERATIONS; i++) {
+    ts_tree_delete(ts_parser_parse_string(parser, NULL, source, (uint32_t)len));
+  }
+  double parse = (bench_now() - start) / ITERATIONS;
+  TSTree *tree = ts_parser_parse_string(parser, NULL, source, (uint32_t)len);
+  bool has_error = ts_node_has_error(ts_tree_root_node(tree));
+
+  // In the middle of the string, and on the last "x" of the file's code.
+  size_t last_x = (size_t)(strrchr(source, 'x') - source);
+  double inside = time_edit(parser, tree, source, len,
+                            (string_start + string_end) / 2, '~');
+  double after = time_edit(parser, tree, source, len, last_x, 'z');
+
+  printf("%zu bytes%s, %zu in the raw string\n", len,
+         has_error ? ", with errors" : "", string_end - string_start);
+  printf("parse:           %10.3f ms, %.1f MB/s\n", parse * 1e3,
+         (double)len / parse / 1e6);
+  printf("edit in string:  %10.3f ms\n", inside * 1e3);
+  printf("edit after it:   %10.3f ms\n", after * 1e3);
+
+  ts_tree_delete(tree);
+  ts_parser_delete(parser);
+  free(source);
+  return 0;
+}
@@ -0,0 +1,98 @@
+// Benchmarks parsing broken Koka, where error recovery runs the external
+// scanner with every token valid. The file is parsed intact, then with
+// increasingly many of its lines broken in ways editors see while typing:
+// truncated halfway, or with an unclosed bracket or a stray operator.
+//
+// Usage: bench-recovery [file.kk]
+//
+// Without a file, a 20k line file is generated.
+
+#include "bench.h"
+#include "tree-sitter-koka.h"
+#include <tree_sitter/api.h>
+
+#define ITERATIONS 5
+
+// Copies source, breaking every nth line, or none if n is 0.
+static char *break_lines(const char *source, size_t len, size_t n,
+                         size_t *out_len) {
+  struct bench_buffer buffer = {NULL, 0, 0};
+  size_t line = 0;
+  for (size_t start = 0; start < len; line++) {
+    const char *newline = memchr(source + start, '\n', len - start);
+    size_t end = newline ? (size_t)(newline - source) : len;
+    size_t line_len = end - start;
+    if (n == 0 || line % n != n - 1 || line_len < 2) {
+      bench_buffer_append(&buffer, source + start, line_len);
+    } else if (line / n % 3 == 0) {
+      bench_buffer_append(&buffer, source + start, line_len / 2);
+    } else if (line / n % 3 == 1) {
+      bench_buffer_append(&buffer, source + start, line_len);
+      bench_buffer_append(&buffer, "(", 1);
+    } else {
+      bench_buffer_append(&buffer, source + start, line_len);
+      bench_buffer_append(&buffer, " +", 2);
+    }
+    bench_buffer_append(&buffer, "\n", 1);
+    start = end + 1;
+  }
+  *out_len = buffer.len;
+  return buffer.data;
+}
+
+static uint32_t count_errors(TSNode node) {
+  if (!ts_node_has_error(node)) {
+    return 0;
+  }
+  uint32_t count = ts_node_is_error(node) || ts_node_is_missing(node);
+  uint32_t child_count = ts_node_child_count(node);
+  for (uint32_t i = 0; i < child_count; i++) {
+    count += count_errors(ts_node_child(node, i));
+  }
+  return count;
+}
+
+int main(int argc, char **argv) {
+  size_t len;
+  char *source = argc > 1 ? bench_read_file(argv[1], &len)
+                          : bench_generate_source(20000, &len);
+  if (!source || len == 0) {
+    fprintf(stderr, "could not read %s\n", argv[1]);
+    return 1;
+  }
+
+  TSParser *parser = ts_parser_new();
+  ts_parser_set_language(parser, tree_sitter_koka());
+
+  // Every nth line is broken, with 0 for the intact file.
+  const size_t intervals[] = {0, 1000, 100, 20, 5};
+  printf("%12s %10s %12s %10s\n", "broken", "errors", "parse", "MB/s");
+  for (size_t i = 0; i < sizeof(intervals) / sizeof(intervals[0]); i++) {
+    size_t broken_len;
+    char *broken = break_lines(source, len, intervals[i], &broken_len);
+    double start = bench_now();
+    for (int j = 0; j < ITERATIONS; j++) {
+      ts_tree_delete(
+          ts_parser_parse_string(parser, NULL, broken, (uint32_t)broken_len));
+    }
+    double parse = (bench_now() - start) / ITERATIONS;
+    TSTree *tree =
+        ts_parser_parse_string(parser, NULL, broken, (uint32_t)broken_len);
+    uint32_t errors = count_errors(ts_tree_root_node(tree));
+    ts_tree_delete(tree);
+
+    char label[32];
+    if (intervals[i] == 0) {
+      snprintf(label, sizeof(label), "none");
+    } else {
+      snprintf(label, sizeof(label), "1 in %zu", intervals[i]);
+    }
+    printf("%12s %10u %9.3f ms %10.1f\n", label, errors, parse * 1e3,
+           (double)broken_len / parse / 1e6);
+    free(broken);
+  }
+
+  ts_parser_delete(parser);
+  free(source);
+  return 0;
+}
@@ -0,0 +1,158 @@
+// Counts calls to the external scanner and measures parse throughput. Calls
+// are counted by parsing with a copy of the language whose scanner functions
+// are wrapped, and grouped by the external tokens that were valid, so the
+// calls made only for the end continuation signal after operators, commas and
+// brackets can be told apart from those at line boundaries and braces.
+//
+// Usage: bench-scanner [-d depth] [file.kk]
+//
+// Without a file, a 20k line file is generated, or with -d, a file of
+// functions that nest blocks depth levels deep and then dedent all of them at
+// once, which takes two zero-width tokens per level.
+
+#include "bench.h"
+#include "tree-sitter-koka.h"
+#include <stdbool.h>
+#include <tree_sitter/api.h>
+
+#include "tree_sitter/parser.h"
+
+#define ITERATIONS 10
+
+// The longest serialized state tree-sitter stores without allocating.
+#define INLINE_STATE_SIZE 24
+
+// Keep in sync with the externals of grammar.js.
+enum { OPEN_BRACE, CLOSE_BRACE, SEMI, RAW_STRING, END_CONTINUATION_SIGNAL };
+
+static struct {
+  uint64_t scans;
+  uint64_t tokens;
+  // Scans where only the end continuation signal was valid.
+  uint64_t signal_only;
+  // Scans where every external token was valid, as in error recovery or when
+  // a state's own lex mode found no token.
+  uint64_t all_valid;
+  uint64_t deserializes;
+  uint64_t serializes;
+  uint64_t serialized_bytes;
+  // Serialized states too long to be stored inline.
+  uint64_t long_states;
+} counts;
+
+static bool (*scan)(void *, TSLexer *, const bool *);
+static void (*deserialize)(void *, const char *, unsigned);
+static unsigned (*serialize)(void *, char *);
+
+static bool counting_scan(void *payload, TSLexer *lexer,
+                          const bool *valid_symbols) {
+  counts.scans++;
+  bool layout_valid = valid_symbols[OPEN_BRACE] ||
+                      valid_symbols[CLOSE_BRACE] || valid_symbols[SEMI] ||
+                      valid_symbols[RAW_STRING];
+  if (!layout_valid && valid_symbols[END_CONTINUATION_SIGNAL]) {
+    counts.signal_only++;
+  }
+  if (valid_symbols[OPEN_BRACE] && valid_symbols[CLOSE_BRACE] &&
+      valid_symbols[SEMI] && valid_symbols[RAW_STRING] &&
+      valid_symbols[END_CONTINUATION_SIGNAL]) {
+    counts.all_valid++;
+  }
+  bool found = scan(payload, lexer, valid_symbols);
+  counts.tokens += found;
+  return found;
+}
+
+static unsigned counting_serialize(void *payload, char *buffer) {
+  unsigned length = serialize(payload, buffer);
+  counts.serializes++;
+  counts.serialized_bytes += length;
+  counts.long_states += length > INLINE_STATE_SIZE;
+  return length;
+}
+
+static void counting_deserialize(void *payload, const char *buffer,
+                                 unsigned length) {
+  counts.deserializes++;
+  deserialize(payload, buffer, length);
+}
+
+static char *generate_nested(size_t depth, size_t len, size_t *out_len) {
+  struct bench_buffer buffer = {NULL, 0, 0};
+  for (size_t i = 0; buffer.len < len; i++) {
+    bench_buffer_printf(&buffer, "fun nested%zu(a : bool) : int\n", i);
+    for (size_t level = 1; level <= depth; level++) {
+      bench_buffer_printf(&buffer, "%*sif a then\n", (int)level * 2, "");
+    }
+    bench_buffer_printf(&buffer, "%*s%zu\n  0\n\n", (int)depth * 2 + 2, "",
+                        i);
+  }
+  *out_len = buffer.len;
+  return buffer.data;
+}
+
+int main(int argc, char **argv) {
+  size_t depth = 0;
+  const char *path = NULL;
+  for (int arg = 1; arg < argc; arg++) {
+    if (strcmp(argv[arg], "-d") == 0 && arg + 1 < argc) {
+      depth = strtoul(argv[++arg], NULL, 10);
+    } else {
+      path = argv[arg];
+    }
+  }
+
+  size_t len;
+  char *source = path    ? bench_read_file(path, &len)
+                 : depth ? generate_nested(depth, 1 << 20, &len)
+                         : bench_generate_source(20000, &len);
+  if (!source || len == 0) {
+    fprintf(stderr, "could not read %s\n", path);
+    return 1;
+  }
+
+  TSLanguage counting = *tree_sitter_koka();
+  scan = counting.external_scanner.scan;
+  deserialize = counting.external_scanner.deserialize;
+  serialize = counting.external_scanner.serialize;
+  counting.external_scanner.scan = counting_scan;
+  counting.external_scanner.deserialize = counting_deserialize;
+  counting.external_scanner.serialize = counting_serialize;
+
+  TSParser *parser = ts_parser_new();
+  ts_parser_set_language(parser, &counting);
+  TSTree *tree = ts_parser_parse_string(parser, NULL, source, (uint32_t)len);
+  bool has_error = ts_node_has_error(ts_tree_root_node(tree));
+  ts_tree_delete(tree);
+
+  // Throughput is measured with the unwrapped language.
+  ts_parser_set_language(parser, tree_sitter_koka());
+  double start = bench_now();
+  for (int i = 0; i < ITERATIONS; i++) {
+    ts_tree_delete(ts_parser_parse_string(parser, NULL, source, (uint32_t)len));
+  }
+  double parse = (bench_now() - start) / ITERATIONS;
+
+  double kb = (double)len / 1024;
+  printf("%zu bytes%s\n", len, has_error ? ", with errors" : "");
+  printf("scans:          %10.1f per KB\n", (double)counts.scans / kb);
+  printf("  tokens found: %10.1f per KB\n", (double)counts.tokens / kb);
+  printf("  signal only:  %10.1f per KB\n", (double)counts.signal_only / kb);
+  printf("  all valid:    %10.1f per KB\n", (double)counts.all_valid / kb);
+  printf("deserializes:   %10.1f per KB\n", (double)counts.deserializes / kb);
+  printf("serializes:     %10.1f per KB, %.1f bytes each, %.1f%% over %d\n",
+         (double)counts.serializes / kb,
+         counts.serializes ? (double)counts.serialized_bytes /
+                                 (double)counts.serializes
+                           : 0.0,
+         counts.serializes ? 100.0 * (double)counts.long_states /
+                                 (double)counts.serializes
+                           : 0.0,
+         INLINE_STATE_SIZE);
+  printf("parse:          %10.3f ms, %.1f MB/s\n", parse * 1e3,
+         (double)len / parse / 1e6);
+
+  ts_parser_delete(parser);
+  free(source);
+  return 0;
+}
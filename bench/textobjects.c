@@ -0,0 +1,113 @@
+// Benchmarks selecting textobjects at random cursor positions in a large
+// file, the way an editor runs queries/textobjects.scm: restricted to the
+// cursor's byte range, picking the smallest capture around the cursor.
+//
+// Usage: bench-textobjects [file.kk]
+//
+// Without a file, a 20k line file is generated.
+
+#include "bench.h"
+#include "tree-sitter-koka.h"
+#include <tree_sitter/api.h>
+
+#define SELECTIONS 2000
+
+static int compare_doubles(const void *a, const void *b) {
+  double da = *(const double *)a, db = *(const double *)b;
+  return da < db ? -1 : da > db ? 1 : 0;
+}
+
+int main(int argc, char **argv) {
+  size_t len;
+  char *source = argc > 1 ? bench_read_file(argv[1], &len)
+                          : bench_generate_source(20000, &len);
+  if (!source || len == 0) {
+    fprintf(stderr, "could not read %s\n", argv[1]);
+    return 1;
+  }
+
+  TSParser *parser = ts_parser_new();
+  ts_parser_set_language(parser, tree_sitter_koka());
+  TSTree *tree = ts_parser_parse_string(parser, NULL, source, (uint32_t)len);
+  TSNode root = ts_tree_root_node(tree);
+
+  const char *query_source = tree_sitter_koka_textobjects_query();
+  uint32_t error_offset;
+  TSQueryError error_type;
+  TSQuery *query =
+      ts_query_new(tree_sitter_koka(), query_source,
+                   (uint32_t)strlen(query_source), &error_offset, &error_type);
+  if (!query) {
+    fprintf(stderr, "textobjects.scm: error %d at byte %u\n", (int)error_type,
+            error_offset);
+    return 1;
+  }
+
+  const char *objects[] = {"function.around", "parameter.inside",
+                           "entry.around", "class.around"};
+  size_t object_count = sizeof(objects) / sizeof(objects[0]);
+  uint32_t *object_ids = malloc(sizeof(uint32_t) * object_count);
+  for (size_t o = 0; o < object_count; o++) {
+    object_ids[o] = UINT32_MAX;
+    for (uint32_t id = 0; id < ts_query_capture_count(query); id++) {
+      uint32_t name_len;
+      const char *name = ts_query_capture_name_for_id(query, id, &name_len);
+      if (name_len == strlen(objects[o]) &&
+          strncmp(name, objects[o], name_len) == 0) {
+        object_ids[o] = id;
+      }
+    }
+  }
+
+  TSQueryCursor *cursor = ts_query_cursor_new();
+  double *times = malloc(sizeof(double) * SELECTIONS);
+  uint32_t found = 0;
+  uint64_t seed = 0x9E3779B97F4A7C15u;
+  for (int i = 0; i < SELECTIONS; i++) {
+    seed = seed * 6364136223846793005u + 1442695040888963407u;
+    uint32_t position = (uint32_t)((seed >> 33) % len);
+    uint32_t object_id = object_ids[(size_t)i % object_count];
+
+    double start = bench_now();
+    ts_query_cursor_set_byte_range(cursor, position, position + 1);
+    ts_query_cursor_exec(cursor, query, root);
+    TSQueryMatch match;
+    uint32_t capture_index;
+    uint32_t best_start = 0, best_end = UINT32_MAX;
+    bool have_best = false;
+    while (ts_query_cursor_next_capture(cursor, &match, &capture_index)) {
+      TSQueryCapture capture = match.captures[capture_index];
+      uint32_t capture_start = ts_node_start_byte(capture.node);
+      uint32_t capture_end = ts_node_end_byte(capture.node);
+      if (capture.index == object_id && capture_start <= position &&
+          position < capture_end &&
+          capture_end - capture_start < best_end - best_start) {
+        best_start = capture_start;
+        best_end = capture_end;
+        have_best = true;
+      }
+    }
+    times[i] = bench_now() - start;
+    found += have_best;
+  }
+
+  qsort(times, SELECTIONS, sizeof(double), compare_doubles);
+  double total = 0;
+  for (int i = 0; i < SELECTIONS; i++) {
+    total += times[i];
+  }
+  printf("%zu bytes, %u lines, %d selections (%u found)\n", len,
+         ts_node_end_point(root).row + 1, SELECTIONS, found);
+  printf("mean %8.1f us, p50 %8.1f us, p99 %8.1f us, max %8.1f us\n",
+         total / SELECTIONS * 1e6, times[SELECTIONS / 2] * 1e6,
+         times[SELECTIONS * 99 / 100] * 1e6, times[SELECTIONS - 1] * 1e6);
+
+  free(times);
+  free(object_ids);
+  ts_query_cursor_delete(cursor);
+  ts_query_delete(query);
+  ts_tree_delete(tree);
+  ts_parser_delete(parser);
+  free(source);
+  return 0;
+}
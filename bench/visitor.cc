@@ -0,0 +1,113 @@
+// Benchmarks counting declarations, matches and handlers in a large file with
+// the typed visitors of tree-sitter-koka.hpp, against a walk that compares
+// node types as strings.
+//
+// Usage: bench-visitor [file.kk]
+//
+// Without a file, a 20k line file is generated.
+
+#include "bench.h"
+#include "tree-sitter-koka.hpp"
+
+#define ITERATIONS 50
+
+namespace koka = tree_sitter::koka;
+
+namespace {
+
+struct Counts {
+  uint32_t functions = 0;
+  uint32_t matches = 0;
+  uint32_t handlers = 0;
+  uint32_t clauses = 0;
+};
+
+struct CountingVisitor {
+  Counts counts;
+
+  void enter(const koka::FunDecl &) { counts.functions++; }
+  void enter(const koka::MatchExpr &) { counts.matches++; }
+  void enter(const koka::HandlerExpr &) { counts.handlers++; }
+  void enter(const koka::OpClause &) { counts.clauses++; }
+};
+
+Counts count_by_name(TSTreeCursor *cursor, TSNode root) {
+  Counts counts;
+  ts_tree_cursor_reset(cursor, root);
+  while (true) {
+    const char *type = ts_node_type(ts_tree_cursor_current_node(cursor));
+    if (strcmp(type, "fundecl") == 0) {
+      counts.functions++;
+    } else if (strcmp(type, "matchexpr") == 0) {
+      counts.matches++;
+    } else if (strcmp(type, "handlerexpr") == 0) {
+      counts.handlers++;
+    } else if (strcmp(type, "opclause") == 0) {
+      counts.clauses++;
+    }
+
+    if (ts_tree_cursor_goto_first_child(cursor)) {
+      continue;
+    }
+    while (!ts_tree_cursor_goto_next_sibling(cursor)) {
+      if (!ts_tree_cursor_goto_parent(cursor)) {
+        return counts;
+      }
+    }
+  }
+}
+
+} // namespace
+
+int main(int argc, char **argv) {
+  size_t len;
+  char *source = argc > 1 ? bench_read_file(argv[1], &len)
+                          : bench_generate_source(20000, &len);
+  if (!source) {
+    fprintf(stderr, "could not read %s\n", argv[1]);
+    return 1;
+  }
+
+  TSParser *parser = ts_parser_new();
+  ts_parser_set_language(parser, koka::language());
+  TSTree *tree = ts_parser_parse_string(parser, NULL, source, (uint32_t)len);
+  TSNode root = ts_tree_root_node(tree);
+
+  TSTreeCursor cursor = ts_tree_cursor_new(root);
+  Counts by_name;
+  double start = bench_now();
+  for (int i = 0; i < ITERATIONS; i++) {
+    by_name = count_by_name(&cursor, root);
+  }
+  double named = (bench_now() - start) / ITERATIONS;
+  ts_tree_cursor_delete(&cursor);
+
+  koka::Walker walker(root);
+  CountingVisitor visitor;
+  start = bench_now();
+  for (int i = 0; i < ITERATIONS; i++) {
+    visitor = CountingVisitor();
+    walker.walk(root, visitor);
+  }
+  double typed = (bench_now() - start) / ITERATIONS;
+
+  const Counts &counts = visitor.counts;
+  if (counts.functions != by_name.functions ||
+      counts.matches != by_name.matches ||
+      counts.handlers != by_name.handlers ||
+      counts.clauses != by_name.clauses) {
+    fprintf(stderr, "visitor and string walk disagree\n");
+    return 1;
+  }
+
+  printf("%zu bytes, %u lines\n", len, ts_node_end_point(root).row + 1);
+  printf("%u functions, %u matches, %u handlers, %u clauses\n",
+         counts.functions, counts.matches, counts.handlers, counts.clauses);
+  printf("string compares: %8.3f ms/walk\n", named * 1e3);
+  printf("typed visitor:   %8.3f ms/walk\n", typed * 1e3);
+
+  ts_tree_delete(tree);
+  ts_parser_delete(parser);
+  free(source);
+  return 0;
+}
@@ -0,0 +1,581 @@
+// Generated by script/generate-symbols.js from src/parser.c. Do not edit.
+
+#ifndef TREE_SITTER_KOKA_SYMBOLS_HPP_
+#define TREE_SITTER_KOKA_SYMBOLS_HPP_
+
+#include <cstdint>
+#include <string_view>
+
+namespace tree_sitter::koka {
+
+// The same types as TSSymbol and TSFieldId.
+using Symbol = std::uint16_t;
+using FieldId = std::uint16_t;
+
+// The number of entries in symbols, which is what ts_language_symbol_count
+// returns.
+inline constexpr Symbol symbol_count = 275;
+inline constexpr FieldId field_count = 2;
+
+// Named node types, as returned by ts_node_symbol. Names that are C++ keywords
+// get a trailing underscore.
+namespace sym {
+inline constexpr Symbol id = 1;
+inline constexpr Symbol borrow = 70;
+inline constexpr Symbol conid = 85;
+inline constexpr Symbol escape = 86;
+inline constexpr Symbol linecomment = 87;
+inline constexpr Symbol qconid = 95;
+inline constexpr Symbol qid = 96;
+inline constexpr Symbol qidop = 97;
+inline constexpr Symbol wildcard = 100;
+inline constexpr Symbol program = 112;
+inline constexpr Symbol importdecl = 115;
+inline constexpr Symbol modulepath = 116;
+inline constexpr Symbol fixitydecl = 118;
+inline constexpr Symbol fixity = 119;
+inline constexpr Symbol oplist = 120;
+inline constexpr Symbol topdecl = 122;
+inline constexpr Symbol externdecl = 123;
+inline constexpr Symbol externtype = 125;
+inline constexpr Symbol externbody = 126;
+inline constexpr Symbol externstat = 127;
+inline constexpr Symbol externimpbody = 128;
+inline constexpr Symbol externimp = 129;
+inline constexpr Symbol externval = 130;
+inline constexpr Symbol externtarget = 131;
+inline constexpr Symbol aliasdecl = 132;
+inline constexpr Symbol typedecl = 133;
+inline constexpr Symbol typemod = 134;
+inline constexpr Symbol structmod = 135;
+inline constexpr Symbol effectmod = 136;
+inline constexpr Symbol typebody = 137;
+inline constexpr Symbol typeid_ = 140;
+inline constexpr Symbol commas = 142;
+inline constexpr Symbol constructors = 143;
+inline constexpr Symbol constructor = 144;
+inline constexpr Symbol conparams = 145;
+inline constexpr Symbol sconparams = 146;
+inline constexpr Symbol opdecls = 147;
+inline constexpr Symbol operations = 148;
+inline constexpr Symbol operation = 149;
+inline constexpr Symbol puredecl = 150;
+inline constexpr Symbol fipalloc = 151;
+inline constexpr Symbol fipmod = 152;
+inline constexpr Symbol fundecl = 153;
+inline constexpr Symbol binder = 154;
+inline constexpr Symbol funid = 155;
+inline constexpr Symbol funbody = 156;
+inline constexpr Symbol annotres = 157;
+inline constexpr Symbol block = 158;
+inline constexpr Symbol statements = 159;
+inline constexpr Symbol statement = 160;
+inline constexpr Symbol decl = 161;
+inline constexpr Symbol bodyexpr = 162;
+inline constexpr Symbol blockexpr = 163;
+inline constexpr Symbol expr = 164;
+inline constexpr Symbol basicexpr = 165;
+inline constexpr Symbol matchexpr = 166;
+inline constexpr Symbol fnexpr = 167;
+inline constexpr Symbol returnexpr = 168;
+inline constexpr Symbol ifexpr = 169;
+inline constexpr Symbol elifs = 170;
+inline constexpr Symbol valexpr = 171;
+inline constexpr Symbol opexpr = 172;
+inline constexpr Symbol prefixexpr = 173;
+inline constexpr Symbol appexpr = 174;
+inline constexpr Symbol atom = 175;
+inline constexpr Symbol literal = 176;
+inline constexpr Symbol mask = 177;
+inline constexpr Symbol arguments = 178;
+inline constexpr Symbol argument = 179;
+inline constexpr Symbol parameters = 180;
+inline constexpr Symbol parameter = 181;
+inline constexpr Symbol paramid = 182;
+inline constexpr Symbol pparameters = 183;
+inline constexpr Symbol pparameter = 184;
+inline constexpr Symbol aexprs = 185;
+inline constexpr Symbol cexprs = 186;
+inline constexpr Symbol aexpr = 187;
+inline constexpr Symbol annot = 188;
+inline constexpr Symbol qoperator = 189;
+inline constexpr Symbol qidentifier = 190;
+inline constexpr Symbol identifier = 191;
+inline constexpr Symbol qvarid = 192;
+inline constexpr Symbol varid = 193;
+inline constexpr Symbol qconstructor = 194;
+inline constexpr Symbol matchrules = 195;
+inline constexpr Symbol matchrule = 196;
+inline constexpr Symbol patterns = 197;
+inline constexpr Symbol apatterns = 198;
+inline constexpr Symbol apattern = 199;
+inline constexpr Symbol pattern = 200;
+inline constexpr Symbol patargs = 201;
+inline constexpr Symbol patarg = 202;
+inline constexpr Symbol handlerexpr = 203;
+inline constexpr Symbol witheff = 204;
+inline constexpr Symbol withstat = 205;
+inline constexpr Symbol withexpr = 206;
+inline constexpr Symbol opclauses = 207;
+inline constexpr Symbol opclausex = 208;
+inline constexpr Symbol opclause = 209;
+inline constexpr Symbol controlmod = 210;
+inline constexpr Symbol opparams = 211;
+inline constexpr Symbol opparam = 212;
+inline constexpr Symbol tbinders = 213;
+inline constexpr Symbol tbinder = 214;
+inline constexpr Symbol typescheme = 215;
+inline constexpr Symbol type = 216;
+inline constexpr Symbol someforalls = 217;
+inline constexpr Symbol typeparams = 218;
+inline constexpr Symbol qualifier = 219;
+inline constexpr Symbol predicates = 220;
+inline constexpr Symbol predicate = 221;
+inline constexpr Symbol tarrow = 222;
+inline constexpr Symbol tresult = 223;
+inline constexpr Symbol tatomic = 224;
+inline constexpr Symbol tbasic = 225;
+inline constexpr Symbol typeapp = 226;
+inline constexpr Symbol typecon = 227;
+inline constexpr Symbol tparams = 228;
+inline constexpr Symbol tparam = 229;
+inline constexpr Symbol targuments = 230;
+inline constexpr Symbol anntype = 231;
+inline constexpr Symbol kannot = 232;
+inline constexpr Symbol kind = 233;
+inline constexpr Symbol kinds = 234;
+inline constexpr Symbol katom = 235;
+inline constexpr Symbol blockcomment = 236;
+inline constexpr Symbol float_ = 237;
+inline constexpr Symbol int_ = 238;
+inline constexpr Symbol idop = 239;
+inline constexpr Symbol op = 240;
+inline constexpr Symbol string = 241;
+inline constexpr Symbol char_ = 242;
+inline constexpr Symbol modulebody = 273;
+inline constexpr Symbol moduledecl = 274;
+} // namespace sym
+
+// Anonymous node types, named as in src/parser.c.
+namespace anon {
+inline constexpr Symbol module_ = 2; // "module"
+inline constexpr Symbol pub = 3; // "pub"
+inline constexpr Symbol public_ = 4; // "public"
+inline constexpr Symbol import_ = 5; // "import"
+inline constexpr Symbol EQ = 6; // "="
+inline constexpr Symbol infix = 7; // "infix"
+inline constexpr Symbol infixl = 8; // "infixl"
+inline constexpr Symbol infixr = 9; // "infixr"
+inline constexpr Symbol abstract = 10; // "abstract"
+inline constexpr Symbol inline_ = 11; // "inline"
+inline constexpr Symbol noinline = 12; // "noinline"
+inline constexpr Symbol extern_ = 13; // "extern"
+inline constexpr Symbol include = 14; // "include"
+inline constexpr Symbol LPAREN = 15; // "("
+inline constexpr Symbol COLON = 16; // ":"
+inline constexpr Symbol RPAREN = 17; // ")"
+inline constexpr Symbol cs = 18; // "cs"
+inline constexpr Symbol js = 19; // "js"
+inline constexpr Symbol c = 20; // "c"
+inline constexpr Symbol alias = 21; // "alias"
+inline constexpr Symbol type = 22; // "type"
+inline constexpr Symbol struct_ = 23; // "struct"
+inline constexpr Symbol named = 24; // "named"
+inline constexpr Symbol scoped = 25; // "scoped"
+inline constexpr Symbol effect = 26; // "effect"
+inline constexpr Symbol in = 27; // "in"
+inline constexpr Symbol open = 28; // "open"
+inline constexpr Symbol extend = 29; // "extend"
+inline constexpr Symbol co = 30; // "co"
+inline constexpr Symbol rec = 31; // "rec"
+inline constexpr Symbol value = 32; // "value"
+inline constexpr Symbol ref = 33; // "ref"
+inline constexpr Symbol reference = 34; // "reference"
+inline constexpr Symbol linear = 35; // "linear"
+inline constexpr Symbol LBRACK = 36; // "["
+inline constexpr Symbol LT = 37; // "<"
+inline constexpr Symbol RBRACK = 38; // "]"
+inline constexpr Symbol GT = 39; // ">"
+inline constexpr Symbol PIPE = 40; // "|"
+inline constexpr Symbol COMMA = 41; // ","
+inline constexpr Symbol con = 42; // "con"
+inline constexpr Symbol val = 43; // "val"
+inline constexpr Symbol fun = 44; // "fun"
+inline constexpr Symbol control = 45; // "control"
+inline constexpr Symbol rcontrol = 46; // "rcontrol"
+inline constexpr Symbol rawctl = 47; // "rawctl"
+inline constexpr Symbol ctl = 48; // "ctl"
+inline constexpr Symbol n = 49; // "n"
+inline constexpr Symbol fbip = 50; // "fbip"
+inline constexpr Symbol fip = 51; // "fip"
+inline constexpr Symbol tail = 52; // "tail"
+inline constexpr Symbol var = 53; // "var"
+inline constexpr Symbol COLON_EQ = 54; // ":="
+inline constexpr Symbol DASH_GT = 55; // "->"
+inline constexpr Symbol match = 56; // "match"
+inline constexpr Symbol fn = 57; // "fn"
+inline constexpr Symbol return_ = 58; // "return"
+inline constexpr Symbol if_ = 59; // "if"
+inline constexpr Symbol then = 60; // "then"
+inline constexpr Symbol elif = 61; // "elif"
+inline constexpr Symbol else_ = 62; // "else"
+inline constexpr Symbol BANG = 63; // "!"
+inline constexpr Symbol TILDE = 64; // "~"
+inline constexpr Symbol DOT = 65; // "."
+inline constexpr Symbol mask = 66; // "mask"
+inline constexpr Symbol inject = 67; // "inject"
+inline constexpr Symbol behind = 68; // "behind"
+inline constexpr Symbol other = 69; // "other"
+inline constexpr Symbol as = 71; // "as"
+inline constexpr Symbol override_ = 72; // "override"
+inline constexpr Symbol handler = 73; // "handler"
+inline constexpr Symbol handle = 74; // "handle"
+inline constexpr Symbol with = 75; // "with"
+inline constexpr Symbol LT_DASH = 76; // "<-"
+inline constexpr Symbol finally = 77; // "finally"
+inline constexpr Symbol initially = 78; // "initially"
+inline constexpr Symbol final_ = 79; // "final"
+inline constexpr Symbol raw = 80; // "raw"
+inline constexpr Symbol forall = 81; // "forall"
+inline constexpr Symbol some = 82; // "some"
+inline constexpr Symbol COLON_COLON = 83; // "::"
+inline constexpr Symbol SLASH_STAR = 88; // "/*"
+inline constexpr Symbol STAR_SLASH = 90; // "*/"
+inline constexpr Symbol DQUOTE = 101; // "\""
+inline constexpr Symbol SQUOTE = 104; // "'"
+inline constexpr Symbol LBRACE = 107; // "{"
+inline constexpr Symbol RBRACE = 108; // "}"
+inline constexpr Symbol SEMI = 109; // ";"
+} // namespace anon
+
+namespace field {
+inline constexpr FieldId field = 1;
+inline constexpr FieldId function = 2;
+} // namespace field
+
+struct SymbolInfo {
+  std::string_view name;
+  bool visible;
+  bool named;
+};
+
+// Indexed by symbol, like ts_language_symbol_name and ts_language_symbol_type.
+inline constexpr SymbolInfo symbols[symbol_count] = {
+    {"end", false, true},
+    {"id", true, true},
+    {"module", true, false},
+    {"pub", true, false},
+    {"public", true, false},
+    {"import", true, false},
+    {"=", true, false},
+    {"infix", true, false},
+    {"infixl", true, false},
+    {"infixr", true, false},
+    {"abstract", true, false},
+    {"inline", true, false},
+    {"noinline", true, false},
+    {"extern", true, false},
+    {"include", true, false},
+    {"(", true, false},
+    {":", true, false},
+    {")", true, false},
+    {"cs", true, false},
+    {"js", true, false},
+    {"c", true, false},
+    {"alias", true, false},
+    {"type", true, false},
+    {"struct", true, false},
+    {"named", true, false},
+    {"scoped", true, false},
+    {"effect", true, false},
+    {"in", true, false},
+    {"open", true, false},
+    {"extend", true, false},
+    {"co", true, false},
+    {"rec", true, false},
+    {"value", true, false},
+    {"ref", true, false},
+    {"reference", true, false},
+    {"linear", true, false},
+    {"[", true, false},
+    {"<", true, false},
+    {"]", true, false},
+    {">", true, false},
+    {"|", true, false},
+    {",", true, false},
+    {"con", true, false},
+    {"val", true, false},
+    {"fun", true, false},
+    {"control", true, false},
+    {"rcontrol", true, false},
+    {"rawctl", true, false},
+    {"ctl", true, false},
+    {"n", true, false},
+    {"fbip", true, false},
+    {"fip", true, false},
+    {"tail", true, false},
+    {"var", true, false},
+    {":=", true, false},
+    {"->", true, false},
+    {"match", true, false},
+    {"fn", true, false},
+    {"return", true, false},
+    {"if", true, false},
+    {"then", true, false},
+    {"elif", true, false},
+    {"else", true, false},
+    {"!", true, false},
+    {"~", true, false},
+    {".", true, false},
+    {"mask", true, false},
+    {"inject", true, false},
+    {"behind", true, false},
+    {"other", true, false},
+    {"borrow", true, true},
+    {"as", true, false},
+    {"override", true, false},
+    {"handler", true, false},
+    {"handle", true, false},
+    {"with", true, false},
+    {"<-", true, false},
+    {"finally", true, false},
+    {"initially", true, false},
+    {"final", true, false},
+    {"raw", true, false},
+    {"forall", true, false},
+    {"some", true, false},
+    {"::", true, false},
+    {"_symbols", false, true},
+    {"conid", true, true},
+    {"escape", true, true},
+    {"linecomment", true, true},
+    {"/*", true, false},
+    {"blockcomment_token1", false, false},
+    {"*/", true, false},
+    {"float_token1", false, false},
+    {"float_token2", false, false},
+    {"int_token1", false, false},
+    {"int_token2", false, false},
+    {"qconid", true, true},
+    {"qid", true, true},
+    {"qidop", true, true},
+    {"idop_token1", false, false},
+    {")", true, false},
+    {"wildcard", true, true},
+    {"\"", true, false},
+    {"string_token1", false, false},
+    {"\"", true, false},
+    {"'", true, false},
+    {"char_token1", false, false},
+    {"'", true, false},
+    {"{", true, false},
+    {"}", true, false},
+    {";", true, false},
+    {"_raw_string", false, true},
+    {"_end_continuation_signal", false, true},
+    {"program", true, true},
+    {"_open_brace_", false, true},
+    {"_close_brace_", false, true},
+    {"importdecl", true, true},
+    {"modulepath", true, true},
+    {"_semis", false, false},
+    {"fixitydecl", true, true},
+    {"fixity", true, true},
+    {"oplist", true, true},
+    {"_topdecls", false, false},
+    {"topdecl", true, true},
+    {"externdecl", true, true},
+    {"_open_round_brace", false, true},
+    {"externtype", true, true},
+    {"externbody", true, true},
+    {"externstat", true, true},
+    {"externimpbody", true, true},
+    {"externimp", true, true},
+    {"externval", true, true},
+    {"externtarget", true, true},
+    {"aliasdecl", true, true},
+    {"typedecl", true, true},
+    {"typemod", true, true},
+    {"structmod", true, true},
+    {"effectmod", true, true},
+    {"typebody", true, true},
+    {"_open_square_brace", false, true},
+    {"_open_angle_brace", false, true},
+    {"typeid", true, true},
+    {"_comma", false, true},
+    {"commas", true, true},
+    {"constructors", true, true},
+    {"constructor", true, true},
+    {"conparams", true, true},
+    {"sconparams", true, true},
+    {"opdecls", true, true},
+    {"operations", true, true},
+    {"operation", true, true},
+    {"puredecl", true, true},
+    {"fipalloc", true, true},
+    {"fipmod", true, true},
+    {"fundecl", true, true},
+    {"binder", true, true},
+    {"funid", true, true},
+    {"funbody", true, true},
+    {"annotres", true, true},
+    {"block", true, true},
+    {"statements", true, true},
+    {"statement", true, true},
+    {"decl", true, true},
+    {"bodyexpr", true, true},
+    {"blockexpr", true, true},
+    {"expr", true, true},
+    {"basicexpr", true, true},
+    {"matchexpr", true, true},
+    {"fnexpr", true, true},
+    {"returnexpr", true, true},
+    {"ifexpr", true, true},
+    {"elifs", true, true},
+    {"valexpr", true, true},
+    {"opexpr", true, true},
+    {"prefixexpr", true, true},
+    {"appexpr", true, true},
+    {"atom", true, true},
+    {"literal", true, true},
+    {"mask", true, true},
+    {"arguments", true, true},
+    {"argument", true, true},
+    {"parameters", true, true},
+    {"parameter", true, true},
+    {"paramid", true, true},
+    {"pparameters", true, true},
+    {"pparameter", true, true},
+    {"aexprs", true, true},
+    {"cexprs", true, true},
+    {"aexpr", true, true},
+    {"annot", true, true},
+    {"qoperator", true, true},
+    {"qidentifier", true, true},
+    {"identifier", true, true},
+    {"qvarid", true, true},
+    {"varid", true, true},
+    {"qconstructor", true, true},
+    {"matchrules", true, true},
+    {"matchrule", true, true},
+    {"patterns", true, true},
+    {"apatterns", true, true},
+    {"apattern", true, true},
+    {"pattern", true, true},
+    {"patargs", true, true},
+    {"patarg", true, true},
+    {"handlerexpr", true, true},
+    {"witheff", true, true},
+    {"withstat", true, true},
+    {"withexpr", true, true},
+    {"opclauses", true, true},
+    {"opclausex", true, true},
+    {"opclause", true, true},
+    {"controlmod", true, true},
+    {"opparams", true, true},
+    {"opparam", true, true},
+    {"tbinders", true, true},
+    {"tbinder", true, true},
+    {"typescheme", true, true},
+    {"type", true, true},
+    {"someforalls", true, true},
+    {"typeparams", true, true},
+    {"qualifier", true, true},
+    {"predicates", true, true},
+    {"predicate", true, true},
+    {"tarrow", true, true},
+    {"tresult", true, true},
+    {"tatomic", true, true},
+    {"tbasic", true, true},
+    {"typeapp", true, true},
+    {"typecon", true, true},
+    {"tparams", true, true},
+    {"tparam", true, true},
+    {"targuments", true, true},
+    {"anntype", true, true},
+    {"kannot", true, true},
+    {"kind", true, true},
+    {"kinds", true, true},
+    {"katom", true, true},
+    {"blockcomment", true, true},
+    {"float", true, true},
+    {"int", true, true},
+    {"idop", true, true},
+    {"op", true, true},
+    {"string", true, true},
+    {"char", true, true},
+    {"program_repeat1", false, false},
+    {"program_repeat2", false, false},
+    {"oplist_repeat1", false, false},
+    {"externbody_repeat1", false, false},
+    {"externimpbody_repeat1", false, false},
+    {"externimp_repeat1", false, false},
+    {"commas_repeat1", false, false},
+    {"constructors_repeat1", false, false},
+    {"sconparams_repeat1", false, false},
+    {"operations_repeat1", false, false},
+    {"statements_repeat1", false, false},
+    {"elifs_repeat1", false, false},
+    {"opexpr_repeat1", false, false},
+    {"arguments_repeat1", false, false},
+    {"parameters_repeat1", false, false},
+    {"pparameters_repeat1", false, false},
+    {"aexprs_repeat1", false, false},
+    {"matchrules_repeat1", false, false},
+    {"patterns_repeat1", false, false},
+    {"apatterns_repeat1", false, false},
+    {"patargs_repeat1", false, false},
+    {"opclauses_repeat1", false, false},
+    {"opparams_repeat1", false, false},
+    {"tbinders_repeat1", false, false},
+    {"predicates_repeat1", false, false},
+    {"tparams_repeat1", false, false},
+    {"targuments_repeat1", false, false},
+    {"kinds_repeat1", false, false},
+    {"blockcomment_repeat1", false, false},
+    {"string_repeat1", false, false},
+    {"modulebody", true, true},
+    {"moduledecl", true, true},
+};
+
+// Indexed by field ID; 0 isn't a field.
+inline constexpr std::string_view field_names[field_count + 1] = {
+    "",
+    "field",
+    "function",
+};
+
+constexpr std::string_view symbol_name(Symbol symbol) {
+  return symbol < symbol_count ? symbols[symbol].name : std::string_view();
+}
+
+constexpr std::string_view field_name(FieldId field) {
+  return field <= field_count ? field_names[field] : std::string_view();
+}
+
+// Equivalent to ts_language_symbol_for_name, but usable in constant
+// expressions. Returns 0 if there's no such visible symbol.
+constexpr Symbol symbol_for_name(std::string_view name, bool named) {
+  for (Symbol symbol = 1; symbol < symbol_count; symbol++) {
+    const SymbolInfo &info = symbols[symbol];
+    if (info.visible && info.named == named && info.name == name) {
+      return symbol;
+    }
+  }
+  return 0;
+}
+
+// Equivalent to ts_language_field_id_for_name. Returns 0 if there's no such
+// field.
+constexpr FieldId field_for_name(std::string_view name) {
+  for (FieldId field = 1; field <= field_count; field++) {
+    if (field_names[field] == name) {
+      return field;
+    }
+  }
+  return 0;
+}
+
+} // namespace tree_sitter::koka
+
+#endif // TREE_SITTER_KOKA_SYMBOLS_HPP_
@@ -0,0 +1,337 @@
+#ifndef TREE_SITTER_KOKA_UTILS_H_
+#define TREE_SITTER_KOKA_UTILS_H_
+
+// Editor and analysis helpers for Koka trees. Unlike tree-sitter-koka.h,
+// these need the tree-sitter runtime library.
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <tree_sitter/api.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Folding
+
+typedef enum {
+  TSKokaFoldRegion,
+  TSKokaFoldComment,
+} TSKokaFoldKind;
+
+typedef struct {
+  uint32_t start_byte;
+  uint32_t end_byte;
+  // The first and last lines that are folded away, zero-based. The last line
+  // excludes the line holding the first token after a layout block, which the
+  // block's virtual closing brace is attached to.
+  uint32_t start_line;
+  uint32_t end_line;
+  TSSymbol symbol;
+  TSKokaFoldKind kind;
+} TSKokaFoldingRange;
+
+// Computes the folding ranges of the nodes captured by queries/folds.scm in a
+// single pass over the tree, skipping every subtree that fits on one line.
+// Ranges are written to ranges in document order, up to capacity of them, and
+// the total number found is returned, so a caller can retry with a larger
+// buffer if that's more than capacity. A range is only reported if it spans
+// more than one line and starts on a different line than the previously
+// reported range.
+uint32_t tree_sitter_koka_folding_ranges(TSNode root, const char *source,
+                                         uint32_t source_len,
+                                         TSKokaFoldingRange *ranges,
+                                         uint32_t capacity);
+
+// Indentation
+
+// Computes the indentation, in columns, that the line containing byte should
+// have, following the rules of queries/indents.scm as Helix interprets them,
+// with one level per indent_width columns. A blank line is indented as if it
+// had just been opened by pressing enter at the end of the previous non-blank
+// line. Following the layout rules of the scanner, a line that starts with an
+// operator or then/elif/else continuing an expression from an earlier line is
+// indented one level further.
+uint32_t tree_sitter_koka_indent_for_line(const TSTree *tree,
+                                          const char *source,
+                                          uint32_t source_len, uint32_t byte,
+                                          uint32_t indent_width);
+
+// Injections
+
+typedef struct {
+  // The contents of the string, without its quotes.
+  TSRange range;
+  // The language of the externtarget that queries/injections.scm captures as
+  // injection.language: "c", "javascript" or "c-sharp".
+  const char *language;
+} TSKokaInjection;
+
+// Finds the foreign code that queries/injections.scm injects, i.e. the
+// strings of extern declarations for the c, js and cs targets, without
+// visiting anything but the top level of the module and the extern
+// declarations themselves. Injections are written to injections in document
+// order, up to capacity of them, and the total number found is returned. The
+// ranges for one language can be passed to ts_parser_set_included_ranges to
+// parse just those slices.
+uint32_t tree_sitter_koka_injections(TSNode root, const char *source,
+                                     uint32_t source_len,
+                                     TSKokaInjection *injections,
+                                     uint32_t capacity);
+
+// Module headers
+
+// The length of the header of a module: its module declaration, imports and
+// fixity declarations, with the comments and blank lines around them. Only as
+// much of source is read as it takes to find the first line that starts at
+// column zero with anything else, which in layout-based Koka is the first
+// top-level declaration.
+uint32_t tree_sitter_koka_header_length(const char *source,
+                                        uint32_t source_len);
+
+// Parses only the header of source, using parser, which must have the Koka
+// language set. Nothing after the header is lexed, so the cost depends on the
+// size of the header rather than of the file. The tree has the same
+// importdecl and fixitydecl nodes, at the same offsets, as a tree of the whole
+// file, and none of its topdecl nodes.
+TSTree *tree_sitter_koka_parse_header(TSParser *parser, const char *source,
+                                      uint32_t source_len);
+
+// Operator fixity
+
+typedef enum {
+  TSKokaAssociativityNone,
+  TSKokaAssociativityLeft,
+  TSKokaAssociativityRight,
+} TSKokaAssociativity;
+
+typedef struct {
+  // Higher binds tighter.
+  int32_t precedence;
+  TSKokaAssociativity associativity;
+} TSKokaFixity;
+
+// Maps operator names, such as "+" or "cdiv", to their fixity.
+typedef struct TSKokaFixityTable TSKokaFixityTable;
+
+// Creates a table holding the fixities that std/core declares. The table must
+// be deleted with tree_sitter_koka_fixity_table_delete.
+TSKokaFixityTable *
+tree_sitter_koka_fixity_table_new(const TSLanguage *language);
+
+void tree_sitter_koka_fixity_table_delete(TSKokaFixityTable *table);
+
+// Adds the fixities declared by the fixitydecl nodes of the module whose tree
+// has root as its root, replacing earlier ones for the same operators.
+void tree_sitter_koka_fixity_table_add_module(TSKokaFixityTable *table,
+                                              TSNode root, const char *source,
+                                              uint32_t source_len);
+
+void tree_sitter_koka_fixity_table_set(TSKokaFixityTable *table,
+                                       const char *name, uint32_t name_len,
+                                       TSKokaFixity fixity);
+
+// Returns the fixity of an operator, or left associativity at precedence 50
+// if none was declared.
+TSKokaFixity tree_sitter_koka_fixity_table_get(const TSKokaFixityTable *table,
+                                               const char *name,
+                                               uint32_t name_len);
+
+// The index that stands for no node in a TSKokaOperatorNode.
+#define TS_KOKA_OPERATOR_NONE UINT32_MAX
+
+typedef struct {
+  // An operand, which is a child of the opexpr other than an operator, or the
+  // op node of the operator that combines left and right.
+  TSNode node;
+  // The indices of the operands of an operator, or TS_KOKA_OPERATOR_NONE for
+  // an operand.
+  uint32_t left;
+  uint32_t right;
+  // Whether the operator is next to one of the same precedence but a
+  // different or no associativity, which doesn't parse in Koka. Such
+  // operators are grouped to the left.
+  bool ambiguous;
+} TSKokaOperatorNode;
+
+// Rebuilds the flat list of operands and operators of an opexpr node as a
+// binary tree that follows the fixities in table. The tree is written to
+// nodes in post-order, so operands come before the operators that combine
+// them and the root is the last node. Returns the number of nodes, which is
+// twice the number of operands minus one, having written nothing if that's
+// more than capacity. Operands that contain opexpr nodes, such as
+// parenthesized expressions, must be reassociated separately.
+uint32_t tree_sitter_koka_reassociate(const TSKokaFixityTable *table,
+                                      TSNode opexpr, const char *source,
+                                      TSKokaOperatorNode *nodes,
+                                      uint32_t capacity);
+
+// Incremental highlighting
+
+typedef struct {
+  uint32_t start_byte;
+  uint32_t end_byte;
+  // The index of the highlight query's capture, for
+  // ts_query_capture_name_for_id.
+  uint32_t capture;
+} TSKokaHighlightSpan;
+
+typedef struct {
+  // Sorted, disjoint ranges of the new tree whose spans must be discarded,
+  // clipping any span that crosses their boundaries.
+  TSRange *invalidated;
+  uint32_t invalidated_count;
+  // The spans to add in place of the discarded ones, clipped to the
+  // invalidated ranges, in document order. Nested spans follow the span they
+  // are nested in.
+  TSKokaHighlightSpan *spans;
+  uint32_t span_count;
+} TSKokaHighlightDelta;
+
+// Recomputes highlight spans for new_tree only inside the ranges that
+// ts_tree_get_changed_ranges reports against old_tree, which must be the
+// edited tree new_tree was parsed from. extra_ranges are invalidated too, and
+// should hold the new text of the edits, since an edit inside a token doesn't
+// always change the tree's structure. Spans held by the caller must be shifted
+// by the edits before the delta is applied to them. The delta must be freed
+// with tree_sitter_koka_highlight_delta_delete.
+void tree_sitter_koka_highlight_delta(const TSTree *old_tree,
+                                      const TSTree *new_tree,
+                                      const TSQuery *query,
+                                      TSQueryCursor *cursor,
+                                      const TSRange *extra_ranges,
+                                      uint32_t extra_range_count,
+                                      TSKokaHighlightDelta *delta);
+
+void tree_sitter_koka_highlight_delta_delete(TSKokaHighlightDelta *delta);
+
+// Flattened trees
+
+// The index that stands for no node in a TSKokaFlatTree.
+#define TS_KOKA_FLAT_NONE UINT32_MAX
+
+// Bits of TSKokaFlatTree.flags.
+enum {
+  TSKokaFlatNamed = 1 << 0,
+  // An ERROR node.
+  TSKokaFlatError = 1 << 1,
+  // A MISSING node inserted by error recovery.
+  TSKokaFlatMissing = 1 << 2,
+  // The node is or contains an ERROR or MISSING node.
+  TSKokaFlatHasError = 1 << 3,
+};
+
+// A tree as parallel arrays indexed by node, in document order, so node 0 is
+// the root and the descendants of a node immediately follow it. All nodes are
+// included, anonymous or not.
+typedef struct {
+  uint32_t node_count;
+  uint32_t *start_bytes;
+  uint32_t *end_bytes;
+  // TS_KOKA_FLAT_NONE for the root.
+  uint32_t *parents;
+  // TS_KOKA_FLAT_NONE for leaves.
+  uint32_t *first_children;
+  // TS_KOKA_FLAT_NONE for last children.
+  uint32_t *next_siblings;
+  TSSymbol *symbols;
+  // The field that each node is in its parent, or 0.
+  TSFieldId *fields;
+  uint8_t *flags;
+} TSKokaFlatTree;
+
+// The number of bytes of arena that tree_sitter_koka_flatten needs for the
+// subtree rooted at root.
+size_t tree_sitter_koka_flat_tree_size(TSNode root);
+
+// Flattens the subtree rooted at root in a single pass of a TSTreeCursor,
+// placing the arrays of tree in arena, which must be aligned for uint32_t.
+// Returns false, leaving tree untouched, if arena_size is less than
+// tree_sitter_koka_flat_tree_size(root). Nothing is allocated besides the
+// cursor, and the arrays stay valid for as long as the arena does, regardless
+// of what happens to the TSTree.
+bool tree_sitter_koka_flatten(TSNode root, void *arena, size_t arena_size,
+                              TSKokaFlatTree *tree);
+
+// The version of the format written by tree_sitter_koka_flat_tree_serialize.
+#define TS_KOKA_FLAT_FORMAT_VERSION 1
+
+// Writes tree to buffer in a binary format that tree_sitter_koka_flat_tree_load
+// can use in place, such as from a file mapped by another process. Returns the
+// size of the serialized tree, having written nothing if that's more than
+// capacity.
+//
+// The format is a 36 byte header of the eight byte magic "TSKOKAFT" followed
+// by seven uint32_t: the format version, 0x01020304 in the writer's byte
+// order, the node count, the symbol count, field count and ABI version of
+// language, and zero. The arrays of the tree follow in the order they're
+// declared in TSKokaFlatTree, each node_count elements long, with no padding
+// in between. Every array stays aligned for its element type as long as the
+// buffer is aligned for uint32_t.
+size_t tree_sitter_koka_flat_tree_serialize(const TSKokaFlatTree *tree,
+                                            const TSLanguage *language,
+                                            void *buffer, size_t capacity);
+
+// Points the arrays of tree into data, which holds a tree serialized by
+// tree_sitter_koka_flat_tree_serialize and must be aligned for uint32_t.
+// Nothing is copied, so the arrays are only valid for as long as data is, and
+// mustn't be written to if data is read-only.
+// Returns false if data is too short, holds a different version of the format
+// or was written on a machine with a different byte order or for a different
+// build of the grammar than language.
+bool tree_sitter_koka_flat_tree_load(const void *data, size_t size,
+                                     const TSLanguage *language,
+                                     TSKokaFlatTree *tree);
+
+// Formatting
+
+typedef struct {
+  // The range of the source to replace.
+  uint32_t start_byte;
+  uint32_t end_byte;
+  // Where the replacement is in TSKokaFormatResult.text.
+  uint32_t text_start;
+  uint32_t text_length;
+} TSKokaFormatEdit;
+
+typedef struct {
+  // Sorted, disjoint edits, one for every declaration that changed.
+  TSKokaFormatEdit *edits;
+  uint32_t edit_count;
+  char *text;
+} TSKokaFormatResult;
+
+// Formats the imports, fixity declarations and top-level declarations of the
+// module that tree was parsed from, or only the ones that overlap ranges
+// unless range_count is 0. An empty range selects the declaration it's in.
+//
+// Only whitespace is changed, and line breaks are kept where they are:
+// - Every layout block, such as a function body, match rules, handler
+//   clauses, constructors or effect operations, is indented indent_width
+//   columns past the line that opened it, and its continuation lines keep
+//   their offset from the block's first item. An explicit closing brace
+//   lines up with the line its block was opened on.
+// - Binary operators, =, ->, := and <- are surrounded by a single space, and
+//   commas are followed by one. There's no space after an opening parenthesis
+//   or bracket, or before a closing one, a comma or a semicolon. Other runs
+//   of spaces become one.
+// - Trailing whitespace is removed, and runs of blank lines become one.
+// Strings, characters and comments are left untouched, and so are
+// declarations with syntax errors. Each formatted declaration is parsed again
+// on its own, and is left untouched unless it has the same tree as before,
+// so formatting never changes how the scanner lays out a program.
+//
+// The result must be freed with tree_sitter_koka_format_result_delete.
+void tree_sitter_koka_format(const TSTree *tree, const char *source,
+                             uint32_t source_len, uint32_t indent_width,
+                             const TSRange *ranges, uint32_t range_count,
+                             TSKokaFormatResult *result);
+
+void tree_sitter_koka_format_result_delete(TSKokaFormatResult *result);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // TREE_SITTER_KOKA_UTILS_H_
@@ -9,6 +9,17 @@ extern "C" {
 
 const TSLanguage *tree_sitter_koka(void);
 
+// The sources of the bundled queries/*.scm files and src/node-types.json,
+// embedded in the library as NUL-terminated strings with static storage
+// duration.
+const char *tree_sitter_koka_folds_query(void);
+const char *tree_sitter_koka_highlights_query(void);
+const char *tree_sitter_koka_indents_query(void);
+const char *tree_sitter_koka_injections_query(void);
+const char *tree_sitter_koka_locals_query(void);
+const char *tree_sitter_koka_textobjects_query(void);
+const char *tree_sitter_koka_node_types(void);
+
 #ifdef __cplusplus
 }
 #endif
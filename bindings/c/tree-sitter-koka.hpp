@@ -0,0 +1,2990 @@
+// Generated by script/generate-nodes.js from src/node-types.json. Do not
+// edit.
+
+#ifndef TREE_SITTER_KOKA_HPP_
+#define TREE_SITTER_KOKA_HPP_
+
+#include <cstdint>
+#include <optional>
+#include <string_view>
+#include <type_traits>
+#include <utility>
+
+#include <tree_sitter/api.h>
+
+#include "tree-sitter-koka-symbols.hpp"
+#include "tree-sitter-koka.h"
+
+namespace tree_sitter::koka {
+
+inline const TSLanguage *language() { return tree_sitter_koka(); }
+
+// A node of any type. Copying one is as cheap as copying a TSNode.
+class Node {
+public:
+  Node() : node_() {}
+  explicit Node(TSNode node) : node_(node) {}
+
+  TSNode raw() const { return node_; }
+  bool is_null() const { return ts_node_is_null(node_); }
+  bool is_named() const { return ts_node_is_named(node_); }
+  bool has_error() const { return ts_node_has_error(node_); }
+  Symbol symbol() const { return ts_node_symbol(node_); }
+  std::string_view type_name() const { return symbol_name(symbol()); }
+
+  uint32_t start_byte() const { return ts_node_start_byte(node_); }
+  uint32_t end_byte() const { return ts_node_end_byte(node_); }
+  TSPoint start_point() const { return ts_node_start_point(node_); }
+  TSPoint end_point() const { return ts_node_end_point(node_); }
+
+  // The part of the source the tree was parsed from that this node covers.
+  std::string_view text(std::string_view source) const {
+    return source.substr(start_byte(), end_byte() - start_byte());
+  }
+
+  Node parent() const { return Node(ts_node_parent(node_)); }
+
+  template <typename T> bool is() const {
+    return !is_null() && symbol() == T::type_symbol;
+  }
+
+  template <typename T> std::optional<T> as() const {
+    return is<T>() ? std::optional<T>(T(node_)) : std::nullopt;
+  }
+
+  // The first named child of type T.
+  template <typename T> std::optional<T> child() const {
+    for (TSNode child = ts_node_named_child(node_, 0); !ts_node_is_null(child);
+         child = ts_node_next_named_sibling(child)) {
+      if (ts_node_symbol(child) == T::type_symbol) {
+        return T(child);
+      }
+    }
+    return std::nullopt;
+  }
+
+  // Calls f with every named child of type T, in order.
+  template <typename T, typename F> void for_each(F &&f) const {
+    for (TSNode child = ts_node_named_child(node_, 0); !ts_node_is_null(child);
+         child = ts_node_next_named_sibling(child)) {
+      if (ts_node_symbol(child) == T::type_symbol) {
+        f(T(child));
+      }
+    }
+  }
+
+  template <typename T> std::optional<T> child_by_field(FieldId field) const {
+    TSNode child = ts_node_child_by_field_id(node_, field);
+    if (ts_node_is_null(child)) {
+      return std::nullopt;
+    }
+    if constexpr (std::is_same_v<T, Node>) {
+      return Node(child);
+    } else {
+      return Node(child).as<T>();
+    }
+  }
+
+protected:
+  TSNode node_;
+};
+
+class AExpr;
+class AExprs;
+class AliasDecl;
+class Annot;
+class AnnotRes;
+class AnnType;
+class APattern;
+class APatterns;
+class AppExpr;
+class Argument;
+class Arguments;
+class Atom;
+class BasicExpr;
+class Binder;
+class Block;
+class BlockComment;
+class BlockExpr;
+class BodyExpr;
+class CExprs;
+class Char;
+class Commas;
+class ConParams;
+class Constructor;
+class Constructors;
+class ControlMod;
+class Decl;
+class EffectMod;
+class Elifs;
+class Expr;
+class ExternBody;
+class ExternDecl;
+class ExternImp;
+class ExternImpBody;
+class ExternStat;
+class ExternTarget;
+class ExternType;
+class ExternVal;
+class FipAlloc;
+class FipMod;
+class Fixity;
+class FixityDecl;
+class Float;
+class FnExpr;
+class FunBody;
+class FunDecl;
+class FunId;
+class HandlerExpr;
+class Identifier;
+class IdOp;
+class IfExpr;
+class ImportDecl;
+class Int;
+class KAnnot;
+class KAtom;
+class Kind;
+class Kinds;
+class Literal;
+class Mask;
+class MatchExpr;
+class MatchRule;
+class MatchRules;
+class ModuleBody;
+class ModuleDecl;
+class ModulePath;
+class Op;
+class OpClause;
+class OpClauses;
+class OpClauseX;
+class OpDecls;
+class Operation;
+class Operations;
+class OpExpr;
+class OpList;
+class OpParam;
+class OpParams;
+class Parameter;
+class Parameters;
+class ParamId;
+class PatArg;
+class PatArgs;
+class Pattern;
+class Patterns;
+class PParameter;
+class PParameters;
+class Predicate;
+class Predicates;
+class PrefixExpr;
+class Program;
+class PureDecl;
+class QConstructor;
+class QIdentifier;
+class QOperator;
+class Qualifier;
+class QVarId;
+class ReturnExpr;
+class SConParams;
+class SomeForalls;
+class Statement;
+class Statements;
+class String;
+class StructMod;
+class TArguments;
+class TArrow;
+class TAtomic;
+class TBasic;
+class TBinder;
+class TBinders;
+class TopDecl;
+class TParam;
+class TParams;
+class TResult;
+class Type;
+class TypeApp;
+class TypeBody;
+class TypeCon;
+class TypeDecl;
+class TypeId;
+class TypeMod;
+class TypeParams;
+class TypeScheme;
+class ValExpr;
+class VarId;
+class WithEff;
+class WithExpr;
+class WithStat;
+class Borrow;
+class ConId;
+class Escape;
+class Id;
+class LineComment;
+class QConId;
+class QId;
+class QIdOp;
+class Wildcard;
+
+class AExpr : public Node {
+public:
+  static constexpr Symbol type_symbol = sym::aexpr;
+
+  using Node::Node;
+
+  std::optional<Annot> annot() const;
+  std::optional<Expr> expr() const;
+};
+
+class AExprs : public Node {
+public:
+  static constexpr Symbol type_symbol = sym::aexprs;
+
+  using Node::Node;
+
+  std::optional<AExpr> a_expr() const;
+};
+
+class AliasDecl : public Node {
+public:
+  static constexpr Symbol type_symbol = sym::aliasdecl;
+
+  using Node::Node;
+
+  std::optional<KAnnot> k_annot() const;
+  std::optional<Type> type() const;
+  std::optional<TypeId> type_id() const;
+  std::optional<TypeParams> type_params() const;
+};
+
+class Annot : public Node {
+public:
+  static constexpr Symbol type_symbol = sym::annot;
+
+  using Node::Node;
+
+  std::optional<TypeScheme> type_scheme() const;
+};
+
+class AnnotRes : public Node {
+public:
+  static constexpr Symbol type_symbol = sym::annotres;
+
+  using Node::Node;
+
+  std::optional<TResult> t_result() const;
+};
+
+class AnnType : public Node {
+public:
+  static constexpr Symbol type_symbol = sym::anntype;
+
+  using Node::Node;
+
+  std::optional<KAnnot> k_annot() const;
+  std::optional<Type> type() const;
+};
+
+class APattern : public Node {
+public:
+  static constexpr Symbol type_symbol = sym::apattern;
+
+  using Node::Node;
+
+  std::optional<Annot> annot() const;
+  std::optional<Pattern> pattern() const;
+};
+
+class APatterns : public Node {
+public:
+  static constexpr Symbol type_symbol = sym::apatterns;
+
+  using Node::Node;
+
+  std::optional<APattern> a_pattern() const;
+};
+
+class AppExpr : public Node {
+public:
+  static constexpr Symbol type_symbol = sym::appexpr;
+
+  using Node::Node;
+
+  std::optional<Atom> field() const;
+  std::optional<AppExpr> function() const;
+  std::optional<AppExpr> app_expr() const;
+  std::optional<Arguments> arguments() const;
+  std::optional<Atom> atom() const;
+  std::optional<Block> block() const;
+  std::optional<FnExpr> fn_expr() const;
+};
+
+class Argument : public Node {
+public:
+  static constexpr Symbol type_symbol = sym::argument;
+
+  using Node::Node;
+
+  std::optional<Expr> expr() const;
+  std::optional<Identifier> identifier() const;
+};
+
+class Arguments : public Node {
+public:
+  static constexpr Symbol type_symbol = sym::arguments;
+
+  using Node::Node;
+
+  std::optional<Argument> argument() const;
+};
+
+class Atom : public Node {
+public:
+  static constexpr Symbol type_symbol = sym::atom;
+
+  using Node::Node;
+
+  std::optional<AExprs> a_exprs() const;
+  std::optional<CExprs> c_exprs() const;
+  std::optional<Literal> literal() const;
+  std::optional<Mask> mask() const;
+  std::optional<QConstructor> q_constructor() const;
+  std::optional<QIdentifier> q_identifier() const;
+};
+
+class BasicExpr : public Node {
+public:
+  static constexpr Symbol type_symbol = sym::basicexpr;
+
+  using Node::Node;
+
+  std::optional<FnExpr> fn_expr() const;
+  std::optional<HandlerExpr> handler_expr() const;
+  std::optional<IfExpr> if_expr() const;
+  std::optional<MatchExpr> match_expr() const;
+  std::optional<OpExpr> op_expr() const;
+};
+
+class Binder : public Node {
+public:
+  static constexpr Symbol type_symbol = sym::binder;
+
+  using Node::Node;
+
+  std::optional<Identifier> identifier() const;
+  std::optional<Type> type() const;
+};
+
+class Block : public Node {
+public:
+  static constexpr Symbol type_symbol = sym::block;
+
+  using Node::Node;
+
+  std::optional<Statements> statements() const;
+};
+
+class BlockComment : public Node {
+public:
+  static constexpr Symbol type_symbol = sym::blockcomment;
+
+  using Node::Node;
+
+  std::optional<BlockComment> block_comment() const;
+};
+
+class BlockExpr : public Node {
+public:
+  static constexpr Symbol type_symbol = sym::blockexpr;
+
+  using Node::Node;
+
+  std::optional<Expr> expr() const;
+};
+
+class BodyExpr : public Node {
+public:
+  static constexpr Symbol type_symbol = sym::bodyexpr;
+
+  using Node::Node;
+
+  std::optional<BlockExpr> block_expr() const;
+};
+
+class CExprs : public Node {
+public:
+  static constexpr Symbol type_symbol = sym::cexprs;
+
+  using Node::Node;
+
+  std::optional<AExpr> a_expr() const;
+};
+
+class Char : public Node {
+public:
+  static constexpr Symbol type_symbol = sym::char_;
+
+  using Node::Node;
+
+  std::optional<Escape> escape() const;
+};
+
+class Commas : public Node {
+public:
+  static constexpr Symbol type_symbol = sym::commas;
+
+  using Node::Node;
+};
+
+class ConParams : public Node {
+public:
+  static constexpr Symbol type_symbol = sym::conparams;
+
+  using Node::Node;
+
+  std::optional<Parameters> parameters() const;
+  std::optional<SConParams> s_con_params() const;
+};
+
+class Constructor : public Node {
+public:
+  static constexpr Symbol type_symbol = sym::constructor;
+
+  using Node::Node;
+
+  std::optional<ConId> con_id() const;
+  std::optional<ConParams> con_params() const;
+  std::optional<String> string() const;
+  std::optional<TypeParams> type_params() const;
+};
+
+class Constructors : public Node {
+public:
+  static constexpr Symbol type_symbol = sym::constructors;
+
+  using Node::Node;
+
+  std::optional<Constructor> constructor() const;
+};
+
+class ControlMod : public Node {
+public:
+  static constexpr Symbol type_symbol = sym::controlmod;
+
+  using Node::Node;
+};
+
+class Decl : public Node {
+public:
+  static constexpr Symbol type_symbol = sym::decl;
+
+  using Node::Node;
+
+  std::optional<APattern> a_pattern() const;
+  std::optional<Binder> binder() const;
+  std::optional<BlockExpr> block_expr() const;
+  std::optional<FunDecl> fun_decl() const;
+};
+
+class EffectMod : public Node {
+public:
+  static constexpr Symbol type_symbol = sym::effectmod;
+
+  using Node::Node;
+};
+
+class Elifs : public Node {
+public:
+  static constexpr Symbol type_symbol = sym::elifs;
+
+  using Node::Node;
+
+  std::optional<BlockExpr> block_expr() const;
+  std::optional<Expr> expr() const;
+};
+
+class Expr : public Node {
+public:
+  static constexpr Symbol type_symbol = sym::expr;
+
+  using Node::Node;
+
+  std::optional<BasicExpr> basic_expr() const;
+  std::optional<Block> block() const;
+  std::optional<ReturnExpr> return_expr() const;
+  std::optional<ValExpr> val_expr() const;
+  std::optional<WithExpr> with_expr() const;
+};
+
+class ExternBody : public Node {
+public:
+  static constexpr Symbol type_symbol = sym::externbody;
+
+  using Node::Node;
+
+  std::optional<ExternStat> extern_stat() const;
+};
+
+class ExternDecl : public Node {
+public:
+  static constexpr Symbol type_symbol = sym::externdecl;
+
+  using Node::Node;
+
+  std::optional<ExternBody> extern_body() const;
+  std::optional<ExternImpBody> extern_imp_body() const;
+  std::optional<ExternType> extern_type() const;
+  std::optional<FipMod> fip_mod() const;
+  std::optional<FunId> fun_id() const;
+};
+
+class ExternImp : public Node {
+public:
+  static constexpr Symbol type_symbol = sym::externimp;
+
+  using Node::Node;
+
+  std::optional<ExternTarget> extern_target() const;
+  std::optional<ExternVal> extern_val() const;
+  std::optional<String> string() const;
+  std::optional<VarId> var_id() const;
+};
+
+class ExternImpBody : public Node {
+public:
+  static constexpr Symbol type_symbol = sym::externimpbody;
+
+  using Node::Node;
+
+  std::optional<ExternImp> extern_imp() const;
+};
+
+class ExternStat : public Node {
+public:
+  static constexpr Symbol type_symbol = sym::externstat;
+
+  using Node::Node;
+
+  std::optional<ExternTarget> extern_target() const;
+  std::optional<String> string() const;
+};
+
+class ExternTarget : public Node {
+public:
+  static constexpr Symbol type_symbol = sym::externtarget;
+
+  using Node::Node;
+};
+
+class ExternType : public Node {
+public:
+  static constexpr Symbol type_symbol = sym::externtype;
+
+  using Node::Node;
+
+  std::optional<AnnotRes> annot_res() const;
+  std::optional<Parameters> parameters() const;
+  std::optional<TypeParams> type_params() const;
+  std::optional<TypeScheme> type_scheme() const;
+};
+
+class ExternVal : public Node {
+public:
+  static constexpr Symbol type_symbol = sym::externval;
+
+  using Node::Node;
+
+  std::optional<String> string() const;
+  std::optional<VarId> var_id() const;
+};
+
+class FipAlloc : public Node {
+public:
+  static constexpr Symbol type_symbol = sym::fipalloc;
+
+  using Node::Node;
+
+  std::optional<Int> int_() const;
+};
+
+class FipMod : public Node {
+public:
+  static constexpr Symbol type_symbol = sym::fipmod;
+
+  using Node::Node;
+
+  std::optional<FipAlloc> fip_alloc() const;
+};
+
+class Fixity : public Node {
+public:
+  static constexpr Symbol type_symbol = sym::fixity;
+
+  using Node::Node;
+
+  std::optional<Int> int_() const;
+};
+
+class FixityDecl : public Node {
+public:
+  static constexpr Symbol type_symbol = sym::fixitydecl;
+
+  using Node::Node;
+
+  std::optional<Fixity> fixity() const;
+  std::optional<OpList> op_list() const;
+};
+
+class Float : public Node {
+public:
+  static constexpr Symbol type_symbol = sym::float_;
+
+  using Node::Node;
+};
+
+class FnExpr : public Node {
+public:
+  static constexpr Symbol type_symbol = sym::fnexpr;
+
+  using Node::Node;
+
+  std::optional<FunBody> fun_body() const;
+};
+
+class FunBody : public Node {
+public:
+  static constexpr Symbol type_symbol = sym::funbody;
+
+  using Node::Node;
+
+  std::optional<Block> block() const;
+  std::optional<BodyExpr> body_expr() const;
+  std::optional<PParameters> p_parameters() const;
+  std::optional<Qualifier> qualifier() const;
+  std::optional<TResult> t_result() const;
+  std::optional<TypeParams> type_params() const;
+};
+
+class FunDecl : public Node {
+public:
+  static constexpr Symbol type_symbol = sym::fundecl;
+
+  using Node::Node;
+
+  std::optional<FunBody> fun_body() const;
+  std::optional<FunId> fun_id() const;
+};
+
+class FunId : public Node {
+public:
+  static constexpr Symbol type_symbol = sym::funid;
+
+  using Node::Node;
+
+  std::optional<Commas> commas() const;
+  std::optional<Identifier> identifier() const;
+  std::optional<String> string() const;
+};
+
+class HandlerExpr : public Node {
+public:
+  static constexpr Symbol type_symbol = sym::handlerexpr;
+
+  using Node::Node;
+
+  std::optional<Expr> expr() const;
+  std::optional<OpClauses> op_clauses() const;
+  std::optional<WithEff> with_eff() const;
+};
+
+class Identifier : public Node {
+public:
+  static constexpr Symbol type_symbol = sym::identifier;
+
+  using Node::Node;
+
+  std::optional<IdOp> id_op() const;
+  std::optional<VarId> var_id() const;
+};
+
+class IdOp : public Node {
+public:
+  static constexpr Symbol type_symbol = sym::idop;
+
+  using Node::Node;
+};
+
+class IfExpr : public Node {
+public:
+  static constexpr Symbol type_symbol = sym::ifexpr;
+
+  using Node::Node;
+
+  std::optional<BlockExpr> block_expr() const;
+  std::optional<Elifs> elifs() const;
+  std::optional<Expr> expr() const;
+};
+
+class ImportDecl : public Node {
+public:
+  static constexpr Symbol type_symbol = sym::importdecl;
+
+  using Node::Node;
+
+  std::optional<ModulePath> module_path() const;
+};
+
+class Int : public Node {
+public:
+  static constexpr Symbol type_symbol = sym::int_;
+
+  using Node::Node;
+};
+
+class KAnnot : public Node {
+public:
+  static constexpr Symbol type_symbol = sym::kannot;
+
+  using Node::Node;
+
+  std::optional<Kind> kind() const;
+};
+
+class KAtom : public Node {
+public:
+  static constexpr Symbol type_symbol = sym::katom;
+
+  using Node::Node;
+
+  std::optional<ConId> con_id() const;
+};
+
+class Kind : public Node {
+public:
+  static constexpr Symbol type_symbol = sym::kind;
+
+  using Node::Node;
+
+  std::optional<KAtom> k_atom() const;
+  std::optional<Kind> kind() const;
+  std::optional<Kinds> kinds() const;
+};
+
+class Kinds : public Node {
+public:
+  static constexpr Symbol type_symbol = sym::kinds;
+
+  using Node::Node;
+
+  std::optional<Kind> kind() const;
+};
+
+class Literal : public Node {
+public:
+  static constexpr Symbol type_symbol = sym::literal;
+
+  using Node::Node;
+
+  std::optional<Char> char_() const;
+  std::optional<Float> float_() const;
+  std::optional<Int> int_() const;
+  std::optional<String> string() const;
+};
+
+class Mask : public Node {
+public:
+  static constexpr Symbol type_symbol = sym::mask;
+
+  using Node::Node;
+
+  std::optional<TBasic> t_basic() const;
+};
+
+class MatchExpr : public Node {
+public:
+  static constexpr Symbol type_symbol = sym::matchexpr;
+
+  using Node::Node;
+
+  std::optional<Expr> expr() const;
+  std::optional<MatchRules> match_rules() const;
+};
+
+class MatchRule : public Node {
+public:
+  static constexpr Symbol type_symbol = sym::matchrule;
+
+  using Node::Node;
+
+  std::optional<BlockExpr> block_expr() const;
+  std::optional<Expr> expr() const;
+  std::optional<Patterns> patterns() const;
+};
+
+class MatchRules : public Node {
+public:
+  static constexpr Symbol type_symbol = sym::matchrules;
+
+  using Node::Node;
+
+  std::optional<MatchRule> match_rule() const;
+};
+
+class ModuleBody : public Node {
+public:
+  static constexpr Symbol type_symbol = sym::modulebody;
+
+  using Node::Node;
+
+  std::optional<FixityDecl> fixity_decl() const;
+  std::optional<ImportDecl> import_decl() const;
+  std::optional<TopDecl> top_decl() const;
+};
+
+class ModuleDecl : public Node {
+public:
+  static constexpr Symbol type_symbol = sym::moduledecl;
+
+  using Node::Node;
+};
+
+class ModulePath : public Node {
+public:
+  static constexpr Symbol type_symbol = sym::modulepath;
+
+  using Node::Node;
+
+  std::optional<QVarId> q_var_id() const;
+  std::optional<VarId> var_id() const;
+};
+
+class Op : public Node {
+public:
+  static constexpr Symbol type_symbol = sym::op;
+
+  using Node::Node;
+};
+
+class OpClause : public Node {
+public:
+  static constexpr Symbol type_symbol = sym::opclause;
+
+  using Node::Node;
+
+  std::optional<BlockExpr> block_expr() const;
+  std::optional<BodyExpr> body_expr() const;
+  std::optional<ControlMod> control_mod() const;
+  std::optional<OpParam> op_param() const;
+  std::optional<OpParams> op_params() const;
+  std::optional<QIdentifier> q_identifier() const;
+  std::optional<Type> type() const;
+};
+
+class OpClauses : public Node {
+public:
+  static constexpr Symbol type_symbol = sym::opclauses;
+
+  using Node::Node;
+
+  std::optional<OpClauseX> op_clause_x() const;
+};
+
+class OpClauseX : public Node {
+public:
+  static constexpr Symbol type_symbol = sym::opclausex;
+
+  using Node::Node;
+
+  std::optional<BodyExpr> body_expr() const;
+  std::optional<OpClause> op_clause() const;
+  std::optional<OpParam> op_param() const;
+};
+
+class OpDecls : public Node {
+public:
+  static constexpr Symbol type_symbol = sym::opdecls;
+
+  using Node::Node;
+
+  std::optional<Operations> operations() const;
+};
+
+class Operation : public Node {
+public:
+  static constexpr Symbol type_symbol = sym::operation;
+
+  using Node::Node;
+
+  std::optional<ControlMod> control_mod() const;
+  std::optional<Identifier> identifier() const;
+  std::optional<Parameters> parameters() const;
+  std::optional<TAtomic> t_atomic() const;
+  std::optional<TypeParams> type_params() const;
+};
+
+class Operations : public Node {
+public:
+  static constexpr Symbol type_symbol = sym::operations;
+
+  using Node::Node;
+
+  std::optional<Operation> operation() const;
+};
+
+class OpExpr : public Node {
+public:
+  static constexpr Symbol type_symbol = sym::opexpr;
+
+  using Node::Node;
+
+  std::optional<PrefixExpr> prefix_expr() const;
+  std::optional<QOperator> q_operator() const;
+};
+
+class OpList : public Node {
+public:
+  static constexpr Symbol type_symbol = sym::oplist;
+
+  using Node::Node;
+
+  std::optional<Identifier> identifier() const;
+};
+
+class OpParam : public Node {
+public:
+  static constexpr Symbol type_symbol = sym::opparam;
+
+  using Node::Node;
+
+  std::optional<ParamId> param_id() const;
+  std::optional<Type> type() const;
+};
+
+class OpParams : public Node {
+public:
+  static constexpr Symbol type_symbol = sym::opparams;
+
+  using Node::Node;
+
+  std::optional<OpParam> op_param() const;
+};
+
+class Parameter : public Node {
+public:
+  static constexpr Symbol type_symbol = sym::parameter;
+
+  using Node::Node;
+
+  std::optional<Borrow> borrow() const;
+  std::optional<Expr> expr() const;
+  std::optional<ParamId> param_id() const;
+  std::optional<Type> type() const;
+};
+
+class Parameters : public Node {
+public:
+  static constexpr Symbol type_symbol = sym::parameters;
+
+  using Node::Node;
+
+  std::optional<Parameter> parameter() const;
+};
+
+class ParamId : public Node {
+public:
+  static constexpr Symbol type_symbol = sym::paramid;
+
+  using Node::Node;
+
+  std::optional<Identifier> identifier() const;
+  std::optional<Wildcard> wildcard() const;
+};
+
+class PatArg : public Node {
+public:
+  static constexpr Symbol type_symbol = sym::patarg;
+
+  using Node::Node;
+
+  std::optional<APattern> a_pattern() const;
+  std::optional<Identifier> identifier() const;
+};
+
+class PatArgs : public Node {
+public:
+  static constexpr Symbol type_symbol = sym::patargs;
+
+  using Node::Node;
+
+  std::optional<PatArg> pat_arg() const;
+};
+
+class Pattern : public Node {
+public:
+  static constexpr Symbol type_symbol = sym::pattern;
+
+  using Node::Node;
+
+  std::optional<APatterns> a_patterns() const;
+  std::optional<Identifier> identifier() const;
+  std::optional<Literal> literal() const;
+  std::optional<PatArgs> pat_args() const;
+  std::optional<Pattern> pattern() const;
+  std::optional<QConstructor> q_constructor() const;
+  std::optional<Wildcard> wildcard() const;
+};
+
+class Patterns : public Node {
+public:
+  static constexpr Symbol type_symbol = sym::patterns;
+
+  using Node::Node;
+
+  std::optional<Pattern> pattern() const;
+};
+
+class PParameter : public Node {
+public:
+  static constexpr Symbol type_symbol = sym::pparameter;
+
+  using Node::Node;
+
+  std::optional<Borrow> borrow() const;
+  std::optional<Expr> expr() const;
+  std::optional<Pattern> pattern() const;
+  std::optional<Type> type() const;
+};
+
+class PParameters : public Node {
+public:
+  static constexpr Symbol type_symbol = sym::pparameters;
+
+  using Node::Node;
+
+  std::optional<PParameter> p_parameter() const;
+};
+
+class Predicate : public Node {
+public:
+  static constexpr Symbol type_symbol = sym::predicate;
+
+  using Node::Node;
+
+  std::optional<TypeApp> type_app() const;
+};
+
+class Predicates : public Node {
+public:
+  static constexpr Symbol type_symbol = sym::predicates;
+
+  using Node::Node;
+
+  std::optional<Predicate> predicate() const;
+};
+
+class PrefixExpr : public Node {
+public:
+  static constexpr Symbol type_symbol = sym::prefixexpr;
+
+  using Node::Node;
+
+  std::optional<AppExpr> app_expr() const;
+  std::optional<PrefixExpr> prefix_expr() const;
+};
+
+class Program : public Node {
+public:
+  static constexpr Symbol type_symbol = sym::program;
+
+  using Node::Node;
+
+  std::optional<ModuleBody> module_body() const;
+  std::optional<ModuleDecl> module_decl() const;
+  std::optional<ModulePath> module_path() const;
+  std::optional<Statements> statements() const;
+};
+
+class PureDecl : public Node {
+public:
+  static constexpr Symbol type_symbol = sym::puredecl;
+
+  using Node::Node;
+
+  std::optional<Binder> binder() const;
+  std::optional<BlockExpr> block_expr() const;
+  std::optional<FipMod> fip_mod() const;
+  std::optional<FunBody> fun_body() const;
+  std::optional<FunId> fun_id() const;
+};
+
+class QConstructor : public Node {
+public:
+  static constexpr Symbol type_symbol = sym::qconstructor;
+
+  using Node::Node;
+
+  std::optional<ConId> con_id() const;
+  std::optional<QConId> q_con_id() const;
+};
+
+class QIdentifier : public Node {
+public:
+  static constexpr Symbol type_symbol = sym::qidentifier;
+
+  using Node::Node;
+
+  std::optional<Identifier> identifier() const;
+  std::optional<QIdOp> q_id_op() const;
+  std::optional<QVarId> q_var_id() const;
+};
+
+class QOperator : public Node {
+public:
+  static constexpr Symbol type_symbol = sym::qoperator;
+
+  using Node::Node;
+
+  std::optional<Op> op() const;
+};
+
+class Qualifier : public Node {
+public:
+  static constexpr Symbol type_symbol = sym::qualifier;
+
+  using Node::Node;
+
+  std::optional<Predicates> predicates() const;
+};
+
+class QVarId : public Node {
+public:
+  static constexpr Symbol type_symbol = sym::qvarid;
+
+  using Node::Node;
+
+  std::optional<QId> q_id() const;
+};
+
+class ReturnExpr : public Node {
+public:
+  static constexpr Symbol type_symbol = sym::returnexpr;
+
+  using Node::Node;
+
+  std::optional<Expr> expr() const;
+};
+
+class SConParams : public Node {
+public:
+  static constexpr Symbol type_symbol = sym::sconparams;
+
+  using Node::Node;
+
+  std::optional<Parameter> parameter() const;
+};
+
+class SomeForalls : public Node {
+public:
+  static constexpr Symbol type_symbol = sym::someforalls;
+
+  using Node::Node;
+
+  std::optional<TypeParams> type_params() const;
+};
+
+class Statement : public Node {
+public:
+  static constexpr Symbol type_symbol = sym::statement;
+
+  using Node::Node;
+
+  std::optional<BasicExpr> basic_expr() const;
+  std::optional<BlockExpr> block_expr() const;
+  std::optional<Decl> decl() const;
+  std::optional<ReturnExpr> return_expr() const;
+  std::optional<WithStat> with_stat() const;
+};
+
+class Statements : public Node {
+public:
+  static constexpr Symbol type_symbol = sym::statements;
+
+  using Node::Node;
+
+  std::optional<Statement> statement() const;
+};
+
+class String : public Node {
+public:
+  static constexpr Symbol type_symbol = sym::string;
+
+  using Node::Node;
+
+  std::optional<Escape> escape() const;
+};
+
+class StructMod : public Node {
+public:
+  static constexpr Symbol type_symbol = sym::structmod;
+
+  using Node::Node;
+};
+
+class TArguments : public Node {
+public:
+  static constexpr Symbol type_symbol = sym::targuments;
+
+  using Node::Node;
+
+  std::optional<AnnType> ann_type() const;
+};
+
+class TArrow : public Node {
+public:
+  static constexpr Symbol type_symbol = sym::tarrow;
+
+  using Node::Node;
+
+  std::optional<TAtomic> t_atomic() const;
+  std::optional<TResult> t_result() const;
+};
+
+class TAtomic : public Node {
+public:
+  static constexpr Symbol type_symbol = sym::tatomic;
+
+  using Node::Node;
+
+  std::optional<TArguments> t_arguments() const;
+  std::optional<TAtomic> t_atomic() const;
+  std::optional<TBasic> t_basic() const;
+};
+
+class TBasic : public Node {
+public:
+  static constexpr Symbol type_symbol = sym::tbasic;
+
+  using Node::Node;
+
+  std::optional<AnnType> ann_type() const;
+  std::optional<TParams> t_params() const;
+  std::optional<TypeApp> type_app() const;
+};
+
+class TBinder : public Node {
+public:
+  static constexpr Symbol type_symbol = sym::tbinder;
+
+  using Node::Node;
+
+  std::optional<KAnnot> k_annot() const;
+  std::optional<VarId> var_id() const;
+};
+
+class TBinders : public Node {
+public:
+  static constexpr Symbol type_symbol = sym::tbinders;
+
+  using Node::Node;
+
+  std::optional<TBinder> t_binder() const;
+};
+
+class TopDecl : public Node {
+public:
+  static constexpr Symbol type_symbol = sym::topdecl;
+
+  using Node::Node;
+
+  std::optional<AliasDecl> alias_decl() const;
+  std::optional<ExternDecl> extern_decl() const;
+  std::optional<PureDecl> pure_decl() const;
+  std::optional<TypeDecl> type_decl() const;
+};
+
+class TParam : public Node {
+public:
+  static constexpr Symbol type_symbol = sym::tparam;
+
+  using Node::Node;
+
+  std::optional<AnnType> ann_type() const;
+  std::optional<Identifier> identifier() const;
+};
+
+class TParams : public Node {
+public:
+  static constexpr Symbol type_symbol = sym::tparams;
+
+  using Node::Node;
+
+  std::optional<TParam> t_param() const;
+};
+
+class TResult : public Node {
+public:
+  static constexpr Symbol type_symbol = sym::tresult;
+
+  using Node::Node;
+
+  std::optional<TAtomic> t_atomic() const;
+  std::optional<TBasic> t_basic() const;
+};
+
+class Type : public Node {
+public:
+  static constexpr Symbol type_symbol = sym::type;
+
+  using Node::Node;
+
+  std::optional<Qualifier> qualifier() const;
+  std::optional<TArrow> t_arrow() const;
+  std::optional<TypeParams> type_params() const;
+};
+
+class TypeApp : public Node {
+public:
+  static constexpr Symbol type_symbol = sym::typeapp;
+
+  using Node::Node;
+
+  std::optional<TArguments> t_arguments() const;
+  std::optional<TypeCon> type_con() const;
+};
+
+class TypeBody : public Node {
+public:
+  static constexpr Symbol type_symbol = sym::typebody;
+
+  using Node::Node;
+
+  std::optional<Constructors> constructors() const;
+};
+
+class TypeCon : public Node {
+public:
+  static constexpr Symbol type_symbol = sym::typecon;
+
+  using Node::Node;
+
+  std::optional<Commas> commas() const;
+  std::optional<QVarId> q_var_id() const;
+  std::optional<VarId> var_id() const;
+  std::optional<Wildcard> wildcard() const;
+};
+
+class TypeDecl : public Node {
+public:
+  static constexpr Symbol type_symbol = sym::typedecl;
+
+  using Node::Node;
+
+  std::optional<ConParams> con_params() const;
+  std::optional<EffectMod> effect_mod() const;
+  std::optional<KAnnot> k_annot() const;
+  std::optional<OpDecls> op_decls() const;
+  std::optional<Operation> operation() const;
+  std::optional<StructMod> struct_mod() const;
+  std::optional<Type> type() const;
+  std::optional<TypeBody> type_body() const;
+  std::optional<TypeId> type_id() const;
+  std::optional<TypeMod> type_mod() const;
+  std::optional<TypeParams> type_params() const;
+  std::optional<VarId> var_id() const;
+};
+
+class TypeId : public Node {
+public:
+  static constexpr Symbol type_symbol = sym::typeid_;
+
+  using Node::Node;
+
+  std::optional<Commas> commas() const;
+  std::optional<VarId> var_id() const;
+};
+
+class TypeMod : public Node {
+public:
+  static constexpr Symbol type_symbol = sym::typemod;
+
+  using Node::Node;
+
+  std::optional<StructMod> struct_mod() const;
+};
+
+class TypeParams : public Node {
+public:
+  static constexpr Symbol type_symbol = sym::typeparams;
+
+  using Node::Node;
+
+  std::optional<TBinders> t_binders() const;
+};
+
+class TypeScheme : public Node {
+public:
+  static constexpr Symbol type_symbol = sym::typescheme;
+
+  using Node::Node;
+
+  std::optional<Qualifier> qualifier() const;
+  std::optional<SomeForalls> some_foralls() const;
+  std::optional<TArrow> t_arrow() const;
+};
+
+class ValExpr : public Node {
+public:
+  static constexpr Symbol type_symbol = sym::valexpr;
+
+  using Node::Node;
+
+  std::optional<APattern> a_pattern() const;
+  std::optional<BlockExpr> block_expr() const;
+  std::optional<Expr> expr() const;
+};
+
+class VarId : public Node {
+public:
+  static constexpr Symbol type_symbol = sym::varid;
+
+  using Node::Node;
+
+  std::optional<Id> id() const;
+};
+
+class WithEff : public Node {
+public:
+  static constexpr Symbol type_symbol = sym::witheff;
+
+  using Node::Node;
+
+  std::optional<AnnType> ann_type() const;
+};
+
+class WithExpr : public Node {
+public:
+  static constexpr Symbol type_symbol = sym::withexpr;
+
+  using Node::Node;
+
+  std::optional<BlockExpr> block_expr() const;
+  std::optional<WithStat> with_stat() const;
+};
+
+class WithStat : public Node {
+public:
+  static constexpr Symbol type_symbol = sym::withstat;
+
+  using Node::Node;
+
+  std::optional<BasicExpr> basic_expr() const;
+  std::optional<Binder> binder() const;
+  std::optional<OpClause> op_clause() const;
+  std::optional<WithEff> with_eff() const;
+};
+
+class Borrow : public Node {
+public:
+  static constexpr Symbol type_symbol = sym::borrow;
+
+  using Node::Node;
+};
+
+class ConId : public Node {
+public:
+  static constexpr Symbol type_symbol = sym::conid;
+
+  using Node::Node;
+};
+
+class Escape : public Node {
+public:
+  static constexpr Symbol type_symbol = sym::escape;
+
+  using Node::Node;
+};
+
+class Id : public Node {
+public:
+  static constexpr Symbol type_symbol = sym::id;
+
+  using Node::Node;
+};
+
+class LineComment : public Node {
+public:
+  static constexpr Symbol type_symbol = sym::linecomment;
+
+  using Node::Node;
+};
+
+class QConId : public Node {
+public:
+  static constexpr Symbol type_symbol = sym::qconid;
+
+  using Node::Node;
+};
+
+class QId : public Node {
+public:
+  static constexpr Symbol type_symbol = sym::qid;
+
+  using Node::Node;
+};
+
+class QIdOp : public Node {
+public:
+  static constexpr Symbol type_symbol = sym::qidop;
+
+  using Node::Node;
+};
+
+class Wildcard : public Node {
+public:
+  static constexpr Symbol type_symbol = sym::wildcard;
+
+  using Node::Node;
+};
+
+inline std::optional<Annot> AExpr::annot() const {
+  return child<Annot>();
+}
+
+inline std::optional<Expr> AExpr::expr() const {
+  return child<Expr>();
+}
+
+inline std::optional<AExpr> AExprs::a_expr() const {
+  return child<AExpr>();
+}
+
+inline std::optional<KAnnot> AliasDecl::k_annot() const {
+  return child<KAnnot>();
+}
+
+inline std::optional<Type> AliasDecl::type() const {
+  return child<Type>();
+}
+
+inline std::optional<TypeId> AliasDecl::type_id() const {
+  return child<TypeId>();
+}
+
+inline std::optional<TypeParams> AliasDecl::type_params() const {
+  return child<TypeParams>();
+}
+
+inline std::optional<TypeScheme> Annot::type_scheme() const {
+  return child<TypeScheme>();
+}
+
+inline std::optional<TResult> AnnotRes::t_result() const {
+  return child<TResult>();
+}
+
+inline std::optional<KAnnot> AnnType::k_annot() const {
+  return child<KAnnot>();
+}
+
+inline std::optional<Type> AnnType::type() const {
+  return child<Type>();
+}
+
+inline std::optional<Annot> APattern::annot() const {
+  return child<Annot>();
+}
+
+inline std::optional<Pattern> APattern::pattern() const {
+  return child<Pattern>();
+}
+
+inline std::optional<APattern> APatterns::a_pattern() const {
+  return child<APattern>();
+}
+
+inline std::optional<Atom> AppExpr::field() const {
+  return child_by_field<Atom>(field::field);
+}
+
+inline std::optional<AppExpr> AppExpr::function() const {
+  return child_by_field<AppExpr>(field::function);
+}
+
+inline std::optional<AppExpr> AppExpr::app_expr() const {
+  return child<AppExpr>();
+}
+
+inline std::optional<Arguments> AppExpr::arguments() const {
+  return child<Arguments>();
+}
+
+inline std::optional<Atom> AppExpr::atom() const {
+  return child<Atom>();
+}
+
+inline std::optional<Block> AppExpr::block() const {
+  return child<Block>();
+}
+
+inline std::optional<FnExpr> AppExpr::fn_expr() const {
+  return child<FnExpr>();
+}
+
+inline std::optional<Expr> Argument::expr() const {
+  return child<Expr>();
+}
+
+inline std::optional<Identifier> Argument::identifier() const {
+  return child<Identifier>();
+}
+
+inline std::optional<Argument> Arguments::argument() const {
+  return child<Argument>();
+}
+
+inline std::optional<AExprs> Atom::a_exprs() const {
+  return child<AExprs>();
+}
+
+inline std::optional<CExprs> Atom::c_exprs() const {
+  return child<CExprs>();
+}
+
+inline std::optional<Literal> Atom::literal() const {
+  return child<Literal>();
+}
+
+inline std::optional<Mask> Atom::mask() const {
+  return child<Mask>();
+}
+
+inline std::optional<QConstructor> Atom::q_constructor() const {
+  return child<QConstructor>();
+}
+
+inline std::optional<QIdentifier> Atom::q_identifier() const {
+  return child<QIdentifier>();
+}
+
+inline std::optional<FnExpr> BasicExpr::fn_expr() const {
+  return child<FnExpr>();
+}
+
+inline std::optional<HandlerExpr> BasicExpr::handler_expr() const {
+  return child<HandlerExpr>();
+}
+
+inline std::optional<IfExpr> BasicExpr::if_expr() const {
+  return child<IfExpr>();
+}
+
+inline std::optional<MatchExpr> BasicExpr::match_expr() const {
+  return child<MatchExpr>();
+}
+
+inline std::optional<OpExpr> BasicExpr::op_expr() const {
+  return child<OpExpr>();
+}
+
+inline std::optional<Identifier> Binder::identifier() const {
+  return child<Identifier>();
+}
+
+inline std::optional<Type> Binder::type() const {
+  return child<Type>();
+}
+
+inline std::optional<Statements> Block::statements() const {
+  return child<Statements>();
+}
+
+inline std::optional<BlockComment> BlockComment::block_comment() const {
+  return child<BlockComment>();
+}
+
+inline std::optional<Expr> BlockExpr::expr() const {
+  return child<Expr>();
+}
+
+inline std::optional<BlockExpr> BodyExpr::block_expr() const {
+  return child<BlockExpr>();
+}
+
+inline std::optional<AExpr> CExprs::a_expr() const {
+  return child<AExpr>();
+}
+
+inline std::optional<Escape> Char::escape() const {
+  return child<Escape>();
+}
+
+inline std::optional<Parameters> ConParams::parameters() const {
+  return child<Parameters>();
+}
+
+inline std::optional<SConParams> ConParams::s_con_params() const {
+  return child<SConParams>();
+}
+
+inline std::optional<ConId> Constructor::con_id() const {
+  return child<ConId>();
+}
+
+inline std::optional<ConParams> Constructor::con_params() const {
+  return child<ConParams>();
+}
+
+inline std::optional<String> Constructor::string() const {
+  return child<String>();
+}
+
+inline std::optional<TypeParams> Constructor::type_params() const {
+  return child<TypeParams>();
+}
+
+inline std::optional<Constructor> Constructors::constructor() const {
+  return child<Constructor>();
+}
+
+inline std::optional<APattern> Decl::a_pattern() const {
+  return child<APattern>();
+}
+
+inline std::optional<Binder> Decl::binder() const {
+  return child<Binder>();
+}
+
+inline std::optional<BlockExpr> Decl::block_expr() const {
+  return child<BlockExpr>();
+}
+
+inline std::optional<FunDecl> Decl::fun_decl() const {
+  return child<FunDecl>();
+}
+
+inline std::optional<BlockExpr> Elifs::block_expr() const {
+  return child<BlockExpr>();
+}
+
+inline std::optional<Expr> Elifs::expr() const {
+  return child<Expr>();
+}
+
+inline std::optional<BasicExpr> Expr::basic_expr() const {
+  return child<BasicExpr>();
+}
+
+inline std::optional<Block> Expr::block() const {
+  return child<Block>();
+}
+
+inline std::optional<ReturnExpr> Expr::return_expr() const {
+  return child<ReturnExpr>();
+}
+
+inline std::optional<ValExpr> Expr::val_expr() const {
+  return child<ValExpr>();
+}
+
+inline std::optional<WithExpr> Expr::with_expr() const {
+  return child<WithExpr>();
+}
+
+inline std::optional<ExternStat> ExternBody::extern_stat() const {
+  return child<ExternStat>();
+}
+
+inline std::optional<ExternBody> ExternDecl::extern_body() const {
+  return child<ExternBody>();
+}
+
+inline std::optional<ExternImpBody> ExternDecl::extern_imp_body() const {
+  return child<ExternImpBody>();
+}
+
+inline std::optional<ExternType> ExternDecl::extern_type() const {
+  return child<ExternType>();
+}
+
+inline std::optional<FipMod> ExternDecl::fip_mod() const {
+  return child<FipMod>();
+}
+
+inline std::optional<FunId> ExternDecl::fun_id() const {
+  return child<FunId>();
+}
+
+inline std::optional<ExternTarget> ExternImp::extern_target() const {
+  return child<ExternTarget>();
+}
+
+inline std::optional<ExternVal> ExternImp::extern_val() const {
+  return child<ExternVal>();
+}
+
+inline std::optional<String> ExternImp::string() const {
+  return child<String>();
+}
+
+inline std::optional<VarId> ExternImp::var_id() const {
+  return child<VarId>();
+}
+
+inline std::optional<ExternImp> ExternImpBody::extern_imp() const {
+  return child<ExternImp>();
+}
+
+inline std::optional<ExternTarget> ExternStat::extern_target() const {
+  return child<ExternTarget>();
+}
+
+inline std::optional<String> ExternStat::string() const {
+  return child<String>();
+}
+
+inline std::optional<AnnotRes> ExternType::annot_res() const {
+  return child<AnnotRes>();
+}
+
+inline std::optional<Parameters> ExternType::parameters() const {
+  return child<Parameters>();
+}
+
+inline std::optional<TypeParams> ExternType::type_params() const {
+  return child<TypeParams>();
+}
+
+inline std::optional<TypeScheme> ExternType::type_scheme() const {
+  return child<TypeScheme>();
+}
+
+inline std::optional<String> ExternVal::string() const {
+  return child<String>();
+}
+
+inline std::optional<VarId> ExternVal::var_id() const {
+  return child<VarId>();
+}
+
+inline std::optional<Int> FipAlloc::int_() const {
+  return child<Int>();
+}
+
+inline std::optional<FipAlloc> FipMod::fip_alloc() const {
+  return child<FipAlloc>();
+}
+
+inline std::optional<Int> Fixity::int_() const {
+  return child<Int>();
+}
+
+inline std::optional<Fixity> FixityDecl::fixity() const {
+  return child<Fixity>();
+}
+
+inline std::optional<OpList> FixityDecl::op_list() const {
+  return child<OpList>();
+}
+
+inline std::optional<FunBody> FnExpr::fun_body() const {
+  return child<FunBody>();
+}
+
+inline std::optional<Block> FunBody::block() const {
+  return child<Block>();
+}
+
+inline std::optional<BodyExpr> FunBody::body_expr() const {
+  return child<BodyExpr>();
+}
+
+inline std::optional<PParameters> FunBody::p_parameters() const {
+  return child<PParameters>();
+}
+
+inline std::optional<Qualifier> FunBody::qualifier() const {
+  return child<Qualifier>();
+}
+
+inline std::optional<TResult> FunBody::t_result() const {
+  return child<TResult>();
+}
+
+inline std::optional<TypeParams> FunBody::type_params() const {
+  return child<TypeParams>();
+}
+
+inline std::optional<FunBody> FunDecl::fun_body() const {
+  return child<FunBody>();
+}
+
+inline std::optional<FunId> FunDecl::fun_id() const {
+  return child<FunId>();
+}
+
+inline std::optional<Commas> FunId::commas() const {
+  return child<Commas>();
+}
+
+inline std::optional<Identifier> FunId::identifier() const {
+  return child<Identifier>();
+}
+
+inline std::optional<String> FunId::string() const {
+  return child<String>();
+}
+
+inline std::optional<Expr> HandlerExpr::expr() const {
+  return child<Expr>();
+}
+
+inline std::optional<OpClauses> HandlerExpr::op_clauses() const {
+  return child<OpClauses>();
+}
+
+inline std::optional<WithEff> HandlerExpr::with_eff() const {
+  return child<WithEff>();
+}
+
+inline std::optional<IdOp> Identifier::id_op() const {
+  return child<IdOp>();
+}
+
+inline std::optional<VarId> Identifier::var_id() const {
+  return child<VarId>();
+}
+
+inline std::optional<BlockExpr> IfExpr::block_expr() const {
+  return child<BlockExpr>();
+}
+
+inline std::optional<Elifs> IfExpr::elifs() const {
+  return child<Elifs>();
+}
+
+inline std::optional<Expr> IfExpr::expr() const {
+  return child<Expr>();
+}
+
+inline std::optional<ModulePath> ImportDecl::module_path() const {
+  return child<ModulePath>();
+}
+
+inline std::optional<Kind> KAnnot::kind() const {
+  return child<Kind>();
+}
+
+inline std::optional<ConId> KAtom::con_id() const {
+  return child<ConId>();
+}
+
+inline std::optional<KAtom> Kind::k_atom() const {
+  return child<KAtom>();
+}
+
+inline std::optional<Kind> Kind::kind() const {
+  return child<Kind>();
+}
+
+inline std::optional<Kinds> Kind::kinds() const {
+  return child<Kinds>();
+}
+
+inline std::optional<Kind> Kinds::kind() const {
+  return child<Kind>();
+}
+
+inline std::optional<Char> Literal::char_() const {
+  return child<Char>();
+}
+
+inline std::optional<Float> Literal::float_() const {
+  return child<Float>();
+}
+
+inline std::optional<Int> Literal::int_() const {
+  return child<Int>();
+}
+
+inline std::optional<String> Literal::string() const {
+  return child<String>();
+}
+
+inline std::optional<TBasic> Mask::t_basic() const {
+  return child<TBasic>();
+}
+
+inline std::optional<Expr> MatchExpr::expr() const {
+  return child<Expr>();
+}
+
+inline std::optional<MatchRules> MatchExpr::match_rules() const {
+  return child<MatchRules>();
+}
+
+inline std::optional<BlockExpr> MatchRule::block_expr() const {
+  return child<BlockExpr>();
+}
+
+inline std::optional<Expr> MatchRule::expr() const {
+  return child<Expr>();
+}
+
+inline std::optional<Patterns> MatchRule::patterns() const {
+  return child<Patterns>();
+}
+
+inline std::optional<MatchRule> MatchRules::match_rule() const {
+  return child<MatchRule>();
+}
+
+inline std::optional<FixityDecl> ModuleBody::fixity_decl() const {
+  return child<FixityDecl>();
+}
+
+inline std::optional<ImportDecl> ModuleBody::import_decl() const {
+  return child<ImportDecl>();
+}
+
+inline std::optional<TopDecl> ModuleBody::top_decl() const {
+  return child<TopDecl>();
+}
+
+inline std::optional<QVarId> ModulePath::q_var_id() const {
+  return child<QVarId>();
+}
+
+inline std::optional<VarId> ModulePath::var_id() const {
+  return child<VarId>();
+}
+
+inline std::optional<BlockExpr> OpClause::block_expr() const {
+  return child<BlockExpr>();
+}
+
+inline std::optional<BodyExpr> OpClause::body_expr() const {
+  return child<BodyExpr>();
+}
+
+inline std::optional<ControlMod> OpClause::control_mod() const {
+  return child<ControlMod>();
+}
+
+inline std::optional<OpParam> OpClause::op_param() const {
+  return child<OpParam>();
+}
+
+inline std::optional<OpParams> OpClause::op_params() const {
+  return child<OpParams>();
+}
+
+inline std::optional<QIdentifier> OpClause::q_identifier() const {
+  return child<QIdentifier>();
+}
+
+inline std::optional<Type> OpClause::type() const {
+  return child<Type>();
+}
+
+inline std::optional<OpClauseX> OpClauses::op_clause_x() const {
+  return child<OpClauseX>();
+}
+
+inline std::optional<BodyExpr> OpClauseX::body_expr() const {
+  return child<BodyExpr>();
+}
+
+inline std::optional<OpClause> OpClauseX::op_clause() const {
+  return child<OpClause>();
+}
+
+inline std::optional<OpParam> OpClauseX::op_param() const {
+  return child<OpParam>();
+}
+
+inline std::optional<Operations> OpDecls::operations() const {
+  return child<Operations>();
+}
+
+inline std::optional<ControlMod> Operation::control_mod() const {
+  return child<ControlMod>();
+}
+
+inline std::optional<Identifier> Operation::identifier() const {
+  return child<Identifier>();
+}
+
+inline std::optional<Parameters> Operation::parameters() const {
+  return child<Parameters>();
+}
+
+inline std::optional<TAtomic> Operation::t_atomic() const {
+  return child<TAtomic>();
+}
+
+inline std::optional<TypeParams> Operation::type_params() const {
+  return child<TypeParams>();
+}
+
+inline std::optional<Operation> Operations::operation() const {
+  return child<Operation>();
+}
+
+inline std::optional<PrefixExpr> OpExpr::prefix_expr() const {
+  return child<PrefixExpr>();
+}
+
+inline std::optional<QOperator> OpExpr::q_operator() const {
+  return child<QOperator>();
+}
+
+inline std::optional<Identifier> OpList::identifier() const {
+  return child<Identifier>();
+}
+
+inline std::optional<ParamId> OpParam::param_id() const {
+  return child<ParamId>();
+}
+
+inline std::optional<Type> OpParam::type() const {
+  return child<Type>();
+}
+
+inline std::optional<OpParam> OpParams::op_param() const {
+  return child<OpParam>();
+}
+
+inline std::optional<Borrow> Parameter::borrow() const {
+  return child<Borrow>();
+}
+
+inline std::optional<Expr> Parameter::expr() const {
+  return child<Expr>();
+}
+
+inline std::optional<ParamId> Parameter::param_id() const {
+  return child<ParamId>();
+}
+
+inline std::optional<Type> Parameter::type() const {
+  return child<Type>();
+}
+
+inline std::optional<Parameter> Parameters::parameter() const {
+  return child<Parameter>();
+}
+
+inline std::optional<Identifier> ParamId::identifier() const {
+  return child<Identifier>();
+}
+
+inline std::optional<Wildcard> ParamId::wildcard() const {
+  return child<Wildcard>();
+}
+
+inline std::optional<APattern> PatArg::a_pattern() const {
+  return child<APattern>();
+}
+
+inline std::optional<Identifier> PatArg::identifier() const {
+  return child<Identifier>();
+}
+
+inline std::optional<PatArg> PatArgs::pat_arg() const {
+  return child<PatArg>();
+}
+
+inline std::optional<APatterns> Pattern::a_patterns() const {
+  return child<APatterns>();
+}
+
+inline std::optional<Identifier> Pattern::identifier() const {
+  return child<Identifier>();
+}
+
+inline std::optional<Literal> Pattern::literal() const {
+  return child<Literal>();
+}
+
+inline std::optional<PatArgs> Pattern::pat_args() const {
+  return child<PatArgs>();
+}
+
+inline std::optional<Pattern> Pattern::pattern() const {
+  return child<Pattern>();
+}
+
+inline std::optional<QConstructor> Pattern::q_constructor() const {
+  return child<QConstructor>();
+}
+
+inline std::optional<Wildcard> Pattern::wildcard() const {
+  return child<Wildcard>();
+}
+
+inline std::optional<Pattern> Patterns::pattern() const {
+  return child<Pattern>();
+}
+
+inline std::optional<Borrow> PParameter::borrow() const {
+  return child<Borrow>();
+}
+
+inline std::optional<Expr> PParameter::expr() const {
+  return child<Expr>();
+}
+
+inline std::optional<Pattern> PParameter::pattern() const {
+  return child<Pattern>();
+}
+
+inline std::optional<Type> PParameter::type() const {
+  return child<Type>();
+}
+
+inline std::optional<PParameter> PParameters::p_parameter() const {
+  return child<PParameter>();
+}
+
+inline std::optional<TypeApp> Predicate::type_app() const {
+  return child<TypeApp>();
+}
+
+inline std::optional<Predicate> Predicates::predicate() const {
+  return child<Predicate>();
+}
+
+inline std::optional<AppExpr> PrefixExpr::app_expr() const {
+  return child<AppExpr>();
+}
+
+inline std::optional<PrefixExpr> PrefixExpr::prefix_expr() const {
+  return child<PrefixExpr>();
+}
+
+inline std::optional<ModuleBody> Program::module_body() const {
+  return child<ModuleBody>();
+}
+
+inline std::optional<ModuleDecl> Program::module_decl() const {
+  return child<ModuleDecl>();
+}
+
+inline std::optional<ModulePath> Program::module_path() const {
+  return child<ModulePath>();
+}
+
+inline std::optional<Statements> Program::statements() const {
+  return child<Statements>();
+}
+
+inline std::optional<Binder> PureDecl::binder() const {
+  return child<Binder>();
+}
+
+inline std::optional<BlockExpr> PureDecl::block_expr() const {
+  return child<BlockExpr>();
+}
+
+inline std::optional<FipMod> PureDecl::fip_mod() const {
+  return child<FipMod>();
+}
+
+inline std::optional<FunBody> PureDecl::fun_body() const {
+  return child<FunBody>();
+}
+
+inline std::optional<FunId> PureDecl::fun_id() const {
+  return child<FunId>();
+}
+
+inline std::optional<ConId> QConstructor::con_id() const {
+  return child<ConId>();
+}
+
+inline std::optional<QConId> QConstructor::q_con_id() const {
+  return child<QConId>();
+}
+
+inline std::optional<Identifier> QIdentifier::identifier() const {
+  return child<Identifier>();
+}
+
+inline std::optional<QIdOp> QIdentifier::q_id_op() const {
+  return child<QIdOp>();
+}
+
+inline std::optional<QVarId> QIdentifier::q_var_id() const {
+  return child<QVarId>();
+}
+
+inline std::optional<Op> QOperator::op() const {
+  return child<Op>();
+}
+
+inline std::optional<Predicates> Qualifier::predicates() const {
+  return child<Predicates>();
+}
+
+inline std::optional<QId> QVarId::q_id() const {
+  return child<QId>();
+}
+
+inline std::optional<Expr> ReturnExpr::expr() const {
+  return child<Expr>();
+}
+
+inline std::optional<Parameter> SConParams::parameter() const {
+  return child<Parameter>();
+}
+
+inline std::optional<TypeParams> SomeForalls::type_params() const {
+  return child<TypeParams>();
+}
+
+inline std::optional<BasicExpr> Statement::basic_expr() const {
+  return child<BasicExpr>();
+}
+
+inline std::optional<BlockExpr> Statement::block_expr() const {
+  return child<BlockExpr>();
+}
+
+inline std::optional<Decl> Statement::decl() const {
+  return child<Decl>();
+}
+
+inline std::optional<ReturnExpr> Statement::return_expr() const {
+  return child<ReturnExpr>();
+}
+
+inline std::optional<WithStat> Statement::with_stat() const {
+  return child<WithStat>();
+}
+
+inline std::optional<Statement> Statements::statement() const {
+  return child<Statement>();
+}
+
+inline std::optional<Escape> String::escape() const {
+  return child<Escape>();
+}
+
+inline std::optional<AnnType> TArguments::ann_type() const {
+  return child<AnnType>();
+}
+
+inline std::optional<TAtomic> TArrow::t_atomic() const {
+  return child<TAtomic>();
+}
+
+inline std::optional<TResult> TArrow::t_result() const {
+  return child<TResult>();
+}
+
+inline std::optional<TArguments> TAtomic::t_arguments() const {
+  return child<TArguments>();
+}
+
+inline std::optional<TAtomic> TAtomic::t_atomic() const {
+  return child<TAtomic>();
+}
+
+inline std::optional<TBasic> TAtomic::t_basic() const {
+  return child<TBasic>();
+}
+
+inline std::optional<AnnType> TBasic::ann_type() const {
+  return child<AnnType>();
+}
+
+inline std::optional<TParams> TBasic::t_params() const {
+  return child<TParams>();
+}
+
+inline std::optional<TypeApp> TBasic::type_app() const {
+  return child<TypeApp>();
+}
+
+inline std::optional<KAnnot> TBinder::k_annot() const {
+  return child<KAnnot>();
+}
+
+inline std::optional<VarId> TBinder::var_id() const {
+  return child<VarId>();
+}
+
+inline std::optional<TBinder> TBinders::t_binder() const {
+  return child<TBinder>();
+}
+
+inline std::optional<AliasDecl> TopDecl::alias_decl() const {
+  return child<AliasDecl>();
+}
+
+inline std::optional<ExternDecl> TopDecl::extern_decl() const {
+  return child<ExternDecl>();
+}
+
+inline std::optional<PureDecl> TopDecl::pure_decl() const {
+  return child<PureDecl>();
+}
+
+inline std::optional<TypeDecl> TopDecl::type_decl() const {
+  return child<TypeDecl>();
+}
+
+inline std::optional<AnnType> TParam::ann_type() const {
+  return child<AnnType>();
+}
+
+inline std::optional<Identifier> TParam::identifier() const {
+  return child<Identifier>();
+}
+
+inline std::optional<TParam> TParams::t_param() const {
+  return child<TParam>();
+}
+
+inline std::optional<TAtomic> TResult::t_atomic() const {
+  return child<TAtomic>();
+}
+
+inline std::optional<TBasic> TResult::t_basic() const {
+  return child<TBasic>();
+}
+
+inline std::optional<Qualifier> Type::qualifier() const {
+  return child<Qualifier>();
+}
+
+inline std::optional<TArrow> Type::t_arrow() const {
+  return child<TArrow>();
+}
+
+inline std::optional<TypeParams> Type::type_params() const {
+  return child<TypeParams>();
+}
+
+inline std::optional<TArguments> TypeApp::t_arguments() const {
+  return child<TArguments>();
+}
+
+inline std::optional<TypeCon> TypeApp::type_con() const {
+  return child<TypeCon>();
+}
+
+inline std::optional<Constructors> TypeBody::constructors() const {
+  return child<Constructors>();
+}
+
+inline std::optional<Commas> TypeCon::commas() const {
+  return child<Commas>();
+}
+
+inline std::optional<QVarId> TypeCon::q_var_id() const {
+  return child<QVarId>();
+}
+
+inline std::optional<VarId> TypeCon::var_id() const {
+  return child<VarId>();
+}
+
+inline std::optional<Wildcard> TypeCon::wildcard() const {
+  return child<Wildcard>();
+}
+
+inline std::optional<ConParams> TypeDecl::con_params() const {
+  return child<ConParams>();
+}
+
+inline std::optional<EffectMod> TypeDecl::effect_mod() const {
+  return child<EffectMod>();
+}
+
+inline std::optional<KAnnot> TypeDecl::k_annot() const {
+  return child<KAnnot>();
+}
+
+inline std::optional<OpDecls> TypeDecl::op_decls() const {
+  return child<OpDecls>();
+}
+
+inline std::optional<Operation> TypeDecl::operation() const {
+  return child<Operation>();
+}
+
+inline std::optional<StructMod> TypeDecl::struct_mod() const {
+  return child<StructMod>();
+}
+
+inline std::optional<Type> TypeDecl::type() const {
+  return child<Type>();
+}
+
+inline std::optional<TypeBody> TypeDecl::type_body() const {
+  return child<TypeBody>();
+}
+
+inline std::optional<TypeId> TypeDecl::type_id() const {
+  return child<TypeId>();
+}
+
+inline std::optional<TypeMod> TypeDecl::type_mod() const {
+  return child<TypeMod>();
+}
+
+inline std::optional<TypeParams> TypeDecl::type_params() const {
+  return child<TypeParams>();
+}
+
+inline std::optional<VarId> TypeDecl::var_id() const {
+  return child<VarId>();
+}
+
+inline std::optional<Commas> TypeId::commas() const {
+  return child<Commas>();
+}
+
+inline std::optional<VarId> TypeId::var_id() const {
+  return child<VarId>();
+}
+
+inline std::optional<StructMod> TypeMod::struct_mod() const {
+  return child<StructMod>();
+}
+
+inline std::optional<TBinders> TypeParams::t_binders() const {
+  return child<TBinders>();
+}
+
+inline std::optional<Qualifier> TypeScheme::qualifier() const {
+  return child<Qualifier>();
+}
+
+inline std::optional<SomeForalls> TypeScheme::some_foralls() const {
+  return child<SomeForalls>();
+}
+
+inline std::optional<TArrow> TypeScheme::t_arrow() const {
+  return child<TArrow>();
+}
+
+inline std::optional<APattern> ValExpr::a_pattern() const {
+  return child<APattern>();
+}
+
+inline std::optional<BlockExpr> ValExpr::block_expr() const {
+  return child<BlockExpr>();
+}
+
+inline std::optional<Expr> ValExpr::expr() const {
+  return child<Expr>();
+}
+
+inline std::optional<Id> VarId::id() const {
+  return child<Id>();
+}
+
+inline std::optional<AnnType> WithEff::ann_type() const {
+  return child<AnnType>();
+}
+
+inline std::optional<BlockExpr> WithExpr::block_expr() const {
+  return child<BlockExpr>();
+}
+
+inline std::optional<WithStat> WithExpr::with_stat() const {
+  return child<WithStat>();
+}
+
+inline std::optional<BasicExpr> WithStat::basic_expr() const {
+  return child<BasicExpr>();
+}
+
+inline std::optional<Binder> WithStat::binder() const {
+  return child<Binder>();
+}
+
+inline std::optional<OpClause> WithStat::op_clause() const {
+  return child<OpClause>();
+}
+
+inline std::optional<WithEff> WithStat::with_eff() const {
+  return child<WithEff>();
+}
+
+// What a visitor's enter method can return to direct a walk. Returning void is
+// the same as returning Continue.
+enum class Walk { Continue, SkipChildren, Stop };
+
+namespace detail {
+
+template <typename V, typename T, typename = void>
+struct has_enter : std::false_type {};
+template <typename V, typename T>
+struct has_enter<V, T,
+                 std::void_t<decltype(std::declval<V &>().enter(
+                     std::declval<const T &>()))>> : std::true_type {};
+
+template <typename V, typename T, typename = void>
+struct has_leave : std::false_type {};
+template <typename V, typename T>
+struct has_leave<V, T,
+                 std::void_t<decltype(std::declval<V &>().leave(
+                     std::declval<const T &>()))>> : std::true_type {};
+
+struct Enter {};
+struct Leave {};
+
+template <typename T, typename V> Walk call(V &visitor, Enter, TSNode node) {
+  if constexpr (has_enter<V, T>::value) {
+    using Result = decltype(visitor.enter(std::declval<const T &>()));
+    if constexpr (std::is_void_v<Result>) {
+      visitor.enter(T(node));
+      return Walk::Continue;
+    } else {
+      return visitor.enter(T(node));
+    }
+  } else {
+    return Walk::Continue;
+  }
+}
+
+template <typename T, typename V> Walk call(V &visitor, Leave, TSNode node) {
+  if constexpr (has_leave<V, T>::value) {
+    visitor.leave(T(node));
+  }
+  return Walk::Continue;
+}
+
+// Calls the overload of visitor.enter or visitor.leave for the node's type,
+// falling back to one that takes a Node.
+template <typename Event, typename V> Walk dispatch(V &visitor, TSNode node) {
+  switch (ts_node_symbol(node)) {
+  case sym::aexpr:
+    return call<AExpr>(visitor, Event(), node);
+  case sym::aexprs:
+    return call<AExprs>(visitor, Event(), node);
+  case sym::aliasdecl:
+    return call<AliasDecl>(visitor, Event(), node);
+  case sym::annot:
+    return call<Annot>(visitor, Event(), node);
+  case sym::annotres:
+    return call<AnnotRes>(visitor, Event(), node);
+  case sym::anntype:
+    return call<AnnType>(visitor, Event(), node);
+  case sym::apattern:
+    return call<APattern>(visitor, Event(), node);
+  case sym::apatterns:
+    return call<APatterns>(visitor, Event(), node);
+  case sym::appexpr:
+    return call<AppExpr>(visitor, Event(), node);
+  case sym::argument:
+    return call<Argument>(visitor, Event(), node);
+  case sym::arguments:
+    return call<Arguments>(visitor, Event(), node);
+  case sym::atom:
+    return call<Atom>(visitor, Event(), node);
+  case sym::basicexpr:
+    return call<BasicExpr>(visitor, Event(), node);
+  case sym::binder:
+    return call<Binder>(visitor, Event(), node);
+  case sym::block:
+    return call<Block>(visitor, Event(), node);
+  case sym::blockcomment:
+    return call<BlockComment>(visitor, Event(), node);
+  case sym::blockexpr:
+    return call<BlockExpr>(visitor, Event(), node);
+  case sym::bodyexpr:
+    return call<BodyExpr>(visitor, Event(), node);
+  case sym::cexprs:
+    return call<CExprs>(visitor, Event(), node);
+  case sym::char_:
+    return call<Char>(visitor, Event(), node);
+  case sym::commas:
+    return call<Commas>(visitor, Event(), node);
+  case sym::conparams:
+    return call<ConParams>(visitor, Event(), node);
+  case sym::constructor:
+    return call<Constructor>(visitor, Event(), node);
+  case sym::constructors:
+    return call<Constructors>(visitor, Event(), node);
+  case sym::controlmod:
+    return call<ControlMod>(visitor, Event(), node);
+  case sym::decl:
+    return call<Decl>(visitor, Event(), node);
+  case sym::effectmod:
+    return call<EffectMod>(visitor, Event(), node);
+  case sym::elifs:
+    return call<Elifs>(visitor, Event(), node);
+  case sym::expr:
+    return call<Expr>(visitor, Event(), node);
+  case sym::externbody:
+    return call<ExternBody>(visitor, Event(), node);
+  case sym::externdecl:
+    return call<ExternDecl>(visitor, Event(), node);
+  case sym::externimp:
+    return call<ExternImp>(visitor, Event(), node);
+  case sym::externimpbody:
+    return call<ExternImpBody>(visitor, Event(), node);
+  case sym::externstat:
+    return call<ExternStat>(visitor, Event(), node);
+  case sym::externtarget:
+    return call<ExternTarget>(visitor, Event(), node);
+  case sym::externtype:
+    return call<ExternType>(visitor, Event(), node);
+  case sym::externval:
+    return call<ExternVal>(visitor, Event(), node);
+  case sym::fipalloc:
+    return call<FipAlloc>(visitor, Event(), node);
+  case sym::fipmod:
+    return call<FipMod>(visitor, Event(), node);
+  case sym::fixity:
+    return call<Fixity>(visitor, Event(), node);
+  case sym::fixitydecl:
+    return call<FixityDecl>(visitor, Event(), node);
+  case sym::float_:
+    return call<Float>(visitor, Event(), node);
+  case sym::fnexpr:
+    return call<FnExpr>(visitor, Event(), node);
+  case sym::funbody:
+    return call<FunBody>(visitor, Event(), node);
+  case sym::fundecl:
+    return call<FunDecl>(visitor, Event(), node);
+  case sym::funid:
+    return call<FunId>(visitor, Event(), node);
+  case sym::handlerexpr:
+    return call<HandlerExpr>(visitor, Event(), node);
+  case sym::identifier:
+    return call<Identifier>(visitor, Event(), node);
+  case sym::idop:
+    return call<IdOp>(visitor, Event(), node);
+  case sym::ifexpr:
+    return call<IfExpr>(visitor, Event(), node);
+  case sym::importdecl:
+    return call<ImportDecl>(visitor, Event(), node);
+  case sym::int_:
+    return call<Int>(visitor, Event(), node);
+  case sym::kannot:
+    return call<KAnnot>(visitor, Event(), node);
+  case sym::katom:
+    return call<KAtom>(visitor, Event(), node);
+  case sym::kind:
+    return call<Kind>(visitor, Event(), node);
+  case sym::kinds:
+    return call<Kinds>(visitor, Event(), node);
+  case sym::literal:
+    return call<Literal>(visitor, Event(), node);
+  case sym::mask:
+    return call<Mask>(visitor, Event(), node);
+  case sym::matchexpr:
+    return call<MatchExpr>(visitor, Event(), node);
+  case sym::matchrule:
+    return call<MatchRule>(visitor, Event(), node);
+  case sym::matchrules:
+    return call<MatchRules>(visitor, Event(), node);
+  case sym::modulebody:
+    return call<ModuleBody>(visitor, Event(), node);
+  case sym::moduledecl:
+    return call<ModuleDecl>(visitor, Event(), node);
+  case sym::modulepath:
+    return call<ModulePath>(visitor, Event(), node);
+  case sym::op:
+    return call<Op>(visitor, Event(), node);
+  case sym::opclause:
+    return call<OpClause>(visitor, Event(), node);
+  case sym::opclauses:
+    return call<OpClauses>(visitor, Event(), node);
+  case sym::opclausex:
+    return call<OpClauseX>(visitor, Event(), node);
+  case sym::opdecls:
+    return call<OpDecls>(visitor, Event(), node);
+  case sym::operation:
+    return call<Operation>(visitor, Event(), node);
+  case sym::operations:
+    return call<Operations>(visitor, Event(), node);
+  case sym::opexpr:
+    return call<OpExpr>(visitor, Event(), node);
+  case sym::oplist:
+    return call<OpList>(visitor, Event(), node);
+  case sym::opparam:
+    return call<OpParam>(visitor, Event(), node);
+  case sym::opparams:
+    return call<OpParams>(visitor, Event(), node);
+  case sym::parameter:
+    return call<Parameter>(visitor, Event(), node);
+  case sym::parameters:
+    return call<Parameters>(visitor, Event(), node);
+  case sym::paramid:
+    return call<ParamId>(visitor, Event(), node);
+  case sym::patarg:
+    return call<PatArg>(visitor, Event(), node);
+  case sym::patargs:
+    return call<PatArgs>(visitor, Event(), node);
+  case sym::pattern:
+    return call<Pattern>(visitor, Event(), node);
+  case sym::patterns:
+    return call<Patterns>(visitor, Event(), node);
+  case sym::pparameter:
+    return call<PParameter>(visitor, Event(), node);
+  case sym::pparameters:
+    return call<PParameters>(visitor, Event(), node);
+  case sym::predicate:
+    return call<Predicate>(visitor, Event(), node);
+  case sym::predicates:
+    return call<Predicates>(visitor, Event(), node);
+  case sym::prefixexpr:
+    return call<PrefixExpr>(visitor, Event(), node);
+  case sym::program:
+    return call<Program>(visitor, Event(), node);
+  case sym::puredecl:
+    return call<PureDecl>(visitor, Event(), node);
+  case sym::qconstructor:
+    return call<QConstructor>(visitor, Event(), node);
+  case sym::qidentifier:
+    return call<QIdentifier>(visitor, Event(), node);
+  case sym::qoperator:
+    return call<QOperator>(visitor, Event(), node);
+  case sym::qualifier:
+    return call<Qualifier>(visitor, Event(), node);
+  case sym::qvarid:
+    return call<QVarId>(visitor, Event(), node);
+  case sym::returnexpr:
+    return call<ReturnExpr>(visitor, Event(), node);
+  case sym::sconparams:
+    return call<SConParams>(visitor, Event(), node);
+  case sym::someforalls:
+    return call<SomeForalls>(visitor, Event(), node);
+  case sym::statement:
+    return call<Statement>(visitor, Event(), node);
+  case sym::statements:
+    return call<Statements>(visitor, Event(), node);
+  case sym::string:
+    return call<String>(visitor, Event(), node);
+  case sym::structmod:
+    return call<StructMod>(visitor, Event(), node);
+  case sym::targuments:
+    return call<TArguments>(visitor, Event(), node);
+  case sym::tarrow:
+    return call<TArrow>(visitor, Event(), node);
+  case sym::tatomic:
+    return call<TAtomic>(visitor, Event(), node);
+  case sym::tbasic:
+    return call<TBasic>(visitor, Event(), node);
+  case sym::tbinder:
+    return call<TBinder>(visitor, Event(), node);
+  case sym::tbinders:
+    return call<TBinders>(visitor, Event(), node);
+  case sym::topdecl:
+    return call<TopDecl>(visitor, Event(), node);
+  case sym::tparam:
+    return call<TParam>(visitor, Event(), node);
+  case sym::tparams:
+    return call<TParams>(visitor, Event(), node);
+  case sym::tresult:
+    return call<TResult>(visitor, Event(), node);
+  case sym::type:
+    return call<Type>(visitor, Event(), node);
+  case sym::typeapp:
+    return call<TypeApp>(visitor, Event(), node);
+  case sym::typebody:
+    return call<TypeBody>(visitor, Event(), node);
+  case sym::typecon:
+    return call<TypeCon>(visitor, Event(), node);
+  case sym::typedecl:
+    return call<TypeDecl>(visitor, Event(), node);
+  case sym::typeid_:
+    return call<TypeId>(visitor, Event(), node);
+  case sym::typemod:
+    return call<TypeMod>(visitor, Event(), node);
+  case sym::typeparams:
+    return call<TypeParams>(visitor, Event(), node);
+  case sym::typescheme:
+    return call<TypeScheme>(visitor, Event(), node);
+  case sym::valexpr:
+    return call<ValExpr>(visitor, Event(), node);
+  case sym::varid:
+    return call<VarId>(visitor, Event(), node);
+  case sym::witheff:
+    return call<WithEff>(visitor, Event(), node);
+  case sym::withexpr:
+    return call<WithExpr>(visitor, Event(), node);
+  case sym::withstat:
+    return call<WithStat>(visitor, Event(), node);
+  case sym::borrow:
+    return call<Borrow>(visitor, Event(), node);
+  case sym::conid:
+    return call<ConId>(visitor, Event(), node);
+  case sym::escape:
+    return call<Escape>(visitor, Event(), node);
+  case sym::id:
+    return call<Id>(visitor, Event(), node);
+  case sym::linecomment:
+    return call<LineComment>(visitor, Event(), node);
+  case sym::qconid:
+    return call<QConId>(visitor, Event(), node);
+  case sym::qid:
+    return call<QId>(visitor, Event(), node);
+  case sym::qidop:
+    return call<QIdOp>(visitor, Event(), node);
+  case sym::wildcard:
+    return call<Wildcard>(visitor, Event(), node);
+  default:
+    return call<Node>(visitor, Event(), node);
+  }
+}
+
+} // namespace detail
+
+// Walks trees in document order, calling the enter and leave methods of a
+// visitor for each node. A visitor declares an overload of enter and leave for
+// each node type it's interested in, such as enter(const MatchExpr &), and may
+// declare overloads that take a Node to see every other node, including
+// anonymous ones. Overloads are picked at compile time, so nodes of other
+// types cost a switch and nothing more.
+//
+// A walker keeps one TSTreeCursor, which allocates when the walker is created
+// and is reused by every walk, so walks don't allocate.
+class Walker {
+public:
+  explicit Walker(TSNode root) : cursor_(ts_tree_cursor_new(root)) {}
+  ~Walker() { ts_tree_cursor_delete(&cursor_); }
+  Walker(const Walker &) = delete;
+  Walker &operator=(const Walker &) = delete;
+
+  // Walks the subtree rooted at root, which needn't be from the same tree as
+  // the node the walker was created with. leave is called for every node that
+  // enter was called for, unless the walk is stopped.
+  template <typename V> void walk(TSNode root, V &visitor) {
+    ts_tree_cursor_reset(&cursor_, root);
+    while (true) {
+      TSNode node = ts_tree_cursor_current_node(&cursor_);
+      Walk walk = detail::dispatch<detail::Enter>(visitor, node);
+      if (walk == Walk::Stop) {
+        return;
+      }
+      if (walk == Walk::Continue && ts_tree_cursor_goto_first_child(&cursor_)) {
+        continue;
+      }
+      detail::dispatch<detail::Leave>(visitor, node);
+      while (!ts_tree_cursor_goto_next_sibling(&cursor_)) {
+        if (!ts_tree_cursor_goto_parent(&cursor_)) {
+          return;
+        }
+        detail::dispatch<detail::Leave>(visitor,
+                                        ts_tree_cursor_current_node(&cursor_));
+      }
+    }
+  }
+
+private:
+  TSTreeCursor cursor_;
+};
+
+// Walks the subtree rooted at root with a new Walker.
+template <typename V> void walk(TSNode root, V &visitor) {
+  Walker(root).walk(root, visitor);
+}
+
+} // namespace tree_sitter::koka
+
+#endif // TREE_SITTER_KOKA_HPP_
@@ -4,6 +4,14 @@ typedef struct TSLanguage TSLanguage;
 
 extern "C" TSLanguage *tree_sitter_koka();
 
+extern "C" const char *tree_sitter_koka_folds_query();
+extern "C" const char *tree_sitter_koka_highlights_query();
+extern "C" const char *tree_sitter_koka_indents_query();
+extern "C" const char *tree_sitter_koka_injections_query();
+extern "C" const char *tree_sitter_koka_locals_query();
+extern "C" const char *tree_sitter_koka_textobjects_query();
+extern "C" const char *tree_sitter_koka_node_types();
+
 // "tree-sitter", "language" hashed with BLAKE2
 const napi_type_tag LANGUAGE_TYPE_TAG = {
     0x8AF2E5212AD58ABF, 0xD5006CAD83ABBA16
@@ -14,6 +22,16 @@ Napi::Object Init(Napi::Env env, Napi::Object exports) {
     auto language = Napi::External<TSLanguage>::New(env, tree_sitter_koka());
     language.TypeTag(&LANGUAGE_TYPE_TAG);
     exports["language"] = language;
+
+    auto queries = Napi::Object::New(env);
+    queries["folds"] = Napi::String::New(env, tree_sitter_koka_folds_query());
+    queries["highlights"] = Napi::String::New(env, tree_sitter_koka_highlights_query());
+    queries["indents"] = Napi::String::New(env, tree_sitter_koka_indents_query());
+    queries["injections"] = Napi::String::New(env, tree_sitter_koka_injections_query());
+    queries["locals"] = Napi::String::New(env, tree_sitter_koka_locals_query());
+    queries["textobjects"] = Napi::String::New(env, tree_sitter_koka_textobjects_query());
+    exports["queries"] = queries;
+    exports["nodeTypes"] = Napi::String::New(env, tree_sitter_koka_node_types());
     return exports;
 }
 
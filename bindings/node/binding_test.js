@@ -7,3 +7,16 @@ test("can load grammar", () => {
   const parser = new Parser();
   assert.doesNotThrow(() => parser.setLanguage(require(".")));
 });
+
+test("has embedded queries", () => {
+  const language = require(".");
+  for (const name of ["folds", "highlights", "indents", "injections", "locals", "textobjects"]) {
+    assert.ok(language.queries[name].length > 0);
+  }
+  assert.ok(Array.isArray(language.nodeTypeInfo));
+});
+
+test("caches compiled queries", () => {
+  const language = require(".");
+  assert.strictEqual(language.query("highlights"), language.query("highlights"));
+});
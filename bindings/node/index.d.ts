@@ -18,10 +18,21 @@ type NodeInfo =
       children: ChildNode[];
     });
 
+type Queries = {
+  folds: string;
+  highlights: string;
+  indents: string;
+  injections: string;
+  locals: string;
+  textobjects: string;
+};
+
 type Language = {
   name: string;
   language: unknown;
   nodeTypeInfo: NodeInfo[];
+  queries: Queries;
+  query(name: keyof Queries): unknown;
 };
 
 declare const language: Language;
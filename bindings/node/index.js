@@ -6,6 +6,31 @@ module.exports =
     ? require(`../../prebuilds/${process.platform}-${process.arch}/tree-sitter-koka.node`)
     : require("node-gyp-build")(root);
 
-try {
-  module.exports.nodeTypeInfo = require("../../src/node-types.json");
-} catch (_) {}
+// The node types are embedded in the native module, so there's no need to read
+// src/node-types.json from disk.
+module.exports.nodeTypeInfo = JSON.parse(module.exports.nodeTypes);
+delete module.exports.nodeTypes;
+
+const compiledQueries = new Map();
+
+/**
+ * Get the compiled bundled query with the given name, e.g. "highlights".
+ *
+ * Each query is compiled the first time it's requested and then shared by
+ * every parser in this isolate. This requires the `tree-sitter` package.
+ *
+ * @param {string} name
+ */
+module.exports.query = function query(name) {
+  let compiled = compiledQueries.get(name);
+  if (compiled === undefined) {
+    const source = module.exports.queries[name];
+    if (source === undefined) {
+      throw new Error(`unknown query: ${name}`);
+    }
+    const { Query } = require("tree-sitter");
+    compiled = new Query(module.exports, source);
+    compiledQueries.set(name, compiled);
+  }
+  return compiled;
+};
@@ -9,3 +9,21 @@ class TestLanguage(TestCase):
             tree_sitter.Language(tree_sitter_koka.language())
         except Exception:
             self.fail("Error loading Koka grammar")
+
+    def test_embedded_queries(self):
+        language = tree_sitter.Language(tree_sitter_koka.language())
+        for source in (
+            tree_sitter_koka.FOLDS_QUERY,
+            tree_sitter_koka.HIGHLIGHTS_QUERY,
+            tree_sitter_koka.INDENTS_QUERY,
+            tree_sitter_koka.INJECTIONS_QUERY,
+            tree_sitter_koka.LOCALS_QUERY,
+            tree_sitter_koka.TEXTOBJECTS_QUERY,
+        ):
+            language.query(source)
+
+    def test_query_cache(self):
+        self.assertIs(
+            tree_sitter_koka.query("highlights"),
+            tree_sitter_koka.query("highlights"),
+        )
@@ -1,37 +1,76 @@
 """Koka grammar for tree-sitter"""
 
-from importlib.resources import files as _files
+from threading import Lock as _Lock
 
+from . import _binding
 from ._binding import language
 
+_QUERY_SOURCES = {
+    "folds": _binding.folds_query,
+    "highlights": _binding.highlights_query,
+    "indents": _binding.indents_query,
+    "injections": _binding.injections_query,
+    "locals": _binding.locals_query,
+    "textobjects": _binding.textobjects_query,
+}
 
-def _get_query(name, file):
-    query = _files(f"{__package__}.queries") / file
-    globals()[name] = query.read_text()
+_compiled_queries = {}
+_compiled_queries_lock = _Lock()
+
+
+def query(name):
+    """Get the compiled bundled query with the given name, e.g. "highlights".
+
+    Each query is compiled the first time it's requested and then shared by
+    every caller in the process. This requires the ``tree-sitter`` package.
+    """
+    compiled = _compiled_queries.get(name)
+    if compiled is not None:
+        return compiled
+
+    with _compiled_queries_lock:
+        compiled = _compiled_queries.get(name)
+        if compiled is None:
+            from tree_sitter import Language, Query
+
+            compiled = Query(Language(language()), _QUERY_SOURCES[name]())
+            _compiled_queries[name] = compiled
+        return compiled
+
+
+def _get_query(name, getter):
+    # The query sources are embedded in the extension module, so this doesn't
+    # touch the filesystem.
+    globals()[name] = getter()
     return globals()[name]
 
 
 def __getattr__(name):
-    # NOTE: uncomment these to include any queries that this grammar contains:
-
-    # if name == "HIGHLIGHTS_QUERY":
-    #     return _get_query("HIGHLIGHTS_QUERY", "highlights.scm")
-    # if name == "INJECTIONS_QUERY":
-    #     return _get_query("INJECTIONS_QUERY", "injections.scm")
-    # if name == "LOCALS_QUERY":
-    #     return _get_query("LOCALS_QUERY", "locals.scm")
-    # if name == "TAGS_QUERY":
-    #     return _get_query("TAGS_QUERY", "tags.scm")
+    if name == "FOLDS_QUERY":
+        return _get_query("FOLDS_QUERY", _binding.folds_query)
+    if name == "HIGHLIGHTS_QUERY":
+        return _get_query("HIGHLIGHTS_QUERY", _binding.highlights_query)
+    if name == "INDENTS_QUERY":
+        return _get_query("INDENTS_QUERY", _binding.indents_query)
+    if name == "INJECTIONS_QUERY":
+        return _get_query("INJECTIONS_QUERY", _binding.injections_query)
+    if name == "LOCALS_QUERY":
+        return _get_query("LOCALS_QUERY", _binding.locals_query)
+    if name == "TEXTOBJECTS_QUERY":
+        return _get_query("TEXTOBJECTS_QUERY", _binding.textobjects_query)
 
     raise AttributeError(f"module {__name__!r} has no attribute {name!r}")
 
 
 __all__ = [
     "language",
-    # "HIGHLIGHTS_QUERY",
-    # "INJECTIONS_QUERY",
-    # "LOCALS_QUERY",
-    # "TAGS_QUERY",
+    "query",
+    "FOLDS_QUERY",
+    "HIGHLIGHTS_QUERY",
+    "INDENTS_QUERY",
+    "INJECTIONS_QUERY",
+    "LOCALS_QUERY",
+    "TEXTOBJECTS_QUERY",
 ]
 
 
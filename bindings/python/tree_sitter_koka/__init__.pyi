@@ -1,10 +1,14 @@
-from typing import Final
+from typing import Final, Literal
 
-# NOTE: uncomment these to include any queries that this grammar contains:
+from tree_sitter import Query
 
-# HIGHLIGHTS_QUERY: Final[str]
-# INJECTIONS_QUERY: Final[str]
-# LOCALS_QUERY: Final[str]
-# TAGS_QUERY: Final[str]
+FOLDS_QUERY: Final[str]
+HIGHLIGHTS_QUERY: Final[str]
+INDENTS_QUERY: Final[str]
+INJECTIONS_QUERY: Final[str]
+LOCALS_QUERY: Final[str]
+TEXTOBJECTS_QUERY: Final[str]
 
 def language() -> object: ...
+
+def query(name: Literal["folds", "highlights", "indents", "injections", "locals", "textobjects"]) -> Query: ...
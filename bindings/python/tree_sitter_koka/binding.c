@@ -4,13 +4,56 @@ typedef struct TSLanguage TSLanguage;
 
 TSLanguage *tree_sitter_koka(void);
 
+const char *tree_sitter_koka_folds_query(void);
+const char *tree_sitter_koka_highlights_query(void);
+const char *tree_sitter_koka_indents_query(void);
+const char *tree_sitter_koka_injections_query(void);
+const char *tree_sitter_koka_locals_query(void);
+const char *tree_sitter_koka_textobjects_query(void);
+
 static PyObject* _binding_language(PyObject *Py_UNUSED(self), PyObject *Py_UNUSED(args)) {
     return PyCapsule_New(tree_sitter_koka(), "tree_sitter.Language", NULL);
 }
 
+static PyObject* _binding_folds_query(PyObject *Py_UNUSED(self), PyObject *Py_UNUSED(args)) {
+    return PyUnicode_FromString(tree_sitter_koka_folds_query());
+}
+
+static PyObject* _binding_highlights_query(PyObject *Py_UNUSED(self), PyObject *Py_UNUSED(args)) {
+    return PyUnicode_FromString(tree_sitter_koka_highlights_query());
+}
+
+static PyObject* _binding_indents_query(PyObject *Py_UNUSED(self), PyObject *Py_UNUSED(args)) {
+    return PyUnicode_FromString(tree_sitter_koka_indents_query());
+}
+
+static PyObject* _binding_injections_query(PyObject *Py_UNUSED(self), PyObject *Py_UNUSED(args)) {
+    return PyUnicode_FromString(tree_sitter_koka_injections_query());
+}
+
+static PyObject* _binding_locals_query(PyObject *Py_UNUSED(self), PyObject *Py_UNUSED(args)) {
+    return PyUnicode_FromString(tree_sitter_koka_locals_query());
+}
+
+static PyObject* _binding_textobjects_query(PyObject *Py_UNUSED(self), PyObject *Py_UNUSED(args)) {
+    return PyUnicode_FromString(tree_sitter_koka_textobjects_query());
+}
+
 static PyMethodDef methods[] = {
     {"language", _binding_language, METH_NOARGS,
      "Get the tree-sitter language for this grammar."},
+    {"folds_query", _binding_folds_query, METH_NOARGS,
+     "Get the source of the folds query."},
+    {"highlights_query", _binding_highlights_query, METH_NOARGS,
+     "Get the source of the highlights query."},
+    {"indents_query", _binding_indents_query, METH_NOARGS,
+     "Get the source of the indents query."},
+    {"injections_query", _binding_injections_query, METH_NOARGS,
+     "Get the source of the injections query."},
+    {"locals_query", _binding_locals_query, METH_NOARGS,
+     "Get the source of the locals query."},
+    {"textobjects_query", _binding_textobjects_query, METH_NOARGS,
+     "Get the source of the textobjects query."},
     {NULL, NULL, 0, NULL}
 };
 
@@ -0,0 +1,67 @@
+//! Startup benchmark for the compiled query cache.
+//!
+//! Compares compiling the bundled queries from source for every request, which
+//! is what a worker without the cache does, with fetching them from
+//! [`tree_sitter_koka::queries`].
+//!
+//! Run with `cargo bench --features query-cache`.
+
+use std::time::{Duration, Instant};
+
+use tree_sitter::Query;
+
+const REQUESTS: u32 = 200;
+
+fn report(name: &str, elapsed: Duration, iterations: u32) {
+    println!(
+        "{name:<32} {:>10.3} us/request",
+        elapsed.as_secs_f64() * 1e6 / f64::from(iterations)
+    );
+}
+
+fn main() {
+    let language = tree_sitter_koka::LANGUAGE.into();
+    let sources = [
+        tree_sitter_koka::HIGHLIGHTS_QUERY,
+        tree_sitter_koka::INDENTS_QUERY,
+        tree_sitter_koka::LOCALS_QUERY,
+    ];
+
+    let start = Instant::now();
+    for _ in 0..REQUESTS {
+        for source in sources {
+            std::hint::black_box(Query::new(&language, source).unwrap());
+        }
+    }
+    report("compile per request", start.elapsed(), REQUESTS);
+
+    let start = Instant::now();
+    std::hint::black_box(tree_sitter_koka::queries::highlights());
+    std::hint::black_box(tree_sitter_koka::queries::indents());
+    std::hint::black_box(tree_sitter_koka::queries::locals());
+    report("cache, first request", start.elapsed(), 1);
+
+    let start = Instant::now();
+    for _ in 0..REQUESTS {
+        std::hint::black_box(tree_sitter_koka::queries::highlights());
+        std::hint::black_box(tree_sitter_koka::queries::indents());
+        std::hint::black_box(tree_sitter_koka::queries::locals());
+    }
+    report("cache, later requests", start.elapsed(), REQUESTS);
+
+    let threads = 8;
+    let start = Instant::now();
+    let handles: Vec<_> = (0..threads)
+        .map(|_| {
+            std::thread::spawn(|| {
+                for _ in 0..REQUESTS {
+                    std::hint::black_box(tree_sitter_koka::queries::highlights());
+                }
+            })
+        })
+        .collect();
+    for handle in handles {
+        handle.join().unwrap();
+    }
+    report("cache, 8 threads", start.elapsed(), REQUESTS * threads);
+}
@@ -34,12 +34,79 @@ pub const LANGUAGE: LanguageFn = unsafe { LanguageFn::from_raw(tree_sitter_koka)
 /// [`node-types.json`]: https://tree-sitter.github.io/tree-sitter/using-parsers#static-node-types
 pub const NODE_TYPES: &str = include_str!("../../src/node-types.json");
 
-// NOTE: uncomment these to include any queries that this grammar contains:
+/// The code folding query for this language.
+pub const FOLDS_QUERY: &str = include_str!("../../queries/folds.scm");
 
-// pub const HIGHLIGHTS_QUERY: &str = include_str!("../../queries/highlights.scm");
-// pub const INJECTIONS_QUERY: &str = include_str!("../../queries/injections.scm");
-// pub const LOCALS_QUERY: &str = include_str!("../../queries/locals.scm");
-// pub const TAGS_QUERY: &str = include_str!("../../queries/tags.scm");
+/// The syntax highlighting query for this language.
+pub const HIGHLIGHTS_QUERY: &str = include_str!("../../queries/highlights.scm");
+
+/// The indentation query for this language.
+pub const INDENTS_QUERY: &str = include_str!("../../queries/indents.scm");
+
+/// The language injection query for this language.
+pub const INJECTIONS_QUERY: &str = include_str!("../../queries/injections.scm");
+
+/// The local-variable syntax highlighting query for this language.
+pub const LOCALS_QUERY: &str = include_str!("../../queries/locals.scm");
+
+/// The textobjects query for this language.
+pub const TEXTOBJECTS_QUERY: &str = include_str!("../../queries/textobjects.scm");
+
+/// Compiled copies of the bundled queries, shared by every parser and thread
+/// in the process.
+///
+/// Each query is compiled with [`Query::new`][Query::new] the first time it's
+/// requested, so processes that never use a query don't pay for compiling it.
+///
+/// [Query::new]: https://docs.rs/tree-sitter/*/tree_sitter/struct.Query.html#method.new
+#[cfg(feature = "query-cache")]
+pub mod queries {
+    use std::sync::OnceLock;
+
+    use tree_sitter::Query;
+
+    fn compile(cell: &'static OnceLock<Query>, source: &str) -> &'static Query {
+        cell.get_or_init(|| {
+            Query::new(&super::LANGUAGE.into(), source).expect("Error compiling bundled query")
+        })
+    }
+
+    /// The compiled [`FOLDS_QUERY`][super::FOLDS_QUERY].
+    pub fn folds() -> &'static Query {
+        static QUERY: OnceLock<Query> = OnceLock::new();
+        compile(&QUERY, super::FOLDS_QUERY)
+    }
+
+    /// The compiled [`HIGHLIGHTS_QUERY`][super::HIGHLIGHTS_QUERY].
+    pub fn highlights() -> &'static Query {
+        static QUERY: OnceLock<Query> = OnceLock::new();
+        compile(&QUERY, super::HIGHLIGHTS_QUERY)
+    }
+
+    /// The compiled [`INDENTS_QUERY`][super::INDENTS_QUERY].
+    pub fn indents() -> &'static Query {
+        static QUERY: OnceLock<Query> = OnceLock::new();
+        compile(&QUERY, super::INDENTS_QUERY)
+    }
+
+    /// The compiled [`INJECTIONS_QUERY`][super::INJECTIONS_QUERY].
+    pub fn injections() -> &'static Query {
+        static QUERY: OnceLock<Query> = OnceLock::new();
+        compile(&QUERY, super::INJECTIONS_QUERY)
+    }
+
+    /// The compiled [`LOCALS_QUERY`][super::LOCALS_QUERY].
+    pub fn locals() -> &'static Query {
+        static QUERY: OnceLock<Query> = OnceLock::new();
+        compile(&QUERY, super::LOCALS_QUERY)
+    }
+
+    /// The compiled [`TEXTOBJECTS_QUERY`][super::TEXTOBJECTS_QUERY].
+    pub fn textobjects() -> &'static Query {
+        static QUERY: OnceLock<Query> = OnceLock::new();
+        compile(&QUERY, super::TEXTOBJECTS_QUERY)
+    }
+}
 
 #[cfg(test)]
 mod tests {
@@ -50,4 +117,31 @@ mod tests {
             .set_language(&super::LANGUAGE.into())
             .expect("Error loading Koka parser");
     }
+
+    #[test]
+    fn test_queries_compile() {
+        let language = super::LANGUAGE.into();
+        for source in [
+            super::FOLDS_QUERY,
+            super::HIGHLIGHTS_QUERY,
+            super::INDENTS_QUERY,
+            super::INJECTIONS_QUERY,
+            super::LOCALS_QUERY,
+            super::TEXTOBJECTS_QUERY,
+        ] {
+            tree_sitter::Query::new(&language, source).expect("Error compiling query");
+        }
+    }
+
+    #[cfg(feature = "query-cache")]
+    #[test]
+    fn test_query_cache_is_shared() {
+        let handles: Vec<_> = (0..4)
+            .map(|_| std::thread::spawn(|| super::queries::highlights() as *const _ as usize))
+            .collect();
+        let first = super::queries::highlights() as *const _ as usize;
+        for handle in handles {
+            assert_eq!(handle.join().unwrap(), first);
+        }
+    }
 }
@@ -0,0 +1,9 @@
+[
+  (block)
+  (funbody)
+  (matchexpr)
+  (handlerexpr)
+  (opdecls)
+  (externbody)
+  (blockcomment)
+] @fold
@@ -1,6 +1,6 @@
 [
-  (appexpr ["[" "("]) ; Applications.
-  (atom ["[" "("]) ; Lists and tuples.
+  (appexpr function: (_) . ["[" "("]) ; Applications.
+  (atom . ["[" "("]) ; Lists and tuples.
   (program (moduledecl "{")) ; Braced module declarations.
   (funbody)
   (block)
@@ -1,2 +1,53 @@
 ([(linecomment) (blockcomment)] @injection.content
  (#set! injection.language "comment"))
+
+; Foreign code in extern declarations. The externtarget names the language:
+; c, js or cs, which editors resolve to C, JavaScript and C# the way they do
+; for the info string of a fenced code block. The offsets trim the delimiters
+; of strings, which differ for each kind of string: "...", r"..." and
+; r#"..."#. Raw strings with more pound signs aren't injected here, though
+; tree_sitter_koka_injections handles them.
+
+(externstat
+  (externtarget) @injection.language
+  (string) @injection.content
+  (#match? @injection.content "^\"")
+  (#offset! @injection.content 0 1 0 -1))
+
+(externstat
+  (externtarget) @injection.language
+  (string) @injection.content
+  (#match? @injection.content "^r\"")
+  (#offset! @injection.content 0 2 0 -1))
+
+(externstat
+  (externtarget) @injection.language
+  (string) @injection.content
+  (#match? @injection.content "^r#\"")
+  (#offset! @injection.content 0 3 0 -2))
+
+; Only inline imports hold code, the others name files.
+
+(externimp
+  (externtarget) @injection.language
+  (varid) @_kind
+  (string) @injection.content
+  (#match? @_kind "inline$")
+  (#match? @injection.content "^\"")
+  (#offset! @injection.content 0 1 0 -1))
+
+(externimp
+  (externtarget) @injection.language
+  (varid) @_kind
+  (string) @injection.content
+  (#match? @_kind "inline$")
+  (#match? @injection.content "^r\"")
+  (#offset! @injection.content 0 2 0 -1))
+
+(externimp
+  (externtarget) @injection.language
+  (varid) @_kind
+  (string) @injection.content
+  (#match? @_kind "inline$")
+  (#match? @injection.content "^r#\"")
+  (#offset! @injection.content 0 3 0 -2))
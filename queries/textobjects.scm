@@ -0,0 +1,60 @@
+; Functions
+
+(puredecl
+  (funbody
+    [(bodyexpr) (block)] @function.inside)) @function.around
+
+(decl
+  (fundecl
+    (funbody
+      [(bodyexpr) (block)] @function.inside))) @function.around
+
+(fnexpr
+  (funbody
+    [(bodyexpr) (block)] @function.inside)) @function.around
+
+(opclause
+  (bodyexpr) @function.inside) @function.around
+
+(operation) @function.around
+
+; Types
+
+(typedecl
+  [(typebody) (conparams) (opdecls) (operation)] @class.inside) @class.around
+
+(aliasdecl
+  (type) @class.inside) @class.around
+
+; Parameters and arguments
+
+(parameters
+  ((parameter) @parameter.inside . ","? @parameter.around) @parameter.around)
+
+(pparameters
+  ((pparameter) @parameter.inside . ","? @parameter.around) @parameter.around)
+
+(opparams
+  ((opparam) @parameter.inside . ","? @parameter.around) @parameter.around)
+
+(tbinders
+  ((tbinder) @parameter.inside . ","? @parameter.around) @parameter.around)
+
+(arguments
+  ((argument) @parameter.inside . ","? @parameter.around) @parameter.around)
+
+; Match rules
+
+(matchrule
+  (blockexpr) @entry.inside) @entry.around
+
+; Comments
+
+[
+  (linecomment)
+  (blockcomment)
+] @comment.inside
+
+(linecomment)+ @comment.around
+
+(blockcomment) @comment.around
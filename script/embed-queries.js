@@ -0,0 +1,86 @@
+#!/usr/bin/env node
+// Generates src/queries.c, which embeds the sources of queries/*.scm and
+// src/node-types.json in the grammar library so consumers don't have to find
+// them on disk at runtime. Run this after changing any of those files.
+
+const fs = require("fs");
+const path = require("path");
+
+const root = path.join(__dirname, "..");
+const queriesDir = path.join(root, "queries");
+
+/**
+ * Renders text as a sequence of C string literals, one per source line.
+ *
+ * @param {string} text
+ *
+ * @return {string}
+ */
+function cString(text) {
+  const lines = text.split(/(?<=\n)/);
+  return lines
+    .map((line) => {
+      let literal = "";
+      for (const byte of Buffer.from(line, "utf8")) {
+        const c = String.fromCharCode(byte);
+        if (c === "\\" || c === '"') {
+          literal += "\\" + c;
+        } else if (c === "\n") {
+          literal += "\\n";
+        } else if (c === "\t") {
+          literal += "\\t";
+        } else if (c === "?") {
+          // Avoid forming trigraphs.
+          literal += "\\?";
+        } else if (byte < 0x20 || byte >= 0x7f) {
+          literal += "\\" + byte.toString(8).padStart(3, "0");
+        } else {
+          literal += c;
+        }
+      }
+      return `    "${literal}"`;
+    })
+    .join("\n");
+}
+
+/**
+ * @param {string} name
+ * @param {string} file
+ *
+ * @return {string}
+ */
+function accessor(name, file) {
+  const text = fs.readFileSync(file, "utf8");
+  return `TS_PUBLIC const char *tree_sitter_koka_${name}(void) {
+  return
+${cString(text)};
+}
+`;
+}
+
+const queries = fs
+  .readdirSync(queriesDir)
+  .filter((file) => file.endsWith(".scm"))
+  .sort();
+
+const accessors = [
+  ...queries.map((file) =>
+    accessor(`${path.basename(file, ".scm")}_query`, path.join(queriesDir, file)),
+  ),
+  accessor("node_types", path.join(root, "src", "node-types.json")),
+];
+
+fs.writeFileSync(
+  path.join(root, "src", "queries.c"),
+  `// Generated by script/embed-queries.js. Do not edit.
+
+#ifdef TREE_SITTER_HIDE_SYMBOLS
+#define TS_PUBLIC
+#elif defined(_WIN32)
+#define TS_PUBLIC __declspec(dllexport)
+#else
+#define TS_PUBLIC __attribute__((visibility("default")))
+#endif
+
+${accessors.join("\n")}`,
+);
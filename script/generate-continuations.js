@@ -0,0 +1,274 @@
+#!/usr/bin/env node
+// Generates src/continuations.h, the tables the external scanner uses to tell
+// whether the first token of a line continues the previous one, from the
+// operators, prefix operators and identifiers of src/grammar.json. Run this
+// after regenerating the grammar.
+
+const fs = require("fs");
+const path = require("path");
+
+const root = path.join(__dirname, "..");
+const grammar = JSON.parse(
+  fs.readFileSync(path.join(root, "src", "grammar.json"), "utf8"),
+);
+
+// Tokens that continue the previous line besides the operators of _symbols.
+const BRACKETS = [")", "]", "{", "}"];
+const WORDS = ["then", "else", "elif"];
+
+// Operators that start a new statement rather than continuing one, in addition
+// to the prefix operators of prefixexpr.
+const STATEMENT_OPERATORS = [">>", ">|<", "<<"];
+
+// The scanner checks these itself after classifying, and expects not to have
+// advanced past them.
+const SCANNER_TOKENS = ["{", "}", ";", "r"];
+
+/**
+ * Returns the characters of the bracket expressions of a pattern, and of its
+ * escaped or plain literal characters if literals is set.
+ *
+ * @param {string} pattern
+ * @param {boolean} literals
+ *
+ * @return {Set<string>}
+ */
+function patternChars(pattern, literals) {
+  const chars = new Set();
+  for (let i = 0; i < pattern.length; i++) {
+    if (pattern[i] !== "[") {
+      if (pattern[i] === "\\") {
+        i++;
+      }
+      if (literals && !"*+?|()".includes(pattern[i])) {
+        chars.add(pattern[i]);
+      }
+      continue;
+    }
+    for (i++; pattern[i] !== "]"; i++) {
+      let c = pattern[i];
+      if (c === "\\") {
+        c = pattern[++i];
+      } else if (pattern[i + 1] === "-" && pattern[i + 2] !== "]") {
+        for (let code = c.charCodeAt(0); code <= pattern.charCodeAt(i + 2); ) {
+          chars.add(String.fromCharCode(code++));
+        }
+        i += 2;
+        continue;
+      }
+      chars.add(c);
+    }
+  }
+  return chars;
+}
+
+/**
+ * @param {string} name
+ * @param {string} type
+ *
+ * @return {any}
+ */
+function rule(name, type) {
+  const rule = grammar.rules[name];
+  if (!rule || rule.type !== type) {
+    throw new Error(`src/grammar.json has no ${type} rule ${name}`);
+  }
+  return rule;
+}
+
+/**
+ * Returns the values of the STRING rules under a rule, and of the anonymous
+ * aliases, which is how the braces of the scanner get theirs.
+ *
+ * @param {any} rule
+ * @param {string[]} values
+ *
+ * @return {string[]}
+ */
+function strings(rule, values = []) {
+  if (rule.type === "STRING" || (rule.type === "ALIAS" && !rule.named)) {
+    values.push(rule.value);
+  }
+  for (const child of rule.members ?? (rule.content ? [rule.content] : [])) {
+    strings(child, values);
+  }
+  return values;
+}
+
+// Operators are runs of these characters. The lone "/" alternative is left
+// out: a line starting with it is lexed as a comment or a new statement.
+const operatorChars = patternChars(rule("_symbols", "PATTERN").value, false);
+const prefixOperators = strings(rule("prefixexpr", "CHOICE").members[0]);
+const identifierChars = patternChars(rule("id", "PATTERN").value, true);
+const tokens = new Set(strings({ members: Object.values(grammar.rules) }));
+
+for (const token of [...BRACKETS, ...WORDS]) {
+  if (!tokens.has(token)) {
+    throw new Error(`src/grammar.json has no "${token}" token`);
+  }
+}
+for (const operator of [...STATEMENT_OPERATORS, ...prefixOperators]) {
+  if (![...operator].every((c) => operatorChars.has(c))) {
+    throw new Error(`"${operator}" isn't an operator of _symbols`);
+  }
+}
+
+const NONE = "CONTINUATION_NONE";
+const START = "CONTINUATION_START";
+const MAYBE = "CONTINUATION_MAYBE";
+const WORD = "CONTINUATION_WORD";
+
+// A trie of the tokens whose first character doesn't decide whether they
+// continue the line. Each node's result is that of the longest of the tokens
+// it's a prefix of, except that the prefixes of words are identifiers.
+const trieRoot = { result: NONE, children: new Map() };
+
+/**
+ * @param {string} token
+ * @param {string} result
+ */
+function insert(token, result) {
+  let node = trieRoot;
+  for (const c of token) {
+    if (!node.children.has(c)) {
+      const inherited =
+        node === trieRoot || node.result === WORD ? NONE : node.result;
+      node.children.set(c, { result: inherited, children: new Map() });
+    }
+    node = node.children.get(c);
+  }
+  node.result = result;
+}
+
+const first = new Array(128).fill(NONE);
+for (const c of operatorChars) {
+  first[c.charCodeAt(0)] = START;
+}
+for (const operator of prefixOperators) {
+  first[operator.charCodeAt(0)] = NONE;
+}
+for (const bracket of BRACKETS) {
+  first[bracket.charCodeAt(0)] = START;
+}
+for (const operator of STATEMENT_OPERATORS) {
+  insert(operator[0], first[operator.charCodeAt(0)]);
+  insert(operator, NONE);
+}
+for (const word of WORDS) {
+  insert(word, WORD);
+}
+for (const c of trieRoot.children.keys()) {
+  if (SCANNER_TOKENS.includes(c)) {
+    throw new Error(`the scanner can't look past "${c}" to classify it`);
+  }
+  first[c.charCodeAt(0)] = MAYBE;
+}
+
+// Numbers the trie's nodes breadth first, so each node's children are
+// consecutive transitions.
+const states = [];
+const transitions = [];
+const queue = [trieRoot];
+while (queue.length > 0) {
+  const node = queue.shift();
+  const children = [...node.children].sort(([a], [b]) => (a < b ? -1 : 1));
+  states.push({
+    result: node.result,
+    first: transitions.length,
+    count: children.length,
+  });
+  for (const [c, child] of children) {
+    transitions.push({ c, state: states.length + queue.length });
+    queue.push(child);
+  }
+}
+if (states.length > 255 || transitions.length > 255) {
+  throw new Error("too many continuation states for uint8_t indices");
+}
+
+/**
+ * @param {string} c
+ *
+ * @return {string}
+ */
+function charLiteral(c) {
+  return c === "\\" || c === "'" ? `'\\${c}'` : `'${c}'`;
+}
+
+/**
+ * Renders a table indexed by ASCII characters, listing only the entries that
+ * aren't the default.
+ *
+ * @param {string[]} entries
+ * @param {string} none
+ *
+ * @return {string}
+ */
+function asciiTable(entries, none) {
+  return entries
+    .map((entry, code) => [String.fromCharCode(code), entry])
+    .filter(([, entry]) => entry !== none)
+    .map(([c, entry]) => `    [${charLiteral(c)}] = ${entry},`)
+    .join("\n");
+}
+
+const identifierTable = new Array(128).fill("false");
+for (const c of identifierChars) {
+  identifierTable[c.charCodeAt(0)] = "true";
+}
+
+fs.writeFileSync(
+  path.join(root, "src", "continuations.h"),
+  `// Generated by script/generate-continuations.js from src/grammar.json. Do not
+// edit.
+
+#ifndef TREE_SITTER_KOKA_CONTINUATIONS_H_
+#define TREE_SITTER_KOKA_CONTINUATIONS_H_
+
+#include <stdbool.h>
+#include <stdint.h>
+
+enum Continuation {
+  ${NONE},
+  ${START},
+  // The first character doesn't decide, so continuation_states does.
+  ${MAYBE},
+  // Starts a continuation if the next character doesn't continue an
+  // identifier.
+  ${WORD},
+};
+
+// Whether a token starting with an ASCII character continues the line.
+static const uint8_t continuation_first_chars[128] = {
+${asciiTable(first, NONE)}
+};
+
+struct continuation_transition {
+  char c;
+  uint8_t state;
+};
+
+struct continuation_state {
+  uint8_t result;
+  uint8_t first_transition;
+  uint8_t transition_count;
+};
+
+// A DFA over the tokens starting with a ${MAYBE} character, run from
+// state 0 on that character. Each state's result applies once it has no
+// transition for the next character.
+static const struct continuation_state continuation_states[${states.length}] = {
+${states.map((s) => `    {${s.result}, ${s.first}, ${s.count}},`).join("\n")}
+};
+
+static const struct continuation_transition continuation_transitions[${transitions.length}] = {
+${transitions.map((t) => `    {${charLiteral(t.c)}, ${t.state}},`).join("\n")}
+};
+
+static const bool continuation_identifier_chars[128] = {
+${asciiTable(identifierTable, "false")}
+};
+
+#endif // TREE_SITTER_KOKA_CONTINUATIONS_H_
+`,
+);
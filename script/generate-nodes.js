@@ -0,0 +1,355 @@
+#!/usr/bin/env node
+// Generates bindings/c/tree-sitter-koka.hpp, a header-only C++17 wrapper with
+// a class for every named node type in src/node-types.json and visitors that
+// dispatch on them. Run this after regenerating the parser, along with
+// script/generate-symbols.js, whose header it builds on.
+
+const fs = require("fs");
+const path = require("path");
+const { identifier } = require("./cpp");
+
+const root = path.join(__dirname, "..");
+const nodeTypes = JSON.parse(
+  fs.readFileSync(path.join(root, "src", "node-types.json"), "utf8"),
+);
+
+// The words node type names are made of, used to turn "matchexpr" into
+// MatchExpr and match_expr. Node types are split into as few words as
+// possible, and single letters are only used when nothing else fits.
+const WORDS = new Set([
+  "alias", "alloc", "ann", "annot", "app", "arg", "args", "argument", "arguments",
+  "arrow", "atom", "atomic", "basic", "binder", "binders", "block", "body",
+  "borrow", "char", "clause", "clauses", "comment", "commas", "con",
+  "constructor", "constructors", "control", "decl", "decls", "eff", "effect",
+  "elifs", "escape", "expr", "exprs", "extern", "fip", "fixity", "float", "fn",
+  "foralls", "fun", "handler", "id", "identifier", "if", "imp", "import",
+  "int", "kind", "kinds", "line", "list", "literal", "mask", "match", "mod",
+  "module", "op", "operation", "operations", "operator", "param", "parameter",
+  "parameters", "params", "pat", "path", "pattern", "patterns", "predicate",
+  "predicates", "prefix", "program", "pure", "qualifier", "res", "result",
+  "return", "rule", "rules", "scheme", "some", "stat", "statement",
+  "statements", "string", "struct", "target", "top", "type", "val", "var",
+  "wildcard", "with",
+]);
+
+/**
+ * Splits a node type name into words.
+ *
+ * @param {string} name
+ *
+ * @return {string[]}
+ */
+function words(name) {
+  // best[i] is the cheapest split of name.slice(0, i).
+  const best = [{ cost: 0, words: [] }];
+  for (let i = 1; i <= name.length; i++) {
+    for (let j = 0; j < i; j++) {
+      const word = name.slice(j, i);
+      const cost = WORDS.has(word) ? 1 : word.length === 1 ? 2 : null;
+      if (!best[j] || cost === null) {
+        continue;
+      }
+      if (!best[i] || best[j].cost + cost < best[i].cost) {
+        best[i] = { cost: best[j].cost + cost, words: [...best[j].words, word] };
+      }
+    }
+  }
+  if (!best[name.length]) {
+    throw new Error(`can't split node type ${name}; add its words to WORDS`);
+  }
+  return best[name.length].words;
+}
+
+/**
+ * @param {string} name
+ *
+ * @return {string}
+ */
+function className(name) {
+  return words(name)
+    .map((word) => word[0].toUpperCase() + word.slice(1))
+    .join("");
+}
+
+/**
+ * @param {string} name
+ *
+ * @return {string}
+ */
+function methodName(name) {
+  return identifier(words(name).join("_"));
+}
+
+const types = nodeTypes.filter((type) => type.named);
+const classes = new Map(types.map((type) => [type.type, className(type.type)]));
+
+/**
+ * Returns the declarations and definitions of the accessors of a node type.
+ *
+ * @param {object} type
+ *
+ * @return {{declarations: string[], definitions: string[]}}
+ */
+function accessors(type) {
+  const name = classes.get(type.type);
+  const declarations = [];
+  const definitions = [];
+
+  for (const [field, info] of Object.entries(type.fields ?? {})) {
+    const named = info.types.filter((child) => child.named);
+    const result =
+      named.length === info.types.length && named.length === 1
+        ? classes.get(named[0].type)
+        : "Node";
+    const method = identifier(field);
+    declarations.push(`  std::optional<${result}> ${method}() const;`);
+    definitions.push(`inline std::optional<${result}> ${name}::${method}() const {
+  return child_by_field<${result}>(field::${identifier(field)});
+}`);
+  }
+
+  const fieldNames = new Set(Object.keys(type.fields ?? {}));
+  for (const child of type.children?.types ?? []) {
+    if (!child.named || fieldNames.has(methodName(child.type))) {
+      continue;
+    }
+    const result = classes.get(child.type);
+    const method = methodName(child.type);
+    declarations.push(`  std::optional<${result}> ${method}() const;`);
+    definitions.push(`inline std::optional<${result}> ${name}::${method}() const {
+  return child<${result}>();
+}`);
+  }
+
+  return { declarations, definitions };
+}
+
+const forwardDeclarations = [];
+const classDefinitions = [];
+const accessorDefinitions = [];
+const cases = [];
+for (const type of types) {
+  const name = classes.get(type.type);
+  const { declarations, definitions } = accessors(type);
+  forwardDeclarations.push(`class ${name};`);
+  classDefinitions.push(`class ${name} : public Node {
+public:
+  static constexpr Symbol type_symbol = sym::${identifier(type.type)};
+
+  using Node::Node;
+${declarations.length > 0 ? "\n" + declarations.join("\n") + "\n" : ""}};`);
+  accessorDefinitions.push(...definitions);
+  cases.push(`  case sym::${identifier(type.type)}:
+    return call<${name}>(visitor, Event(), node);`);
+}
+
+fs.writeFileSync(
+  path.join(root, "bindings", "c", "tree-sitter-koka.hpp"),
+  `// Generated by script/generate-nodes.js from src/node-types.json. Do not
+// edit.
+
+#ifndef TREE_SITTER_KOKA_HPP_
+#define TREE_SITTER_KOKA_HPP_
+
+#include <cstdint>
+#include <optional>
+#include <string_view>
+#include <type_traits>
+#include <utility>
+
+#include <tree_sitter/api.h>
+
+#include "tree-sitter-koka-symbols.hpp"
+#include "tree-sitter-koka.h"
+
+namespace tree_sitter::koka {
+
+inline const TSLanguage *language() { return tree_sitter_koka(); }
+
+// A node of any type. Copying one is as cheap as copying a TSNode.
+class Node {
+public:
+  Node() : node_() {}
+  explicit Node(TSNode node) : node_(node) {}
+
+  TSNode raw() const { return node_; }
+  bool is_null() const { return ts_node_is_null(node_); }
+  bool is_named() const { return ts_node_is_named(node_); }
+  bool has_error() const { return ts_node_has_error(node_); }
+  Symbol symbol() const { return ts_node_symbol(node_); }
+  std::string_view type_name() const { return symbol_name(symbol()); }
+
+  uint32_t start_byte() const { return ts_node_start_byte(node_); }
+  uint32_t end_byte() const { return ts_node_end_byte(node_); }
+  TSPoint start_point() const { return ts_node_start_point(node_); }
+  TSPoint end_point() const { return ts_node_end_point(node_); }
+
+  // The part of the source the tree was parsed from that this node covers.
+  std::string_view text(std::string_view source) const {
+    return source.substr(start_byte(), end_byte() - start_byte());
+  }
+
+  Node parent() const { return Node(ts_node_parent(node_)); }
+
+  template <typename T> bool is() const {
+    return !is_null() && symbol() == T::type_symbol;
+  }
+
+  template <typename T> std::optional<T> as() const {
+    return is<T>() ? std::optional<T>(T(node_)) : std::nullopt;
+  }
+
+  // The first named child of type T.
+  template <typename T> std::optional<T> child() const {
+    for (TSNode child = ts_node_named_child(node_, 0); !ts_node_is_null(child);
+         child = ts_node_next_named_sibling(child)) {
+      if (ts_node_symbol(child) == T::type_symbol) {
+        return T(child);
+      }
+    }
+    return std::nullopt;
+  }
+
+  // Calls f with every named child of type T, in order.
+  template <typename T, typename F> void for_each(F &&f) const {
+    for (TSNode child = ts_node_named_child(node_, 0); !ts_node_is_null(child);
+         child = ts_node_next_named_sibling(child)) {
+      if (ts_node_symbol(child) == T::type_symbol) {
+        f(T(child));
+      }
+    }
+  }
+
+  template <typename T> std::optional<T> child_by_field(FieldId field) const {
+    TSNode child = ts_node_child_by_field_id(node_, field);
+    if (ts_node_is_null(child)) {
+      return std::nullopt;
+    }
+    if constexpr (std::is_same_v<T, Node>) {
+      return Node(child);
+    } else {
+      return Node(child).as<T>();
+    }
+  }
+
+protected:
+  TSNode node_;
+};
+
+${forwardDeclarations.join("\n")}
+
+${classDefinitions.join("\n\n")}
+
+${accessorDefinitions.join("\n\n")}
+
+// What a visitor's enter method can return to direct a walk. Returning void is
+// the same as returning Continue.
+enum class Walk { Continue, SkipChildren, Stop };
+
+namespace detail {
+
+template <typename V, typename T, typename = void>
+struct has_enter : std::false_type {};
+template <typename V, typename T>
+struct has_enter<V, T,
+                 std::void_t<decltype(std::declval<V &>().enter(
+                     std::declval<const T &>()))>> : std::true_type {};
+
+template <typename V, typename T, typename = void>
+struct has_leave : std::false_type {};
+template <typename V, typename T>
+struct has_leave<V, T,
+                 std::void_t<decltype(std::declval<V &>().leave(
+                     std::declval<const T &>()))>> : std::true_type {};
+
+struct Enter {};
+struct Leave {};
+
+template <typename T, typename V> Walk call(V &visitor, Enter, TSNode node) {
+  if constexpr (has_enter<V, T>::value) {
+    using Result = decltype(visitor.enter(std::declval<const T &>()));
+    if constexpr (std::is_void_v<Result>) {
+      visitor.enter(T(node));
+      return Walk::Continue;
+    } else {
+      return visitor.enter(T(node));
+    }
+  } else {
+    return Walk::Continue;
+  }
+}
+
+template <typename T, typename V> Walk call(V &visitor, Leave, TSNode node) {
+  if constexpr (has_leave<V, T>::value) {
+    visitor.leave(T(node));
+  }
+  return Walk::Continue;
+}
+
+// Calls the overload of visitor.enter or visitor.leave for the node's type,
+// falling back to one that takes a Node.
+template <typename Event, typename V> Walk dispatch(V &visitor, TSNode node) {
+  switch (ts_node_symbol(node)) {
+${cases.join("\n")}
+  default:
+    return call<Node>(visitor, Event(), node);
+  }
+}
+
+} // namespace detail
+
+// Walks trees in document order, calling the enter and leave methods of a
+// visitor for each node. A visitor declares an overload of enter and leave for
+// each node type it's interested in, such as enter(const MatchExpr &), and may
+// declare overloads that take a Node to see every other node, including
+// anonymous ones. Overloads are picked at compile time, so nodes of other
+// types cost a switch and nothing more.
+//
+// A walker keeps one TSTreeCursor, which allocates when the walker is created
+// and is reused by every walk, so walks don't allocate.
+class Walker {
+public:
+  explicit Walker(TSNode root) : cursor_(ts_tree_cursor_new(root)) {}
+  ~Walker() { ts_tree_cursor_delete(&cursor_); }
+  Walker(const Walker &) = delete;
+  Walker &operator=(const Walker &) = delete;
+
+  // Walks the subtree rooted at root, which needn't be from the same tree as
+  // the node the walker was created with. leave is called for every node that
+  // enter was called for, unless the walk is stopped.
+  template <typename V> void walk(TSNode root, V &visitor) {
+    ts_tree_cursor_reset(&cursor_, root);
+    while (true) {
+      TSNode node = ts_tree_cursor_current_node(&cursor_);
+      Walk walk = detail::dispatch<detail::Enter>(visitor, node);
+      if (walk == Walk::Stop) {
+        return;
+      }
+      if (walk == Walk::Continue && ts_tree_cursor_goto_first_child(&cursor_)) {
+        continue;
+      }
+      detail::dispatch<detail::Leave>(visitor, node);
+      while (!ts_tree_cursor_goto_next_sibling(&cursor_)) {
+        if (!ts_tree_cursor_goto_parent(&cursor_)) {
+          return;
+        }
+        detail::dispatch<detail::Leave>(visitor,
+                                        ts_tree_cursor_current_node(&cursor_));
+      }
+    }
+  }
+
+private:
+  TSTreeCursor cursor_;
+};
+
+// Walks the subtree rooted at root with a new Walker.
+template <typename V> void walk(TSNode root, V &visitor) {
+  Walker(root).walk(root, visitor);
+}
+
+} // namespace tree_sitter::koka
+
+#endif // TREE_SITTER_KOKA_HPP_
+`,
+);
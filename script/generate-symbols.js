@@ -0,0 +1,246 @@
+#!/usr/bin/env node
+// Generates bindings/c/tree-sitter-koka-symbols.hpp, which exposes the symbol
+// and field IDs that src/parser.c keeps private as C++ constants, so consumers
+// can compare node types as integers rather than strings. Run this after
+// regenerating the parser.
+
+const fs = require("fs");
+const path = require("path");
+const { identifier } = require("./cpp");
+
+const root = path.join(__dirname, "..");
+const parser = fs.readFileSync(path.join(root, "src", "parser.c"), "utf8");
+
+/**
+ * Returns the body of the first brace-delimited block following `header`.
+ *
+ * @param {string} header
+ *
+ * @return {string}
+ */
+function block(header) {
+  const start = parser.indexOf(header);
+  if (start < 0) {
+    throw new Error(`src/parser.c has no ${header}`);
+  }
+  const open = parser.indexOf("{", start);
+  return parser.slice(open + 1, parser.indexOf("\n};", open));
+}
+
+/**
+ * @param {string} name
+ *
+ * @return {number}
+ */
+function define(name) {
+  const match = parser.match(new RegExp(`^#define ${name} (\\d+)$`, "m"));
+  if (!match) {
+    throw new Error(`src/parser.c doesn't define ${name}`);
+  }
+  return Number(match[1]);
+}
+
+/**
+ * Decodes the contents of a C string literal as written by tree-sitter.
+ *
+ * @param {string} literal
+ *
+ * @return {string}
+ */
+function unescape(literal) {
+  return literal.replace(/\\(.)/g, (_, c) =>
+    ({ n: "\n", r: "\r", t: "\t", 0: "\0" })[c] ?? c,
+  );
+}
+
+/**
+ * Renders text as the contents of a C++ string literal.
+ *
+ * @param {string} text
+ *
+ * @return {string}
+ */
+function escape(text) {
+  return text.replace(/[\\"\n\r\t\0?]/g, (c) =>
+    ({ "\n": "\\n", "\r": "\\r", "\t": "\\t", "\0": "\\0", "?": "\\?" })[c] ??
+    "\\" + c,
+  );
+}
+
+// How tree-sitter spells punctuation in the enumerators of anonymous tokens.
+const PUNCTUATION = {
+  "{": "LBRACE",
+  "}": "RBRACE",
+  ";": "SEMI",
+};
+
+const ids = { ts_builtin_sym_end: 0 };
+for (const [, name, id] of block("enum ts_symbol_identifiers").matchAll(
+  /^\s+(\w+) = (\d+),$/gm,
+)) {
+  ids[name] = Number(id);
+}
+
+const symbolCount = define("SYMBOL_COUNT") + define("ALIAS_COUNT");
+const symbols = Array.from({ length: symbolCount }, () => ({}));
+
+for (const [, name, literal] of block("ts_symbol_names[]").matchAll(
+  /^\s+\[(\w+)\] = "((?:[^"\\]|\\.)*)",$/gm,
+)) {
+  symbols[ids[name]].enumerator = name;
+  symbols[ids[name]].name = unescape(literal);
+}
+for (const [, name, target] of block("ts_symbol_map[]").matchAll(
+  /^\s+\[(\w+)\] = (\w+),$/gm,
+)) {
+  symbols[ids[name]].public = ids[name] === ids[target];
+}
+for (const [, name, fields] of block("ts_symbol_metadata[]").matchAll(
+  /^\s+\[(\w+)\] = \{([^}]*)\}/gm,
+)) {
+  symbols[ids[name]].visible = /\.visible = true/.test(fields);
+  symbols[ids[name]].named = /\.named = true/.test(fields);
+}
+
+const fields = [];
+for (const [, name, id] of block("enum ts_field_identifiers").matchAll(
+  /^\s+field_(\w+) = (\d+),$/gm,
+)) {
+  fields.push({ name, id: Number(id) });
+}
+if (fields.length !== define("FIELD_COUNT")) {
+  throw new Error("src/parser.c has an unexpected number of fields");
+}
+
+// Only symbols that ts_node_symbol can return get a constant.
+const exposed = symbols
+  .map((symbol, id) => ({ ...symbol, id }))
+  .filter((symbol) => symbol.public && symbol.visible);
+
+/**
+ * @param {boolean} named
+ *
+ * @return {string}
+ */
+function constants(named) {
+  const prefix = named ? /^(alias_)?sym_/ : /^anon_sym_/;
+  return exposed
+    .filter((symbol) => symbol.named === named)
+    .map((symbol) => {
+      // External tokens aliased to anonymous nodes keep their external
+      // enumerator, so name those after their text instead.
+      const name = identifier(
+        prefix.test(symbol.enumerator)
+          ? symbol.enumerator.replace(prefix, "")
+          : PUNCTUATION[symbol.name] ?? symbol.name,
+      );
+      const comment = named ? "" : ` // "${escape(symbol.name)}"`;
+      return `inline constexpr Symbol ${name} = ${symbol.id};${comment}`;
+    })
+    .join("\n");
+}
+
+const table = symbols
+  .map(
+    (symbol) =>
+      `    {"${escape(symbol.name)}", ${symbol.visible}, ${symbol.named}},`,
+  )
+  .join("\n");
+
+const fieldConstants = fields
+  .map(
+    (field) =>
+      `inline constexpr FieldId ${identifier(field.name)} = ${field.id};`,
+  )
+  .join("\n");
+const fieldTable = fields.map((field) => `    "${field.name}",`).join("\n");
+
+fs.writeFileSync(
+  path.join(root, "bindings", "c", "tree-sitter-koka-symbols.hpp"),
+  `// Generated by script/generate-symbols.js from src/parser.c. Do not edit.
+
+#ifndef TREE_SITTER_KOKA_SYMBOLS_HPP_
+#define TREE_SITTER_KOKA_SYMBOLS_HPP_
+
+#include <cstdint>
+#include <string_view>
+
+namespace tree_sitter::koka {
+
+// The same types as TSSymbol and TSFieldId.
+using Symbol = std::uint16_t;
+using FieldId = std::uint16_t;
+
+// The number of entries in symbols, which is what ts_language_symbol_count
+// returns.
+inline constexpr Symbol symbol_count = ${symbolCount};
+inline constexpr FieldId field_count = ${fields.length};
+
+// Named node types, as returned by ts_node_symbol. Names that are C++ keywords
+// get a trailing underscore.
+namespace sym {
+${constants(true)}
+} // namespace sym
+
+// Anonymous node types, named as in src/parser.c.
+namespace anon {
+${constants(false)}
+} // namespace anon
+
+namespace field {
+${fieldConstants}
+} // namespace field
+
+struct SymbolInfo {
+  std::string_view name;
+  bool visible;
+  bool named;
+};
+
+// Indexed by symbol, like ts_language_symbol_name and ts_language_symbol_type.
+inline constexpr SymbolInfo symbols[symbol_count] = {
+${table}
+};
+
+// Indexed by field ID; 0 isn't a field.
+inline constexpr std::string_view field_names[field_count + 1] = {
+    "",
+${fieldTable}
+};
+
+constexpr std::string_view symbol_name(Symbol symbol) {
+  return symbol < symbol_count ? symbols[symbol].name : std::string_view();
+}
+
+constexpr std::string_view field_name(FieldId field) {
+  return field <= field_count ? field_names[field] : std::string_view();
+}
+
+// Equivalent to ts_language_symbol_for_name, but usable in constant
+// expressions. Returns 0 if there's no such visible symbol.
+constexpr Symbol symbol_for_name(std::string_view name, bool named) {
+  for (Symbol symbol = 1; symbol < symbol_count; symbol++) {
+    const SymbolInfo &info = symbols[symbol];
+    if (info.visible && info.named == named && info.name == name) {
+      return symbol;
+    }
+  }
+  return 0;
+}
+
+// Equivalent to ts_language_field_id_for_name. Returns 0 if there's no such
+// field.
+constexpr FieldId field_for_name(std::string_view name) {
+  for (FieldId field = 1; field <= field_count; field++) {
+    if (field_names[field] == name) {
+      return field;
+    }
+  }
+  return 0;
+}
+
+} // namespace tree_sitter::koka
+
+#endif // TREE_SITTER_KOKA_SYMBOLS_HPP_
+`,
+);
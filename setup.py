@@ -1,19 +1,9 @@
-from os.path import isdir, join
 from platform import system
 
 from setuptools import Extension, find_packages, setup
-from setuptools.command.build import build
 from wheel.bdist_wheel import bdist_wheel
 
 
-class Build(build):
-    def run(self):
-        if isdir("queries"):
-            dest = join(self.build_lib, "tree_sitter_koka", "queries")
-            self.copy_tree("queries", dest)
-        super().run()
-
-
 class BdistWheel(bdist_wheel):
     def get_tag(self):
         python, abi, platform = super().get_tag()
@@ -27,7 +17,6 @@ setup(
     package_dir={"": "bindings/python"},
     package_data={
         "tree_sitter_koka": ["*.pyi", "py.typed"],
-        "tree_sitter_koka.queries": ["*.scm"],
     },
     ext_package="tree_sitter_koka",
     ext_modules=[
@@ -36,7 +25,8 @@ setup(
             sources=[
                 "bindings/python/tree_sitter_koka/binding.c",
                 "src/parser.c",
-                # NOTE: if your language uses an external scanner, add it here.
+                "src/scanner.c",
+                "src/queries.c",
             ],
             extra_compile_args=[
                 "-std=c11",
@@ -55,7 +45,6 @@ setup(
         )
     ],
     cmdclass={
-        "build": Build,
         "bdist_wheel": BdistWheel
     },
     zip_safe=False
@@ -1,7 +1,8 @@
+#include "continuations.h"
 #include "tree_sitter/parser.h"
 #include <assert.h>
+#include <stdint.h>
 #include <stdlib.h>
-#include <string.h>
 
 enum TokenType {
   OpenBrace,
@@ -18,6 +19,13 @@ struct scanner {
   bool no_final_semi_insert;
   bool eof_semi_inserted;
   bool push_layout_stack_after_open_brace;
+  // Whether the last layout token was placed before comments, for the line of
+  // the token after them.
+  bool layout_before_comments;
+  // The indentation of the last line whose start the scanner has seen, which
+  // columns are compared to instead of calling get_column, or UNKNOWN_COLUMN
+  // once a brace in the middle of a line has been scanned after it.
+  int line_indent;
   size_t stack_len;
   size_t stack_cap;
   int *stack;
@@ -30,6 +38,8 @@ static void scanner_reset(struct scanner *scanner) {
   scanner->no_final_semi_insert = false;
   scanner->eof_semi_inserted = false;
   scanner->push_layout_stack_after_open_brace = false;
+  scanner->layout_before_comments = false;
+  scanner->line_indent = 0;
   scanner->stack_len = 0;
   scanner->stack_cap = 0;
   scanner->stack = NULL;
@@ -60,56 +70,149 @@ static int scanner_pop_indent(struct scanner *scanner) {
 // this...
 #define TABWIDTH 8
 
+// The layout column of a block opened by a '{' in the middle of a line, until
+// the next line starts. get_column rescans the line up to the lexer's position,
+// which is quadratic on long lines when done for every brace, so the block
+// takes the indentation of the line that continues it instead.
+#define UNKNOWN_COLUMN -1
+
+// Resolves the columns of blocks opened on the previous line, which are all on
+// top of the stack, to the indentation of the line that continues them.
+static void scanner_resolve_columns(struct scanner *scanner,
+                                    int indent_length) {
+  for (size_t i = scanner->stack_len;
+       i > 0 && scanner->stack[i - 1] == UNKNOWN_COLUMN; i--) {
+    scanner->stack[i - 1] = indent_length;
+  }
+}
+
+// Whether the block on top of the stack starts right of the column after a
+// '}'. Finding that column takes get_column when the '}' isn't the first token
+// on its line, but blocks opened on the line and blocks no deeper than its
+// indentation must start before the '}', so that's rarely needed. The
+// indentation is only trusted until a brace is scanned in the middle of the
+// line, after which get_column decides.
+static bool scanner_top_after_close(struct scanner *scanner, TSLexer *lexer,
+                                    int *column, bool *column_known) {
+  int top = scanner->stack[scanner->stack_len - 1];
+  if (!*column_known) {
+    if (top == UNKNOWN_COLUMN || top <= scanner->line_indent) {
+      return false;
+    }
+    *column = (int)lexer->get_column(lexer);
+    *column_known = true;
+  }
+  return top > *column;
+}
+
 static inline void advance(TSLexer *lexer) { lexer->advance(lexer, false); }
 
 static inline void skip(TSLexer *lexer) { lexer->advance(lexer, true); }
 
-static inline bool in_range(char c, char min, char max) {
-  return min <= c && c <= max;
+static inline enum Continuation first_char_continuation(int32_t c) {
+  return 0 <= c && c < 128 ? continuation_first_chars[c] : CONTINUATION_NONE;
 }
 
+// Runs continuation_states from the first character of a token classified
+// CONTINUATION_MAYBE, advancing the lexer only while a transition can still
+// change the result.
 static inline bool resolve_maybe_start_cont(TSLexer *lexer) {
-  switch (lexer->lookahead) {
-  case '>': // Excluding ">>", ">|<"
-    advance(lexer);
-    switch (lexer->lookahead) {
-    case '>': // ">>"
-      return false;
-
-    case '|':
-      advance(lexer);
-      return lexer->lookahead != '<'; // ">|<"
-
-    default:
-      return true;
+  const struct continuation_state *state = &continuation_states[0];
+  while (true) {
+    const struct continuation_transition *transition =
+        &continuation_transitions[state->first_transition];
+    const struct continuation_transition *end =
+        transition + state->transition_count;
+    while (transition != end && transition->c != lexer->lookahead) {
+      transition++;
+    }
+    if (transition == end) {
+      break;
     }
-
-  case '<': // Also "<-", excluding "<<"
     advance(lexer);
-    return lexer->lookahead != '<';
+    state = &continuation_states[transition->state];
+  }
 
-  case 't': // For "then"
-  case 'e': // For "else" and "elif"
-    break;
+  switch (state->result) {
+  case CONTINUATION_START:
+    return true;
+
+  case CONTINUATION_WORD:
+    return !(0 <= lexer->lookahead && lexer->lookahead < 128 &&
+             continuation_identifier_chars[lexer->lookahead]);
 
   default:
     return false;
   }
+}
 
-  char word[4];
-  for (size_t i = 0; i < 4; i++) {
-    word[i] = lexer->lookahead;
+// Scans a raw string, with the lexer on its 'r'. The whole literal is one
+// token, which is rescanned whenever it's edited, so the loop over its
+// contents calls into the lexer as little as it can: eof is only asked about
+// when the lookahead is 0, which is what it is at the end of the input.
+static bool scan_raw_string(TSLexer *lexer) {
+  advance(lexer);
+
+  int pound_count = 0;
+  while (lexer->lookahead == '#') {
+    pound_count++;
     advance(lexer);
   }
-  if (strncmp(word, "then", 4) != 0 && strncmp(word, "else", 4) != 0 &&
-      strncmp(word, "elif", 4) != 0) {
-    // Then the starting characters don't match one of the possible start
-    // continuation characters, so return.
+  if (lexer->lookahead != '"') {
     return false;
   }
-  return !(in_range(lexer->lookahead, 'a', 'z') ||
-           in_range(lexer->lookahead, 'A', 'Z') ||
-           in_range(lexer->lookahead, '0', '9') || lexer->lookahead == '\'');
+  advance(lexer);
+
+  while (true) {
+    if (lexer->lookahead == '"') {
+      advance(lexer);
+      int pounds = 0;
+      while (pounds < pound_count && lexer->lookahead == '#') {
+        pounds++;
+        advance(lexer);
+      }
+      if (pounds == pound_count) {
+        break;
+      }
+      // Without advancing, as this may be the '"' that ends the string.
+      continue;
+    }
+    if (lexer->lookahead == 0 && lexer->eof(lexer)) {
+      return false;
+    }
+    advance(lexer);
+  }
+
+  lexer->result_symbol = RawString;
+  lexer->mark_end(lexer);
+  return true;
+}
+
+// Skips the rest of a block comment, which can nest, with the lexer after its
+// "/*". found_eol is set if it spans lines, and indent_length to the
+// whitespace its last line starts with.
+static void skip_block_comment(TSLexer *lexer, bool *found_eol,
+                               int *indent_length) {
+  int depth = 1;
+  bool in_indent = false;
+  while (depth > 0 && !lexer->eof(lexer)) {
+    int32_t c = lexer->lookahead;
+    skip(lexer);
+    if ((c == '*' && lexer->lookahead == '/') ||
+        (c == '/' && lexer->lookahead == '*')) {
+      depth += c == '/' ? 1 : -1;
+      skip(lexer);
+      in_indent = false;
+    } else if (c == '\n') {
+      *found_eol = true;
+      *indent_length = 0;
+      in_indent = true;
+    } else if (in_indent && (c == ' ' || c == '\t')) {
+      *indent_length += c == '\t' ? TABWIDTH : 1;
+    } else {
+      in_indent = false;
+    }
+  }
 }
 
 void *tree_sitter_koka_external_scanner_create() {
@@ -125,58 +228,211 @@ void tree_sitter_koka_external_scanner_destroy(void *payload) {
   free(scanner);
 }
 
+// Flags in the first byte of a serialized state.
+enum {
+  INSERT_OPEN_BRACE = 1 << 0,
+  NO_FINAL_SEMI_INSERT = 1 << 1,
+  EOF_SEMI_INSERTED = 1 << 2,
+  PUSH_LAYOUT_STACK_AFTER_OPEN_BRACE = 1 << 3,
+  LAYOUT_BEFORE_COMMENTS = 1 << 4,
+  TRUNCATED_STACK = 1 << 5,
+};
+
+// The most bytes a serialized integer takes.
+#define MAX_VARINT_LENGTH 5
+
+// Tree-sitter keeps the state of every external token, allocating it on the
+// heap when it's longer than 24 bytes, and a dedent of many levels produces
+// two zero-width tokens per level. Integers are small and non-negative, or
+// UNKNOWN_COLUMN, so they're serialized as LEB128 varints of the value plus
+// one, to keep a typical state to a few bytes.
+static unsigned write_bits(char *buffer, uint32_t bits) {
+  unsigned length = 0;
+  while (bits >= 0x80) {
+    buffer[length++] = (char)(bits | 0x80);
+    bits >>= 7;
+  }
+  buffer[length++] = (char)bits;
+  return length;
+}
+
+static uint32_t read_bits(const char *buffer, unsigned length, unsigned *pos) {
+  uint32_t bits = 0;
+  for (unsigned shift = 0; *pos < length && shift < 32; shift += 7) {
+    unsigned char byte = (unsigned char)buffer[(*pos)++];
+    bits |= (uint32_t)(byte & 0x7F) << shift;
+    if (byte < 0x80) {
+      break;
+    }
+  }
+  return bits;
+}
+
+static unsigned bits_length(uint32_t bits) {
+  unsigned length = 1;
+  while (bits >= 0x80) {
+    bits >>= 7;
+    length++;
+  }
+  return length;
+}
+
+static unsigned write_varint(char *buffer, int value) {
+  return write_bits(buffer, (uint32_t)(value + 1));
+}
+
+static int read_varint(const char *buffer, unsigned length, unsigned *pos) {
+  return (int)read_bits(buffer, length, pos) - 1;
+}
+
+// The stack is serialized as runs of equal differences between a level and
+// the one below it, which nesting indented by a fixed width keeps to a run per
+// width. A difference is negative when a level's column is UNKNOWN_COLUMN, so
+// it's zigzag encoded.
+static uint32_t zigzag(int difference) {
+  uint32_t bits = (uint32_t)difference << 1;
+  return difference < 0 ? ~bits : bits;
+}
+
+static unsigned write_difference(char *buffer, int difference) {
+  return write_bits(buffer, zigzag(difference));
+}
+
+static int read_difference(const char *buffer, unsigned length,
+                           unsigned *pos) {
+  uint32_t bits = read_bits(buffer, length, pos);
+  return bits & 1 ? (int)~(bits >> 1) : (int)(bits >> 1);
+}
+
+// Writes the levels of the stack from first up, returning false if they don't
+// fit in the buffer.
+static bool write_stack(const struct scanner *scanner, size_t first, int below,
+                        char *buffer, unsigned *length) {
+  for (size_t i = first; i < scanner->stack_len;) {
+    int difference = scanner->stack[i] - below;
+    size_t run = 1;
+    while (i + run < scanner->stack_len &&
+           scanner->stack[i + run] - scanner->stack[i + run - 1] ==
+               difference) {
+      run++;
+    }
+    if (*length + 2 * MAX_VARINT_LENGTH >
+        TREE_SITTER_SERIALIZATION_BUFFER_SIZE) {
+      return false;
+    }
+    *length += write_difference(buffer + *length, difference);
+    *length += write_varint(buffer + *length, (int)run);
+    i += run;
+    below = scanner->stack[i - 1];
+  }
+  return true;
+}
+
 unsigned tree_sitter_koka_external_scanner_serialize(void *payload,
                                                      char *buffer) {
-#if defined(__STDC_VERSION__) && (__STDC_VERSION__ >= 201112L)
-  _Static_assert(sizeof(struct scanner) <=
-                     TREE_SITTER_SERIALIZATION_BUFFER_SIZE,
-                 "serialization size is too small");
-#else
-  assert(sizeof(struct scanner) <= TREE_SITTER_SERIALIZATION_BUFFER_SIZE &&
-         "serialization size is too small");
-#endif
-
-  // This serializes the stack pointer too, but that's fine as long as we don't
-  // use it when deserializing, and desirable so we don't have to think about
-  // struct layout rules.
   struct scanner *scanner = payload;
-  memcpy(buffer, scanner, sizeof(struct scanner));
-  memcpy(buffer + sizeof(struct scanner), scanner->stack,
-         sizeof(int) * scanner->stack_len);
-  return sizeof(struct scanner) + sizeof(int) * scanner->stack_len;
+  unsigned length = 0;
+  buffer[length++] =
+      (char)((scanner->insert_open_brace ? INSERT_OPEN_BRACE : 0) |
+             (scanner->no_final_semi_insert ? NO_FINAL_SEMI_INSERT : 0) |
+             (scanner->eof_semi_inserted ? EOF_SEMI_INSERTED : 0) |
+             (scanner->push_layout_stack_after_open_brace
+                  ? PUSH_LAYOUT_STACK_AFTER_OPEN_BRACE
+                  : 0) |
+             (scanner->layout_before_comments ? LAYOUT_BEFORE_COMMENTS : 0));
+  length += write_varint(buffer + length, scanner->close_braces_to_insert);
+  length += write_varint(buffer + length, scanner->semis_to_insert);
+  length += write_varint(buffer + length, scanner->line_indent);
+
+  unsigned header_length = length;
+  if (write_stack(scanner, 0, 0, buffer, &length)) {
+    return length;
+  }
+
+  // A stack too irregular to fit keeps its innermost levels, which the layout
+  // of the next lines is decided by. Each level is counted as a run of its
+  // own, which bounds what the runs of the kept levels take. The dropped
+  // levels are recorded by their number and the column of the highest one.
+  unsigned budget = TREE_SITTER_SERIALIZATION_BUFFER_SIZE - header_length -
+                    4 * MAX_VARINT_LENGTH;
+  unsigned used = 0;
+  size_t first = scanner->stack_len;
+  while (first > 1) {
+    int difference = scanner->stack[first - 1] - scanner->stack[first - 2];
+    unsigned level_length = bits_length(zigzag(difference)) + 1;
+    if (used + level_length > budget) {
+      break;
+    }
+    used += level_length;
+    first--;
+  }
+
+  length = header_length;
+  buffer[0] |= TRUNCATED_STACK;
+  length += write_varint(buffer + length, (int)first);
+  length += write_varint(buffer + length, scanner->stack[first - 1]);
+  write_stack(scanner, first, scanner->stack[first - 1], buffer, &length);
+  return length;
 }
 
 void tree_sitter_koka_external_scanner_deserialize(void *payload,
                                                    const char *buffer,
                                                    unsigned length) {
+  // Tree-sitter deserializes before every scan, which happens after nearly
+  // every operator, comma and bracket because of the end continuation signal,
+  // so the stack's allocation is kept rather than freed and reallocated.
   struct scanner *scanner = payload;
-  free(scanner->stack);
+  int *stack = scanner->stack;
+  size_t stack_cap = scanner->stack_cap;
   scanner_reset(scanner);
+  scanner->stack = stack;
+  scanner->stack_cap = stack_cap;
 
   if (length == 0) {
     return;
   }
 
-  assert(length >= sizeof(struct scanner) && "invalid length");
-
-  memcpy(scanner, buffer, sizeof(struct scanner));
-  assert(scanner->stack_len ==
-             (length - sizeof(struct scanner)) / sizeof(int) &&
-         "invalid length");
-  scanner->stack_cap = scanner->stack_len;
-  if (scanner->stack_len == 0) {
-    scanner->stack = NULL;
-    return;
+  unsigned pos = 0;
+  unsigned char flags = (unsigned char)buffer[pos++];
+  scanner->insert_open_brace = flags & INSERT_OPEN_BRACE;
+  scanner->no_final_semi_insert = flags & NO_FINAL_SEMI_INSERT;
+  scanner->eof_semi_inserted = flags & EOF_SEMI_INSERTED;
+  scanner->push_layout_stack_after_open_brace =
+      flags & PUSH_LAYOUT_STACK_AFTER_OPEN_BRACE;
+  scanner->layout_before_comments = flags & LAYOUT_BEFORE_COMMENTS;
+  scanner->close_braces_to_insert = read_varint(buffer, length, &pos);
+  scanner->semis_to_insert = read_varint(buffer, length, &pos);
+  scanner->line_indent = read_varint(buffer, length, &pos);
+  assert(pos <= length && "invalid length");
+
+  // The levels dropped from a truncated stack come back at the column of the
+  // highest of them, so that a dedent past the kept levels still closes a
+  // block for each.
+  int below = 0;
+  if (flags & TRUNCATED_STACK) {
+    int dropped = read_varint(buffer, length, &pos);
+    below = read_varint(buffer, length, &pos);
+    for (; dropped > 0; dropped--) {
+      scanner_push_indent(scanner, below);
+    }
+  }
+  while (pos < length) {
+    int difference = read_difference(buffer, length, &pos);
+    for (int run = read_varint(buffer, length, &pos); run > 0; run--) {
+      below += difference;
+      scanner_push_indent(scanner, below);
+    }
   }
-  scanner->stack = malloc(scanner->stack_len * sizeof(int));
-  assert(scanner->stack);
-  memcpy(scanner->stack, buffer + sizeof(struct scanner),
-         scanner->stack_len * sizeof(int));
 }
 
 bool tree_sitter_koka_external_scanner_scan(void *payload, TSLexer *lexer,
                                             const bool *valid_symbols) {
   struct scanner *scanner = payload;
+
+  // Every external token is valid both during error recovery and when a
+  // state's own lex mode finds no token, as tree-sitter then lexes again in
+  // its error mode. Valid code relies on the latter, for example for the '}'
+  // in `match { x }`, so the two are scanned alike.
   if (scanner->close_braces_to_insert >= scanner->semis_to_insert &&
       scanner->close_braces_to_insert > 0) {
     scanner->close_braces_to_insert--;
@@ -200,18 +456,36 @@ bool tree_sitter_koka_external_scanner_scan(void *payload, TSLexer *lexer,
   }
 
   lexer->mark_end(lexer);
-
-  // ' ', '\t', '\r', '\n'
+  // Whether the scan starts at a comment, as it does after a layout token
+  // placed before one.
+  bool at_comment = lexer->lookahead == '/';
+
+  // ' ', '\t', '\r', '\n' and comments, so that the layout is decided by the
+  // code after comments rather than by where the comments are. A line's
+  // indentation is the whitespace it starts with, whether code or a comment
+  // follows it.
   bool found_eol = false;
+  // Whether a newline outside of comments was found.
+  bool found_line_eol = false;
+  bool skipped_comment = false;
+  // Whether the first comment starts on the line of the token before it.
+  bool comment_before_eol = false;
+  // Whether the lexer is past a '/' that doesn't start a comment.
+  bool after_slash = false;
   int indent_length = 0;
+  bool in_indent = false;
   while (true) {
     switch (lexer->lookahead) {
     case ' ':
-      indent_length++;
+      if (in_indent) {
+        indent_length++;
+      }
       break;
 
     case '\t':
-      indent_length += TABWIDTH;
+      if (in_indent) {
+        indent_length += TABWIDTH;
+      }
       break;
 
     case '\r':
@@ -219,10 +493,64 @@ bool tree_sitter_koka_external_scanner_scan(void *payload, TSLexer *lexer,
       break;
 
     case '\n':
+      // A comment on the line of the token before goes before the layout
+      // token, which the scan after the comment places.
+      if (comment_before_eol) {
+        return false;
+      }
       found_eol = true;
+      found_line_eol = true;
       indent_length = 0;
+      in_indent = true;
       break;
 
+    case '/':
+      // A layout token goes before the first comment, which would otherwise
+      // become its padding, or before the '/' operator.
+      if (!skipped_comment) {
+        lexer->mark_end(lexer);
+        comment_before_eol = !found_eol;
+      }
+      in_indent = false;
+      skip(lexer);
+      if (lexer->lookahead == '/') {
+        // The layout token for the line after these comments was placed
+        // before them, so they're lexed one by one without scanning past them
+        // again. Were it for an earlier line, the scan after the comment would
+        // still find the newline.
+        if (scanner->layout_before_comments) {
+          return false;
+        }
+        while (lexer->lookahead != '\n' && !lexer->eof(lexer)) {
+          skip(lexer);
+        }
+      } else if (lexer->lookahead == '*') {
+        skip(lexer);
+        int comment_indent_length = 0;
+        bool comment_eol = false;
+        skip_block_comment(lexer, &comment_eol, &comment_indent_length);
+        // The line of the next token starts in the comment, unless a newline
+        // before it already started one.
+        if (comment_eol && !found_line_eol) {
+          found_eol = true;
+          indent_length = comment_indent_length;
+        }
+        // As above, unless code follows the comment on its line.
+        if (scanner->layout_before_comments) {
+          while (lexer->lookahead == ' ' || lexer->lookahead == '\t') {
+            skip(lexer);
+          }
+          if (lexer->lookahead == '\n' || lexer->eof(lexer)) {
+            return false;
+          }
+        }
+      } else {
+        after_slash = true;
+        goto AFTER_WHITESPACE;
+      }
+      skipped_comment = true;
+      continue;
+
     default:
       goto AFTER_WHITESPACE;
     }
@@ -231,73 +559,69 @@ bool tree_sitter_koka_external_scanner_scan(void *payload, TSLexer *lexer,
   }
 
 AFTER_WHITESPACE:
+  // Where only the end continuation signal is valid, which is never produced,
+  // only the semicolon at the end of the file can be found.
+  if (!valid_symbols[OpenBrace] && !valid_symbols[CloseBrace] &&
+      !valid_symbols[Semi] && !valid_symbols[RawString] && !lexer->eof(lexer)) {
+    return false;
+  }
+
+  // The newlines in the comments a layout token was placed before are only
+  // counted by the scan that placed it.
+  if (at_comment && skipped_comment && scanner->layout_before_comments) {
+    found_eol = false;
+  }
+  scanner->layout_before_comments = false;
+
+  if (found_eol) {
+    scanner->line_indent = indent_length;
+    scanner_resolve_columns(scanner, indent_length);
+  }
   if (scanner->push_layout_stack_after_open_brace) {
-    scanner_push_indent(scanner,
-                        found_eol ? indent_length : lexer->get_column(lexer));
+    scanner_push_indent(scanner, found_eol ? indent_length : UNKNOWN_COLUMN);
     scanner->push_layout_stack_after_open_brace = false;
   }
 
-  bool is_start_cont = false;
-  bool maybe_start_cont = false;
-  switch (lexer->lookahead) {
-  case '$':
-  case '%':
-  case '&':
-  case '*':
-  case '+':
-  case '@':
-  case '\\':
-  case '^':
-  case '?':
-  case '.':
-  case '=':
-  case ')':
-  case ']':
-  case '{':
-  case '}':
-  case ':': // Also ":="
-  case '-': // Also "->"
-  case '|': // Also "||"
-    // On this branch, we're sure that the token we encountered is a start
-    // continuation token.
-    is_start_cont = true;
-    break;
-
-  case '>': // Excluding ">>", ">|<"
-  case '<': // Also "<-", excluding "<<"
-  case 't': // For "then"
-  case 'e': // For "else" and "elif"
-    // On this branch, we're not sure, but it might be. Note that the lookahead
-    // token possibilities here are disjoint with those in the switch at the
-    // end, which is good because it means we can advance the lookahead to
-    // figure out what's going on, then skip the switch at the bottom because we
-    // know it wouldn't have produced anything.
-    maybe_start_cont = true;
-    break;
-
-  default:
-    // On this branch, we know the token can't be a start continuation token.
-    break;
-  };
+  // The characters classified CONTINUATION_MAYBE are disjoint with those in
+  // the switch at the end, which is good because it means we can advance the
+  // lookahead to figure out what's going on, then skip the switch at the
+  // bottom because we know it wouldn't have produced anything.
+  enum Continuation continuation =
+      first_char_continuation(after_slash ? '/' : lexer->lookahead);
+  bool is_start_cont = continuation == CONTINUATION_START;
+  bool maybe_start_cont = continuation == CONTINUATION_MAYBE;
 
   if (found_eol) {
     int prev_indent_length =
         scanner->stack_len != 0 ? scanner->stack[scanner->stack_len - 1] : 0;
+    // A block can't start at the end of the file, where the last line has
+    // only whitespace or comments.
     if (prev_indent_length < indent_length && valid_symbols[OpenBrace] &&
         !valid_symbols[EndContinuationSignal] && !is_start_cont &&
+        !lexer->eof(lexer) &&
         (!maybe_start_cont || !resolve_maybe_start_cont(lexer))) {
       assert(indent_length > prev_indent_length);
       scanner_push_indent(scanner, indent_length);
+      scanner->layout_before_comments = skipped_comment;
       lexer->result_symbol = OpenBrace;
       return true;
     } else if (prev_indent_length == indent_length && valid_symbols[Semi] &&
                !valid_symbols[EndContinuationSignal] && !is_start_cont) {
+      // This goes before the next token, which can't be marked once past it,
+      // or at the first comment or '/', marked above.
+      if (!skipped_comment && !after_slash) {
+        lexer->mark_end(lexer);
+      }
+      scanner->layout_before_comments = skipped_comment;
       lexer->result_symbol = Semi;
-      lexer->mark_end(lexer);
       return !maybe_start_cont || !resolve_maybe_start_cont(lexer);
     } else if (prev_indent_length > indent_length && valid_symbols[Semi] &&
                lexer->lookahead != '}') {
-      lexer->mark_end(lexer);
+      // As above.
+      if (!skipped_comment && !after_slash) {
+        lexer->mark_end(lexer);
+      }
+      scanner->layout_before_comments = skipped_comment;
       while (scanner->stack_len != 0 &&
              scanner->stack[scanner->stack_len - 1] > indent_length) {
         scanner->close_braces_to_insert++;
@@ -318,10 +642,31 @@ AFTER_WHITESPACE:
         scanner->no_final_semi_insert = true;
       }
 
+      return true;
+    } else if (lexer->lookahead == '}' && skipped_comment &&
+               valid_symbols[Semi] && scanner->stack_len > 1 &&
+               scanner->stack[scanner->stack_len - 2] > indent_length) {
+      // The '}' below ends the blocks deeper than its line, whose indentation
+      // is lost once the comments before it have been lexed, so the blocks
+      // but its own are ended here.
+      while (scanner->stack_len > 1 &&
+             scanner->stack[scanner->stack_len - 2] > indent_length) {
+        scanner->close_braces_to_insert++;
+        scanner->semis_to_insert++;
+        scanner_pop_indent(scanner);
+      }
+      scanner->no_final_semi_insert = true;
+      scanner->layout_before_comments = skipped_comment;
+      lexer->result_symbol = Semi;
       return true;
     }
   }
 
+  if (skipped_comment || after_slash) {
+    // The tokens below would take the comments as padding, and the '/' isn't
+    // one of them.
+    return false;
+  }
   if (lexer->eof(lexer) && !scanner->eof_semi_inserted) {
     scanner->eof_semi_inserted = true;
     lexer->result_symbol = Semi;
@@ -329,7 +674,7 @@ AFTER_WHITESPACE:
   }
 
   if (maybe_start_cont) {
-    // See the comment on the branch of the switch that sets this.
+    // See the comment on the classification that sets this.
     return false;
   }
   switch (lexer->lookahead) {
@@ -345,6 +690,9 @@ AFTER_WHITESPACE:
            "encountered '{' before layout stack push for previous '{' was "
            "handled");
     scanner->push_layout_stack_after_open_brace = true;
+    if (!found_eol) {
+      scanner->line_indent = UNKNOWN_COLUMN;
+    }
     return true;
 
   case '}':
@@ -355,18 +703,21 @@ AFTER_WHITESPACE:
     advance(lexer);
     lexer->mark_end(lexer);
 
-    indent_length = found_eol ? indent_length : lexer->get_column(lexer);
-
     // do ... while ensures we pop at least one. We don't have to check
     // scanner->stack_len != 0 before the first loop because that is guaranteed
     // if valid_symbols[CloseBrace].
+    bool column_known = found_eol;
     do {
       scanner->close_braces_to_insert++;
       scanner->semis_to_insert++;
       scanner_pop_indent(scanner);
     } while (scanner->stack_len != 0 &&
-             scanner->stack[scanner->stack_len - 1] > indent_length);
+             scanner_top_after_close(scanner, lexer, &indent_length,
+                                     &column_known));
     scanner->no_final_semi_insert = true;
+    if (!found_eol) {
+      scanner->line_indent = UNKNOWN_COLUMN;
+    }
 
     lexer->result_symbol = Semi;
     return true;
@@ -386,42 +737,7 @@ AFTER_WHITESPACE:
       break;
     }
 
-    advance(lexer);
-
-    int pound_count = 0;
-    while (lexer->lookahead == '#') {
-      pound_count++;
-      advance(lexer);
-    }
-    if (lexer->lookahead != '"') {
-      return false;
-    }
-
-    while (!lexer->eof(lexer)) {
-      advance(lexer);
-      if (lexer->lookahead == '"') {
-        bool too_few_pounds = false;
-        for (int pounds_remaining = pound_count; pounds_remaining > 0;
-             pounds_remaining--) {
-          advance(lexer);
-          if (lexer->lookahead != '#') {
-            too_few_pounds = true;
-            break;
-          }
-        }
-        if (!too_few_pounds) {
-          break;
-        }
-      }
-    }
-    if (lexer->eof(lexer)) {
-      break;
-    }
-
-    lexer->result_symbol = RawString;
-    advance(lexer);
-    lexer->mark_end(lexer);
-    return true;
+    return scan_raw_string(lexer);
   }
 
   return false;
@@ -0,0 +1,143 @@
+// Checks that the fixity declarations of a module change how
+// tree_sitter_koka_reassociate groups its operator expressions.
+
+#include "tree-sitter-koka-utils.h"
+#include "tree-sitter-koka.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <tree_sitter/api.h>
+
+#define MAX_NODES 64
+
+struct test {
+  const char *name;
+  const char *source;
+  // The first operator expression of source, with every operator and its
+  // operands parenthesized.
+  const char *expected;
+};
+
+static const struct test TESTS[] = {
+    {
+        "std/core fixities",
+        "fun f(a, b, c)\n  a - b - c\n",
+        "((a - b) - c)",
+    },
+    {
+        "infixr",
+        "infixr 60 (-)\n\nfun f(a, b, c)\n  a - b - c\n",
+        "(a - (b - c))",
+    },
+    {
+        "undeclared operator",
+        "fun f(a, b, c)\n  a <+> b * c\n",
+        "(a <+> (b * c))",
+    },
+    {
+        "infixl after imports",
+        "import std/core\n\ninfixl 80 (<+>)\n\nfun f(a, b, c)\n  a <+> b * c\n",
+        "((a <+> b) * c)",
+    },
+};
+
+struct buffer {
+  char data[256];
+  size_t len;
+};
+
+static void append(struct buffer *buffer, const char *text, size_t len) {
+  if (buffer->len + len < sizeof(buffer->data)) {
+    memcpy(buffer->data + buffer->len, text, len);
+    buffer->len += len;
+    buffer->data[buffer->len] = '\0';
+  }
+}
+
+static void append_node(struct buffer *buffer, const char *source,
+                        TSNode node) {
+  uint32_t start = ts_node_start_byte(node);
+  append(buffer, source + start, ts_node_end_byte(node) - start);
+}
+
+static void render(struct buffer *buffer, const char *source,
+                   const TSKokaOperatorNode *nodes, uint32_t index) {
+  const TSKokaOperatorNode *node = &nodes[index];
+  if (node->left == TS_KOKA_OPERATOR_NONE) {
+    append_node(buffer, source, node->node);
+    return;
+  }
+  append(buffer, "(", 1);
+  render(buffer, source, nodes, node->left);
+  append(buffer, " ", 1);
+  append_node(buffer, source, node->node);
+  append(buffer, " ", 1);
+  render(buffer, source, nodes, node->right);
+  append(buffer, ")", 1);
+}
+
+static TSNode first_opexpr(TSNode root, TSSymbol opexpr) {
+  TSTreeCursor cursor = ts_tree_cursor_new(root);
+  TSNode found = {0};
+  while (true) {
+    TSNode node = ts_tree_cursor_current_node(&cursor);
+    if (ts_node_symbol(node) == opexpr && ts_node_child_count(node) > 1) {
+      found = node;
+      break;
+    }
+    if (ts_tree_cursor_goto_first_child(&cursor)) {
+      continue;
+    }
+    bool more = true;
+    while (!ts_tree_cursor_goto_next_sibling(&cursor)) {
+      if (!ts_tree_cursor_goto_parent(&cursor)) {
+        more = false;
+        break;
+      }
+    }
+    if (!more) {
+      break;
+    }
+  }
+  ts_tree_cursor_delete(&cursor);
+  return found;
+}
+
+int main(void) {
+  const TSLanguage *language = tree_sitter_koka();
+  TSParser *parser = ts_parser_new();
+  ts_parser_set_language(parser, language);
+  TSSymbol opexpr = ts_language_symbol_for_name(language, "opexpr", 6, true);
+
+  int failures = 0;
+  for (size_t i = 0; i < sizeof(TESTS) / sizeof(TESTS[0]); i++) {
+    const struct test *test = &TESTS[i];
+    uint32_t len = (uint32_t)strlen(test->source);
+    TSTree *tree = ts_parser_parse_string(parser, NULL, test->source, len);
+    TSNode root = ts_tree_root_node(tree);
+    TSKokaFixityTable *table = tree_sitter_koka_fixity_table_new(language);
+    tree_sitter_koka_fixity_table_add_module(table, root, test->source, len);
+
+    struct buffer buffer = {{0}, 0};
+    TSNode expr = first_opexpr(root, opexpr);
+    TSKokaOperatorNode nodes[MAX_NODES];
+    uint32_t count = ts_node_is_null(expr)
+                         ? 0
+                         : tree_sitter_koka_reassociate(
+                               table, expr, test->source, nodes, MAX_NODES);
+    if (count > 0 && count <= MAX_NODES) {
+      render(&buffer, test->source, nodes, count - 1);
+    }
+    if (strcmp(buffer.data, test->expected) != 0) {
+      printf("FAIL %s: expected %s, got %s\n", test->name, test->expected,
+             buffer.data);
+      failures++;
+    }
+
+    tree_sitter_koka_fixity_table_delete(table);
+    ts_tree_delete(tree);
+  }
+
+  ts_parser_delete(parser);
+  return failures != 0;
+}
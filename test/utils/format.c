@@ -0,0 +1,108 @@
+// Checks the text tree_sitter_koka_format produces for small modules.
+
+#include "tree-sitter-koka-utils.h"
+#include "tree-sitter-koka.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <tree_sitter/api.h>
+
+#define INDENT_WIDTH 2
+
+struct test {
+  const char *name;
+  const char *source;
+  const char *expected;
+};
+
+static const struct test TESTS[] = {
+    {
+        "spacing",
+        "fun add(x,y)\n  x+y\n",
+        "fun add(x, y)\n  x + y\n",
+    },
+    {
+        "reindented body",
+        "fun f(x)\n      val y = x\n      y\n",
+        "fun f(x)\n  val y = x\n  y\n",
+    },
+    {
+        "nested blocks",
+        "fun f(x)\n    if x then\n            1\n    else\n            2\n",
+        "fun f(x)\n  if x then\n    1\n  else\n    2\n",
+    },
+    {
+        "continuation lines keep their offset",
+        "fun f(x)\n    val y = x +\n        1\n    y\n",
+        "fun f(x)\n  val y = x +\n      1\n  y\n",
+    },
+    {
+        "blank lines and trailing whitespace",
+        "fun f()   \n  1\n\n\n\nfun g()\n  2\n",
+        "fun f()\n  1\n\nfun g()\n  2\n",
+    },
+    {
+        "imports",
+        "import std/core\n\nfun main()\n    println( \"hi\" )\n",
+        "import std/core\n\nfun main()\n  println(\"hi\")\n",
+    },
+    {
+        "named module",
+        "module foo\n\nval x = [1,2]\n",
+        "module foo\n\nval x = [1, 2]\n",
+    },
+    {
+        "formatted",
+        "fun f(x)\n  x + 1\n",
+        "fun f(x)\n  x + 1\n",
+    },
+};
+
+static char *format(TSParser *parser, const char *source) {
+  uint32_t len = (uint32_t)strlen(source);
+  TSTree *tree = ts_parser_parse_string(parser, NULL, source, len);
+  TSKokaFormatResult result;
+  tree_sitter_koka_format(tree, source, len, INDENT_WIDTH, NULL, 0, &result);
+
+  size_t text_len = len;
+  for (uint32_t i = 0; i < result.edit_count; i++) {
+    text_len += result.edits[i].text_length;
+  }
+  char *text = malloc(text_len + 1);
+  size_t out = 0;
+  uint32_t copied = 0;
+  for (uint32_t i = 0; i < result.edit_count; i++) {
+    const TSKokaFormatEdit *edit = &result.edits[i];
+    memcpy(text + out, source + copied, edit->start_byte - copied);
+    out += edit->start_byte - copied;
+    memcpy(text + out, result.text + edit->text_start, edit->text_length);
+    out += edit->text_length;
+    copied = edit->end_byte;
+  }
+  memcpy(text + out, source + copied, len - copied);
+  text[out + len - copied] = '\0';
+
+  tree_sitter_koka_format_result_delete(&result);
+  ts_tree_delete(tree);
+  return text;
+}
+
+int main(void) {
+  TSParser *parser = ts_parser_new();
+  ts_parser_set_language(parser, tree_sitter_koka());
+
+  int failures = 0;
+  for (size_t i = 0; i < sizeof(TESTS) / sizeof(TESTS[0]); i++) {
+    const struct test *test = &TESTS[i];
+    char *text = format(parser, test->source);
+    if (strcmp(text, test->expected) != 0) {
+      printf("FAIL %s\n--- expected\n%s--- got\n%s---\n", test->name,
+             test->expected, text);
+      failures++;
+    }
+    free(text);
+  }
+
+  ts_parser_delete(parser);
+  return failures != 0;
+}
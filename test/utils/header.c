@@ -0,0 +1,65 @@
+// Checks where tree_sitter_koka_header_length ends the header of a module.
+
+#include "tree-sitter-koka-utils.h"
+#include <stdio.h>
+#include <string.h>
+
+struct test {
+  const char *name;
+  const char *source;
+  // The text the header should span, which source starts with.
+  const char *header;
+};
+
+static const struct test TESTS[] = {
+    {
+        "imports",
+        "module foo\n\nimport std/core\n// comment\n\nfun f()\n  1\n",
+        "module foo\n\nimport std/core\n// comment\n\n",
+    },
+    {
+        "indented import list",
+        "import\n  std/core\n  std/text\nval x = 1\n",
+        "import\n  std/core\n  std/text\n",
+    },
+    {
+        "nested block comment",
+        "/* a /* b */\n c */\nimport std/core\nval x = 1\n",
+        "/* a /* b */\n c */\nimport std/core\n",
+    },
+    {
+        "block comment before an import",
+        "/* a */ import std/core\nval x = 1\n",
+        "/* a */ import std/core\n",
+    },
+    {
+        "block comment before a declaration",
+        "import std/core\n/* a */ fun f()\n  1\n",
+        "import std/core\n",
+    },
+    {
+        "operator at the start of a line",
+        "import std/core\n/ 2\n",
+        "import std/core\n",
+    },
+    {
+        "header only",
+        "module foo\nimport std/core",
+        "module foo\nimport std/core",
+    },
+};
+
+int main(void) {
+  int failures = 0;
+  for (size_t i = 0; i < sizeof(TESTS) / sizeof(TESTS[0]); i++) {
+    const struct test *test = &TESTS[i];
+    uint32_t length = tree_sitter_koka_header_length(
+        test->source, (uint32_t)strlen(test->source));
+    if (length != strlen(test->header)) {
+      printf("FAIL %s: expected %zu, got %u\n", test->name,
+             strlen(test->header), length);
+      failures++;
+    }
+  }
+  return failures != 0;
+}
@@ -0,0 +1,487 @@
+// Rewrites layout-based Koka into explicitly braced Koka, by inserting the
+// virtual braces and semicolons that the scanner produces into the source.
+// Everything else is copied unchanged, so the output differs from the input
+// only by inserted "{", "}" and ";" characters.
+//
+// Input is processed in a single streaming pass: it's cut into chunks at
+// lines that start at column zero with something other than a continuation,
+// where the scanner's layout stack is empty, and each chunk is parsed and
+// written out on its own, so memory use depends on the chunk size and not on
+// the size of the input.
+//
+// Usage: koka-desugar [-m map] [-c chunk-size] [-s] [input [output]]
+//
+// With -m, a map from input to output offsets is written to map, as lines of
+// "input-offset output-offset": from each such pair of offsets onwards, bytes
+// are copied one to one until the next pair. -c sets the size in bytes that
+// chunks are cut at once they reach, 1 MiB by default. -s prints throughput
+// statistics to stderr. Input and output default to stdin and stdout.
+
+#define _POSIX_C_SOURCE 200809L
+
+#include "tree-sitter-koka.h"
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <tree_sitter/api.h>
+
+#define READ_SIZE (1 << 20)
+
+// How far past a byte the cutter may need to look to classify it. Longer
+// raw-string delimiters are only recognized if they're read in one piece.
+#define LOOKAHEAD 64
+
+static double now(void) {
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (double)ts.tv_sec + (double)ts.tv_nsec / 1e9;
+}
+
+// Finds the places where the input can be cut into independently parsed
+// chunks, tracking just enough of the lexical structure to avoid cutting
+// inside comments, raw strings and brackets.
+struct cutter {
+  size_t pos;
+  int comment_depth;
+  bool in_line_comment;
+  bool in_string;
+  // -1 outside raw strings.
+  int raw_pounds;
+  int nesting;
+  // The last cut point found, or 0 if none has been.
+  size_t cut;
+};
+
+static inline char peek(const char *data, size_t len, size_t i) {
+  return i < len ? data[i] : '\0';
+}
+
+static inline bool is_ident_char(char c) {
+  return (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') ||
+         (c >= '0' && c <= '9') || c == '_' || c == '-' || c == '\'';
+}
+
+// Whether a line starting with data[i] at column zero ends every layout block,
+// i.e. whether the scanner would see it as neither blank nor a continuation.
+// Being conservative here only makes chunks longer.
+static bool starts_top_level(const char *data, size_t len, size_t i) {
+  switch (peek(data, len, i)) {
+  case '\0':
+  case ' ':
+  case '\t':
+  case '\r':
+  case '\n':
+  // A comment, after which the line's first token needn't be at column zero,
+  // or the '/' operator.
+  case '/':
+  case '$':
+  case '%':
+  case '&':
+  case '*':
+  case '+':
+  case '@':
+  case '\\':
+  case '^':
+  case '?':
+  case '.':
+  case '=':
+  case ')':
+  case ']':
+  case '{':
+  case '}':
+  case ':':
+  case '-':
+  case '|':
+  case '>':
+  case '<':
+    return false;
+
+  case 't':
+  case 'e':
+    for (size_t w = 0; w < 3; w++) {
+      static const char *const words[] = {"then", "else", "elif"};
+      if (i + 4 <= len && strncmp(data + i, words[w], 4) == 0 &&
+          !is_ident_char(peek(data, len, i + 4))) {
+        return false;
+      }
+    }
+    return true;
+
+  default:
+    return true;
+  }
+}
+
+// Scans data up to len, or up to LOOKAHEAD bytes before it unless at_eof.
+static void cutter_scan(struct cutter *cutter, const char *data, size_t len,
+                        bool at_eof) {
+  size_t limit = at_eof ? len : len > LOOKAHEAD ? len - LOOKAHEAD : 0;
+  size_t i = cutter->pos;
+  for (; i < limit; i++) {
+    char c = data[i];
+
+    if (cutter->raw_pounds >= 0) {
+      if (c == '"') {
+        int pounds = 0;
+        while (pounds < cutter->raw_pounds &&
+               peek(data, len, i + 1 + (size_t)pounds) == '#') {
+          pounds++;
+        }
+        if (pounds == cutter->raw_pounds) {
+          cutter->raw_pounds = -1;
+          i += (size_t)pounds;
+        }
+      }
+      continue;
+    }
+
+    if (cutter->comment_depth > 0) {
+      if (c == '/' && peek(data, len, i + 1) == '*') {
+        cutter->comment_depth++;
+        i++;
+      } else if (c == '*' && peek(data, len, i + 1) == '/') {
+        cutter->comment_depth--;
+        i++;
+      }
+      continue;
+    }
+
+    if (c == '\n') {
+      cutter->in_line_comment = false;
+      cutter->in_string = false;
+      if (cutter->nesting == 0 && starts_top_level(data, len, i + 1)) {
+        cutter->cut = i + 1;
+      }
+      continue;
+    }
+
+    if (cutter->in_line_comment) {
+      continue;
+    }
+
+    if (cutter->in_string) {
+      if (c == '\\') {
+        i++;
+      } else if (c == '"') {
+        cutter->in_string = false;
+      }
+      continue;
+    }
+
+    switch (c) {
+    case '/':
+      if (peek(data, len, i + 1) == '/') {
+        cutter->in_line_comment = true;
+      } else if (peek(data, len, i + 1) == '*') {
+        cutter->comment_depth = 1;
+        i++;
+      }
+      break;
+
+    case '"':
+      cutter->in_string = true;
+      break;
+
+    case '\'':
+      // Skip character literals, so '"' doesn't start a string.
+      if (peek(data, len, i + 1) == '\\' && peek(data, len, i + 3) == '\'') {
+        i += 3;
+      } else if (peek(data, len, i + 2) == '\'') {
+        i += 2;
+      }
+      break;
+
+    case 'r':
+      if (i == 0 || !is_ident_char(data[i - 1])) {
+        size_t j = i + 1;
+        while (peek(data, len, j) == '#') {
+          j++;
+        }
+        if (peek(data, len, j) == '"') {
+          cutter->raw_pounds = (int)(j - i - 1);
+          i = j;
+        }
+      }
+      break;
+
+    case '(':
+    case '[':
+    case '{':
+      cutter->nesting++;
+      break;
+
+    case ')':
+    case ']':
+    case '}':
+      if (cutter->nesting > 0) {
+        cutter->nesting--;
+      }
+      break;
+    }
+  }
+  cutter->pos = i;
+}
+
+struct desugarer {
+  TSParser *parser;
+  TSSymbol open_brace;
+  TSSymbol close_brace;
+  TSSymbol semi;
+  FILE *output;
+  FILE *map;
+  size_t input_offset;
+  size_t output_offset;
+  // Whether a token was inserted since the last map entry.
+  bool map_pending;
+  size_t chunks;
+  size_t error_chunks;
+};
+
+// Copies chunk[from..to) to the output, first adding a map entry if the offset
+// between input and output has changed since the last one.
+static void copy_input(struct desugarer *desugarer, const char *chunk,
+                       size_t from, size_t to) {
+  if (to == from) {
+    return;
+  }
+  if (desugarer->map_pending && desugarer->map) {
+    fprintf(desugarer->map, "%zu %zu\n", desugarer->input_offset + from,
+            desugarer->output_offset);
+  }
+  desugarer->map_pending = false;
+  fwrite(chunk + from, 1, to - from, desugarer->output);
+  desugarer->output_offset += to - from;
+}
+
+static void insert_token(struct desugarer *desugarer, char token) {
+  fputc(token, desugarer->output);
+  desugarer->output_offset++;
+  desugarer->map_pending = true;
+}
+
+// Where desugar_chunk has got to in a chunk.
+struct chunk_state {
+  size_t copied;
+  // The position of an explicit '}' whose output is being held back, or
+  // SIZE_MAX.
+  size_t held;
+  unsigned held_closes;
+};
+
+// Writes out a held explicit '}'. The scanner lexes an explicit '}' as a
+// semicolon, followed by a virtual '}' for every layout block it closes, the
+// last of which is the one the explicit '{' opened. The others are closed
+// before the explicit '}'.
+static void flush_held_close(struct desugarer *desugarer, const char *chunk,
+                             struct chunk_state *state) {
+  copy_input(desugarer, chunk, state->copied, state->held);
+  for (unsigned i = 1; i < state->held_closes; i++) {
+    insert_token(desugarer, '}');
+  }
+  copy_input(desugarer, chunk, state->held, state->held + 1);
+  state->copied = state->held + 1;
+  state->held = SIZE_MAX;
+}
+
+static void desugar_leaf(struct desugarer *desugarer, const char *chunk,
+                         struct chunk_state *state, TSNode node) {
+  // Virtual tokens are the zero-width ones; explicit braces and semicolons
+  // have a width of one. MISSING tokens from error recovery are left out.
+  TSSymbol symbol = ts_node_symbol(node);
+  uint32_t start = ts_node_start_byte(node);
+  uint32_t end = ts_node_end_byte(node);
+  bool is_layout = symbol == desugarer->open_brace ||
+                   symbol == desugarer->close_brace || symbol == desugarer->semi;
+  bool is_virtual = is_layout && start == end && !ts_node_is_missing(node);
+
+  if (state->held != SIZE_MAX) {
+    if (is_virtual && start == state->held + 1) {
+      if (symbol == desugarer->close_brace) {
+        state->held_closes++;
+      }
+      return;
+    }
+    flush_held_close(desugarer, chunk, state);
+  }
+
+  if (symbol == desugarer->semi && end == start + 1 && chunk[start] == '}') {
+    state->held = start;
+    state->held_closes = 0;
+  } else if (is_virtual) {
+    copy_input(desugarer, chunk, state->copied, start);
+    state->copied = start;
+    insert_token(desugarer, symbol == desugarer->open_brace    ? '{'
+                            : symbol == desugarer->close_brace ? '}'
+                                                               : ';');
+  }
+}
+
+// Parses chunk, which starts at input_offset, and writes it out with the
+// virtual tokens of its tree inserted.
+static void desugar_chunk(struct desugarer *desugarer, const char *chunk,
+                          size_t len) {
+  TSTree *tree =
+      ts_parser_parse_string(desugarer->parser, NULL, chunk, (uint32_t)len);
+  TSNode root = ts_tree_root_node(tree);
+  desugarer->chunks++;
+  if (ts_node_has_error(root)) {
+    desugarer->error_chunks++;
+  }
+
+  struct chunk_state state = {.copied = 0, .held = SIZE_MAX};
+  TSTreeCursor cursor = ts_tree_cursor_new(root);
+  bool walking = true;
+  while (walking) {
+    TSNode node = ts_tree_cursor_current_node(&cursor);
+    if (ts_tree_cursor_goto_first_child(&cursor)) {
+      continue;
+    }
+    desugar_leaf(desugarer, chunk, &state, node);
+
+    while (!ts_tree_cursor_goto_next_sibling(&cursor)) {
+      if (!ts_tree_cursor_goto_parent(&cursor)) {
+        walking = false;
+        break;
+      }
+    }
+  }
+
+  if (state.held != SIZE_MAX) {
+    flush_held_close(desugarer, chunk, &state);
+  }
+  copy_input(desugarer, chunk, state.copied, len);
+  desugarer->input_offset += len;
+  ts_tree_cursor_delete(&cursor);
+  ts_tree_delete(tree);
+}
+
+static void usage(const char *program) {
+  fprintf(stderr,
+          "usage: %s [-m map] [-c chunk-size] [-s] [input [output]]\n",
+          program);
+}
+
+int main(int argc, char **argv) {
+  const char *map_path = NULL;
+  size_t chunk_size = 1 << 20;
+  bool stats = false;
+
+  int arg = 1;
+  for (; arg < argc && argv[arg][0] == '-' && argv[arg][1] != '\0'; arg++) {
+    if (strcmp(argv[arg], "-s") == 0) {
+      stats = true;
+      continue;
+    }
+    if (arg + 1 >= argc) {
+      usage(argv[0]);
+      return 1;
+    }
+    if (strcmp(argv[arg], "-m") == 0) {
+      map_path = argv[++arg];
+    } else if (strcmp(argv[arg], "-c") == 0) {
+      chunk_size = (size_t)strtoull(argv[++arg], NULL, 10);
+    } else {
+      usage(argv[0]);
+      return 1;
+    }
+  }
+  if (argc - arg > 2 || chunk_size == 0) {
+    usage(argv[0]);
+    return 1;
+  }
+
+  FILE *input = stdin;
+  if (arg < argc && strcmp(argv[arg], "-") != 0 &&
+      !(input = fopen(argv[arg], "rb"))) {
+    fprintf(stderr, "could not open %s\n", argv[arg]);
+    return 1;
+  }
+  arg++;
+  FILE *output = stdout;
+  if (arg < argc && !(output = fopen(argv[arg], "wb"))) {
+    fprintf(stderr, "could not open %s\n", argv[arg]);
+    return 1;
+  }
+  FILE *map = NULL;
+  if (map_path && !(map = fopen(map_path, "w"))) {
+    fprintf(stderr, "could not open %s\n", map_path);
+    return 1;
+  }
+  setvbuf(output, NULL, _IOFBF, 1 << 16);
+
+  const TSLanguage *language = tree_sitter_koka();
+  struct desugarer desugarer = {
+      .parser = ts_parser_new(),
+      .open_brace = ts_language_symbol_for_name(language, "{", 1, false),
+      .close_brace = ts_language_symbol_for_name(language, "}", 1, false),
+      .semi = ts_language_symbol_for_name(language, ";", 1, false),
+      .output = output,
+      .map = map,
+  };
+  ts_parser_set_language(desugarer.parser, language);
+  if (map) {
+    fprintf(map, "0 0\n");
+  }
+
+  double start = now();
+  struct cutter cutter = {.raw_pounds = -1};
+  size_t cap = chunk_size + READ_SIZE;
+  char *data = malloc(cap);
+  size_t len = 0;
+  while (true) {
+    if (cap - len < READ_SIZE) {
+      cap *= 2;
+      data = realloc(data, cap);
+    }
+    size_t read = fread(data + len, 1, READ_SIZE, input);
+    len += read;
+    bool at_eof = read == 0;
+    cutter_scan(&cutter, data, len, at_eof);
+
+    if (at_eof) {
+      if (len > 0) {
+        desugar_chunk(&desugarer, data, len);
+      }
+      break;
+    }
+    if (len >= chunk_size && cutter.cut > 0) {
+      size_t cut = cutter.cut;
+      desugar_chunk(&desugarer, data, cut);
+      memmove(data, data + cut, len - cut);
+      len -= cut;
+      cutter.pos -= cut;
+      cutter.cut = 0;
+    }
+  }
+  double seconds = now() - start;
+
+  if (ferror(input) || fflush(output) != 0) {
+    fprintf(stderr, "I/O error\n");
+    return 1;
+  }
+  if (desugarer.error_chunks > 0) {
+    fprintf(stderr, "warning: %zu of %zu chunks have syntax errors\n",
+            desugarer.error_chunks, desugarer.chunks);
+  }
+  if (stats) {
+    fprintf(stderr, "%zu bytes in, %zu bytes out, %zu chunks\n",
+            desugarer.input_offset, desugarer.output_offset, desugarer.chunks);
+    fprintf(stderr, "%.3f s, %.1f MB/s\n", seconds,
+            (double)desugarer.input_offset / 1e6 / seconds);
+  }
+
+  free(data);
+  ts_parser_delete(desugarer.parser);
+  if (map) {
+    fclose(map);
+  }
+  if (output != stdout) {
+    fclose(output);
+  }
+  if (input != stdin) {
+    fclose(input);
+  }
+  return 0;
+}
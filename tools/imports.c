@@ -0,0 +1,453 @@
+// Extracts the import graph of a workspace of Koka modules, for build
+// schedulers that need to know what to build first.
+//
+// Only the header of each file is parsed, with tree_sitter_koka_parse_header,
+// so the rest of the file is never lexed. Files are read and parsed on several
+// threads, each with its own parser.
+//
+// Usage: koka-imports [-j threads] [-t] [-s] path...
+//
+// Each path is a .kk file or a directory that is searched recursively for
+// .kk files. A module is named by its module declaration, or else by its path
+// relative to the directory it was found in, without the extension. By
+// default, a line of "module: import..." is printed for every module. With
+// -t, the modules of the workspace are printed in an order in which every
+// module comes after the modules it imports; imports of modules outside the
+// workspace are left out, and import cycles are reported on stderr. -j sets
+// the number of threads, which defaults to the number of processors. -s
+// prints statistics to stderr.
+
+#define _POSIX_C_SOURCE 200809L
+
+#include "tree-sitter-koka-utils.h"
+#include "tree-sitter-koka.h"
+#include <dirent.h>
+#include <pthread.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/stat.h>
+#include <time.h>
+#include <tree_sitter/api.h>
+#include <unistd.h>
+
+struct module {
+  char *path;
+  // The name derived from the path, until the header has been parsed.
+  char *name;
+  char **imports;
+  uint32_t import_count;
+  // Bytes in the file and in its header.
+  size_t size;
+  size_t header_size;
+  bool unreadable;
+};
+
+struct workspace {
+  struct module *modules;
+  size_t len;
+  size_t cap;
+};
+
+struct worker {
+  struct workspace *workspace;
+  pthread_mutex_t *mutex;
+  size_t *next;
+};
+
+static double now(void) {
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (double)ts.tv_sec + (double)ts.tv_nsec / 1e9;
+}
+
+static bool has_suffix(const char *s, const char *suffix) {
+  size_t s_len = strlen(s), suffix_len = strlen(suffix);
+  return s_len >= suffix_len && strcmp(s + s_len - suffix_len, suffix) == 0;
+}
+
+static char *read_file(const char *path, size_t *len) {
+  FILE *file = fopen(path, "rb");
+  if (!file) {
+    return NULL;
+  }
+  fseek(file, 0, SEEK_END);
+  long size = ftell(file);
+  fseek(file, 0, SEEK_SET);
+  char *text = malloc((size_t)size + 1);
+  if (!text || fread(text, 1, (size_t)size, file) != (size_t)size) {
+    free(text);
+    fclose(file);
+    return NULL;
+  }
+  fclose(file);
+  text[size] = '\0';
+  *len = (size_t)size;
+  return text;
+}
+
+static char *join_path(const char *dir, const char *name) {
+  size_t len = strlen(dir) + strlen(name) + 2;
+  char *path = malloc(len);
+  snprintf(path, len, "%s/%s", dir, name);
+  return path;
+}
+
+static char *copy_text(const char *text, size_t len) {
+  char *copy = malloc(len + 1);
+  memcpy(copy, text, len);
+  copy[len] = '\0';
+  return copy;
+}
+
+static void workspace_add(struct workspace *workspace, const char *path,
+                          const char *name) {
+  if (workspace->len == workspace->cap) {
+    workspace->cap = workspace->cap == 0 ? 64 : workspace->cap * 2;
+    workspace->modules =
+        realloc(workspace->modules, sizeof(struct module) * workspace->cap);
+  }
+  size_t name_len = strlen(name);
+  if (has_suffix(name, ".kk")) {
+    name_len -= 3;
+  }
+  workspace->modules[workspace->len++] = (struct module){
+      .path = strdup(path),
+      .name = copy_text(name, name_len),
+  };
+}
+
+// Adds the .kk files under path, naming them by their path relative to root.
+static void workspace_add_path(struct workspace *workspace, const char *path,
+                               size_t root_len) {
+  struct stat st;
+  if (stat(path, &st) != 0) {
+    fprintf(stderr, "warning: could not stat %s\n", path);
+    return;
+  }
+  if (!S_ISDIR(st.st_mode)) {
+    const char *name = path + root_len;
+    if (root_len == 0) {
+      const char *slash = strrchr(path, '/');
+      name = slash ? slash + 1 : path;
+    }
+    workspace_add(workspace, path, name);
+    return;
+  }
+
+  DIR *dir = opendir(path);
+  if (!dir) {
+    return;
+  }
+  struct dirent *entry;
+  while ((entry = readdir(dir))) {
+    if (entry->d_name[0] == '.') {
+      continue;
+    }
+    char *child = join_path(path, entry->d_name);
+    if (stat(child, &st) == 0 &&
+        (S_ISDIR(st.st_mode) || has_suffix(entry->d_name, ".kk"))) {
+      workspace_add_path(workspace, child,
+                         root_len == 0 ? strlen(path) + 1 : root_len);
+    }
+    free(child);
+  }
+  closedir(dir);
+}
+
+static char *node_text(const char *text, TSNode node) {
+  uint32_t start = ts_node_start_byte(node);
+  return copy_text(text + start, ts_node_end_byte(node) - start);
+}
+
+static void parse_header(struct module *module, TSParser *parser,
+                         TSSymbol modulepath, TSSymbol modulebody,
+                         TSSymbol importdecl) {
+  size_t len;
+  char *text = read_file(module->path, &len);
+  if (!text) {
+    module->unreadable = true;
+    return;
+  }
+  module->size = len;
+  module->header_size =
+      tree_sitter_koka_header_length(text, (uint32_t)len);
+  TSTree *tree = tree_sitter_koka_parse_header(parser, text, (uint32_t)len);
+
+  // The module's name is the modulepath of the program, and the imports are
+  // in its modulebody children.
+  TSNode root = ts_tree_root_node(tree);
+  uint32_t count = ts_node_named_child_count(root);
+  uint32_t import_cap = 0;
+  for (uint32_t i = 0; i < count; i++) {
+    TSNode child = ts_node_named_child(root, i);
+    if (ts_node_symbol(child) == modulepath) {
+      free(module->name);
+      module->name = node_text(text, child);
+      continue;
+    }
+    if (ts_node_symbol(child) != modulebody) {
+      continue;
+    }
+
+    uint32_t body_count = ts_node_named_child_count(child);
+    for (uint32_t j = 0; j < body_count; j++) {
+      TSNode decl = ts_node_named_child(child, j);
+      if (ts_node_symbol(decl) != importdecl) {
+        continue;
+      }
+      // The module is the last path, after an optional alias.
+      uint32_t paths = ts_node_named_child_count(decl);
+      if (paths == 0) {
+        continue;
+      }
+      if (module->import_count == import_cap) {
+        import_cap = import_cap == 0 ? 8 : import_cap * 2;
+        module->imports =
+            realloc(module->imports, sizeof(char *) * import_cap);
+      }
+      module->imports[module->import_count++] =
+          node_text(text, ts_node_named_child(decl, paths - 1));
+    }
+  }
+
+  ts_tree_delete(tree);
+  free(text);
+}
+
+static void *work(void *arg) {
+  struct worker *worker = arg;
+  const TSLanguage *language = tree_sitter_koka();
+  TSParser *parser = ts_parser_new();
+  ts_parser_set_language(parser, language);
+  TSSymbol modulepath =
+      ts_language_symbol_for_name(language, "modulepath", 10, true);
+  TSSymbol modulebody =
+      ts_language_symbol_for_name(language, "modulebody", 10, true);
+  TSSymbol importdecl =
+      ts_language_symbol_for_name(language, "importdecl", 10, true);
+
+  while (true) {
+    pthread_mutex_lock(worker->mutex);
+    size_t index = (*worker->next)++;
+    pthread_mutex_unlock(worker->mutex);
+    if (index >= worker->workspace->len) {
+      break;
+    }
+    parse_header(&worker->workspace->modules[index], parser, modulepath,
+                 modulebody, importdecl);
+  }
+
+  ts_parser_delete(parser);
+  return NULL;
+}
+
+// Maps module names to their index in the workspace.
+struct name_table {
+  size_t *slots;
+  size_t mask;
+};
+
+static uint64_t hash_name(const char *name) {
+  uint64_t hash = 14695981039346656037u;
+  for (; *name; name++) {
+    hash = (hash ^ (unsigned char)*name) * 1099511628211u;
+  }
+  return hash;
+}
+
+static void name_table_init(struct name_table *table,
+                            const struct workspace *workspace) {
+  size_t cap = 16;
+  while (cap < workspace->len * 2) {
+    cap *= 2;
+  }
+  table->slots = malloc(sizeof(size_t) * cap);
+  table->mask = cap - 1;
+  for (size_t i = 0; i < cap; i++) {
+    table->slots[i] = SIZE_MAX;
+  }
+  for (size_t i = 0; i < workspace->len; i++) {
+    size_t slot = hash_name(workspace->modules[i].name) & table->mask;
+    while (table->slots[slot] != SIZE_MAX) {
+      if (strcmp(workspace->modules[table->slots[slot]].name,
+                 workspace->modules[i].name) == 0) {
+        fprintf(stderr, "warning: %s and %s are both module %s\n",
+                workspace->modules[table->slots[slot]].path,
+                workspace->modules[i].path, workspace->modules[i].name);
+        break;
+      }
+      slot = (slot + 1) & table->mask;
+    }
+    if (table->slots[slot] == SIZE_MAX) {
+      table->slots[slot] = i;
+    }
+  }
+}
+
+static size_t name_table_find(const struct name_table *table,
+                              const struct workspace *workspace,
+                              const char *name) {
+  size_t slot = hash_name(name) & table->mask;
+  while (table->slots[slot] != SIZE_MAX &&
+         strcmp(workspace->modules[table->slots[slot]].name, name) != 0) {
+    slot = (slot + 1) & table->mask;
+  }
+  return table->slots[slot];
+}
+
+enum { UNVISITED, VISITING, VISITED };
+
+// Prints the modules that module imports and then module itself, depth
+// first. Returns false if an import cycle was found.
+static bool print_in_order(const struct workspace *workspace,
+                           const struct name_table *table, uint8_t *states,
+                           size_t *stack, size_t depth, size_t module) {
+  if (states[module] == VISITED) {
+    return true;
+  }
+  stack[depth] = module;
+  if (states[module] == VISITING) {
+    fprintf(stderr, "import cycle:");
+    size_t start = depth;
+    while (stack[start - 1] != module) {
+      start--;
+    }
+    for (size_t i = start - 1; i <= depth; i++) {
+      fprintf(stderr, " %s", workspace->modules[stack[i]].name);
+    }
+    fprintf(stderr, "\n");
+    return false;
+  }
+
+  states[module] = VISITING;
+  bool ok = true;
+  const struct module *m = &workspace->modules[module];
+  for (uint32_t i = 0; i < m->import_count; i++) {
+    size_t import = name_table_find(table, workspace, m->imports[i]);
+    if (import != SIZE_MAX &&
+        !print_in_order(workspace, table, states, stack, depth + 1, import)) {
+      ok = false;
+    }
+  }
+  states[module] = VISITED;
+  printf("%s\n", m->name);
+  return ok;
+}
+
+static int compare_by_name(const void *a, const void *b) {
+  return strcmp(((const struct module *)a)->name,
+                ((const struct module *)b)->name);
+}
+
+static void usage(const char *program) {
+  fprintf(stderr, "usage: %s [-j threads] [-t] [-s] path...\n", program);
+}
+
+int main(int argc, char **argv) {
+  long threads = sysconf(_SC_NPROCESSORS_ONLN);
+  if (threads < 1) {
+    threads = 1;
+  }
+  bool order = false;
+  bool stats = false;
+
+  int arg = 1;
+  for (; arg < argc && argv[arg][0] == '-'; arg++) {
+    if (strcmp(argv[arg], "-t") == 0) {
+      order = true;
+    } else if (strcmp(argv[arg], "-s") == 0) {
+      stats = true;
+    } else if (strcmp(argv[arg], "-j") == 0 && arg + 1 < argc) {
+      threads = atol(argv[++arg]);
+    } else {
+      usage(argv[0]);
+      return 1;
+    }
+  }
+  if (arg == argc || threads < 1) {
+    usage(argv[0]);
+    return 1;
+  }
+
+  double start = now();
+  struct workspace workspace = {0};
+  for (; arg < argc; arg++) {
+    workspace_add_path(&workspace, argv[arg], 0);
+  }
+  if ((size_t)threads > workspace.len) {
+    threads = workspace.len > 0 ? (long)workspace.len : 1;
+  }
+
+  pthread_mutex_t mutex = PTHREAD_MUTEX_INITIALIZER;
+  size_t next = 0;
+  struct worker worker = {&workspace, &mutex, &next};
+  pthread_t *ids = malloc(sizeof(pthread_t) * (size_t)threads);
+  for (long i = 0; i < threads; i++) {
+    pthread_create(&ids[i], NULL, work, &worker);
+  }
+  for (long i = 0; i < threads; i++) {
+    pthread_join(ids[i], NULL);
+  }
+  free(ids);
+  double parsed = now() - start;
+
+  qsort(workspace.modules, workspace.len, sizeof(struct module),
+        compare_by_name);
+  struct name_table table;
+  name_table_init(&table, &workspace);
+
+  int status = 0;
+  if (order) {
+    uint8_t *states = calloc(workspace.len, 1);
+    size_t *stack = malloc(sizeof(size_t) * (workspace.len + 1));
+    for (size_t i = 0; i < workspace.len; i++) {
+      if (!print_in_order(&workspace, &table, states, stack, 0, i)) {
+        status = 1;
+      }
+    }
+    free(stack);
+    free(states);
+  } else {
+    for (size_t i = 0; i < workspace.len; i++) {
+      const struct module *module = &workspace.modules[i];
+      if (module->unreadable) {
+        continue;
+      }
+      printf("%s:", module->name);
+      for (uint32_t j = 0; j < module->import_count; j++) {
+        printf(" %s", module->imports[j]);
+      }
+      printf("\n");
+    }
+  }
+
+  size_t total = 0, headers = 0;
+  for (size_t i = 0; i < workspace.len; i++) {
+    struct module *module = &workspace.modules[i];
+    if (module->unreadable) {
+      fprintf(stderr, "warning: could not read %s\n", module->path);
+      status = 1;
+    }
+    total += module->size;
+    headers += module->header_size;
+    for (uint32_t j = 0; j < module->import_count; j++) {
+      free(module->imports[j]);
+    }
+    free(module->imports);
+    free(module->name);
+    free(module->path);
+  }
+  free(workspace.modules);
+  free(table.slots);
+
+  if (stats) {
+    fprintf(stderr, "%zu modules, %zu of %zu bytes parsed, %ld threads\n",
+            workspace.len, headers, total, threads);
+    fprintf(stderr, "%.3f ms reading and parsing, %.3f ms total\n",
+            parsed * 1e3, (now() - start) * 1e3);
+  }
+  return status;
+}
@@ -0,0 +1,1375 @@
+// A minimal language server for editors without native tree-sitter support.
+//
+// It speaks JSON-RPC over stdin and stdout and keeps a parse tree per open
+// document. Edits are synced incrementally: every textDocument/didChange
+// edits the old tree and reparses with it, so only the edited part of the
+// document is lexed again. After each change, the ERROR and MISSING nodes of
+// the tree are published as diagnostics. Document symbols, folding ranges and
+// full semantic tokens are served on request, the latter from the bundled
+// highlights query.
+//
+// Usage: koka-lsp
+//        koka-lsp -b file.kk [-n edits]
+//
+// With -b, no client is needed: the file is opened and -n edits (1000 by
+// default) are made to it through the same didChange handling, typing and
+// then deleting a character at the end of lines throughout the file, and the
+// latency of each is reported, split into reparsing and everything else. The
+// server's messages are written to /dev/null.
+
+#define _POSIX_C_SOURCE 200809L
+
+#include "tree-sitter-koka-utils.h"
+#include "tree-sitter-koka.h"
+#include <errno.h>
+#include <stdarg.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <tree_sitter/api.h>
+
+// The most diagnostics published for a document, since a broken file can
+// have an error on every line.
+#define MAX_DIAGNOSTICS 100
+
+// The deepest nesting of JSON values that's parsed.
+#define MAX_JSON_DEPTH 64
+
+// The longest message body that's read. Longer messages are skipped, rather
+// than trusting the client with the size of an allocation.
+#define MAX_MESSAGE_LENGTH (64 * 1024 * 1024)
+
+static double now(void) {
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (double)ts.tv_sec + (double)ts.tv_nsec / 1e9;
+}
+
+// Output buffers
+
+struct buffer {
+  char *data;
+  size_t len;
+  size_t cap;
+};
+
+static void buffer_append(struct buffer *buffer, const char *data,
+                          size_t len) {
+  if (buffer->len + len + 1 > buffer->cap) {
+    buffer->cap = buffer->cap == 0 ? 4096 : buffer->cap * 2;
+    while (buffer->len + len + 1 > buffer->cap) {
+      buffer->cap *= 2;
+    }
+    buffer->data = realloc(buffer->data, buffer->cap);
+  }
+  memcpy(buffer->data + buffer->len, data, len);
+  buffer->len += len;
+  buffer->data[buffer->len] = '\0';
+}
+
+static void buffer_puts(struct buffer *buffer, const char *text) {
+  buffer_append(buffer, text, strlen(text));
+}
+
+static void buffer_printf(struct buffer *buffer, const char *format, ...) {
+  char text[256];
+  va_list args;
+  va_start(args, format);
+  int len = vsnprintf(text, sizeof(text), format, args);
+  va_end(args);
+  buffer_append(buffer, text, (size_t)len < sizeof(text) ? (size_t)len
+                                                          : sizeof(text) - 1);
+}
+
+static void buffer_put_string(struct buffer *buffer, const char *text,
+                              size_t len) {
+  buffer_append(buffer, "\"", 1);
+  size_t copied = 0;
+  for (size_t i = 0; i < len; i++) {
+    unsigned char c = (unsigned char)text[i];
+    if (c >= 0x20 && c != '"' && c != '\\') {
+      continue;
+    }
+    buffer_append(buffer, text + copied, i - copied);
+    copied = i + 1;
+    if (c == '"' || c == '\\') {
+      char escape[2] = {'\\', (char)c};
+      buffer_append(buffer, escape, 2);
+    } else if (c == '\n') {
+      buffer_append(buffer, "\\n", 2);
+    } else {
+      buffer_printf(buffer, "\\u%04x", c);
+    }
+  }
+  buffer_append(buffer, text + copied, len - copied);
+  buffer_append(buffer, "\"", 1);
+}
+
+// JSON values
+//
+// Messages are parsed into a tree of values allocated from an arena that's
+// freed once the message has been handled. Strings are decoded; the source
+// text of every value is kept too, so request ids can be echoed verbatim.
+
+enum json_type {
+  JSON_NULL,
+  JSON_BOOL,
+  JSON_NUMBER,
+  JSON_STRING,
+  JSON_ARRAY,
+  JSON_OBJECT,
+};
+
+struct json_member;
+
+struct json {
+  enum json_type type;
+  const char *raw;
+  size_t raw_len;
+  bool boolean;
+  double number;
+  const char *string;
+  size_t string_len;
+  // The elements of an array, or the members of an object.
+  struct json *items;
+  struct json_member *members;
+  size_t count;
+};
+
+struct json_member {
+  const char *key;
+  size_t key_len;
+  struct json value;
+};
+
+struct arena_block {
+  struct arena_block *next;
+  size_t used;
+  size_t size;
+  char data[];
+};
+
+struct arena {
+  struct arena_block *blocks;
+};
+
+static void *arena_alloc(struct arena *arena, size_t size) {
+  size = (size + 15) & ~(size_t)15;
+  struct arena_block *block = arena->blocks;
+  if (!block || block->used + size > block->size) {
+    size_t block_size = size > 65536 ? size : 65536;
+    block = malloc(sizeof(struct arena_block) + block_size);
+    block->next = arena->blocks;
+    block->used = 0;
+    block->size = block_size;
+    arena->blocks = block;
+  }
+  void *result = block->data + block->used;
+  block->used += size;
+  return result;
+}
+
+static void arena_clear(struct arena *arena) {
+  while (arena->blocks) {
+    struct arena_block *next = arena->blocks->next;
+    free(arena->blocks);
+    arena->blocks = next;
+  }
+}
+
+struct json_parser {
+  const char *text;
+  size_t len;
+  size_t pos;
+  struct arena *arena;
+};
+
+static void skip_space(struct json_parser *p) {
+  while (p->pos < p->len &&
+         (p->text[p->pos] == ' ' || p->text[p->pos] == '\t' ||
+          p->text[p->pos] == '\n' || p->text[p->pos] == '\r')) {
+    p->pos++;
+  }
+}
+
+static bool parse_hex(struct json_parser *p, uint32_t *value) {
+  if (p->pos + 4 > p->len) {
+    return false;
+  }
+  *value = 0;
+  for (int i = 0; i < 4; i++) {
+    char c = p->text[p->pos++];
+    uint32_t digit;
+    if (c >= '0' && c <= '9') {
+      digit = (uint32_t)(c - '0');
+    } else if (c >= 'a' && c <= 'f') {
+      digit = (uint32_t)(c - 'a' + 10);
+    } else if (c >= 'A' && c <= 'F') {
+      digit = (uint32_t)(c - 'A' + 10);
+    } else {
+      return false;
+    }
+    *value = *value * 16 + digit;
+  }
+  return true;
+}
+
+static size_t encode_utf8(uint32_t code_point, char *out) {
+  if (code_point < 0x80) {
+    out[0] = (char)code_point;
+    return 1;
+  }
+  if (code_point < 0x800) {
+    out[0] = (char)(0xC0 | (code_point >> 6));
+    out[1] = (char)(0x80 | (code_point & 0x3F));
+    return 2;
+  }
+  if (code_point < 0x10000) {
+    out[0] = (char)(0xE0 | (code_point >> 12));
+    out[1] = (char)(0x80 | ((code_point >> 6) & 0x3F));
+    out[2] = (char)(0x80 | (code_point & 0x3F));
+    return 3;
+  }
+  out[0] = (char)(0xF0 | (code_point >> 18));
+  out[1] = (char)(0x80 | ((code_point >> 12) & 0x3F));
+  out[2] = (char)(0x80 | ((code_point >> 6) & 0x3F));
+  out[3] = (char)(0x80 | (code_point & 0x3F));
+  return 4;
+}
+
+// Parses a string after its opening quote.
+static bool parse_string(struct json_parser *p, const char **string,
+                         size_t *string_len) {
+  // Decoding never makes a string longer.
+  size_t end = p->pos;
+  while (end < p->len && p->text[end] != '"') {
+    end += p->text[end] == '\\' ? 2 : 1;
+  }
+  if (end >= p->len) {
+    return false;
+  }
+  char *out = arena_alloc(p->arena, end - p->pos + 1);
+  size_t len = 0;
+  while (p->text[p->pos] != '"') {
+    char c = p->text[p->pos++];
+    if (c != '\\') {
+      out[len++] = c;
+      continue;
+    }
+    c = p->text[p->pos++];
+    switch (c) {
+    case 'b':
+      out[len++] = '\b';
+      break;
+    case 'f':
+      out[len++] = '\f';
+      break;
+    case 'n':
+      out[len++] = '\n';
+      break;
+    case 'r':
+      out[len++] = '\r';
+      break;
+    case 't':
+      out[len++] = '\t';
+      break;
+    case 'u': {
+      uint32_t code_point, low;
+      if (!parse_hex(p, &code_point)) {
+        return false;
+      }
+      if (code_point >= 0xD800 && code_point < 0xDC00 &&
+          p->pos + 6 <= p->len && p->text[p->pos] == '\\' &&
+          p->text[p->pos + 1] == 'u') {
+        p->pos += 2;
+        if (!parse_hex(p, &low)) {
+          return false;
+        }
+        code_point = 0x10000 + ((code_point - 0xD800) << 10) + (low - 0xDC00);
+      }
+      len += encode_utf8(code_point, out + len);
+      break;
+    }
+    default:
+      out[len++] = c;
+      break;
+    }
+  }
+  p->pos++;
+  out[len] = '\0';
+  *string = out;
+  *string_len = len;
+  return true;
+}
+
+static bool parse_value(struct json_parser *p, struct json *value,
+                        int depth) {
+  *value = (struct json){0};
+  skip_space(p);
+  if (p->pos >= p->len || depth > MAX_JSON_DEPTH) {
+    return false;
+  }
+  size_t start = p->pos;
+  char c = p->text[p->pos];
+  bool ok = true;
+
+  if (c == '{' || c == '[') {
+    char close = c == '{' ? '}' : ']';
+    value->type = c == '{' ? JSON_OBJECT : JSON_ARRAY;
+    p->pos++;
+    // Elements are gathered on the heap, then moved into the arena.
+    size_t cap = 0;
+    struct json_member *members = NULL;
+    skip_space(p);
+    if (p->pos < p->len && p->text[p->pos] == close) {
+      p->pos++;
+    } else {
+      while (ok) {
+        if (value->count == cap) {
+          cap = cap == 0 ? 8 : cap * 2;
+          members = realloc(members, sizeof(struct json_member) * cap);
+        }
+        struct json_member *member = &members[value->count++];
+        *member = (struct json_member){0};
+        if (value->type == JSON_OBJECT) {
+          skip_space(p);
+          ok = p->pos < p->len && p->text[p->pos++] == '"' &&
+               parse_string(p, &member->key, &member->key_len);
+          skip_space(p);
+          ok = ok && p->pos < p->len && p->text[p->pos++] == ':';
+        }
+        ok = ok && parse_value(p, &member->value, depth + 1);
+        skip_space(p);
+        if (!ok || p->pos >= p->len) {
+          ok = false;
+        } else if (p->text[p->pos] == close) {
+          p->pos++;
+          break;
+        } else if (p->text[p->pos++] != ',') {
+          ok = false;
+        }
+      }
+    }
+    if (value->type == JSON_OBJECT) {
+      value->members =
+          arena_alloc(p->arena, sizeof(struct json_member) * value->count);
+      memcpy(value->members, members,
+             sizeof(struct json_member) * value->count);
+    } else {
+      value->items = arena_alloc(p->arena, sizeof(struct json) * value->count);
+      for (size_t i = 0; i < value->count; i++) {
+        value->items[i] = members[i].value;
+      }
+    }
+    free(members);
+  } else if (c == '"') {
+    value->type = JSON_STRING;
+    p->pos++;
+    ok = parse_string(p, &value->string, &value->string_len);
+  } else if (c == 't' || c == 'f' || c == 'n') {
+    const char *word = c == 't' ? "true" : c == 'f' ? "false" : "null";
+    size_t word_len = strlen(word);
+    ok = p->pos + word_len <= p->len &&
+         memcmp(p->text + p->pos, word, word_len) == 0;
+    p->pos += word_len;
+    value->type = c == 'n' ? JSON_NULL : JSON_BOOL;
+    value->boolean = c == 't';
+  } else {
+    value->type = JSON_NUMBER;
+    char *end;
+    value->number = strtod(p->text + p->pos, &end);
+    ok = end != p->text + p->pos;
+    p->pos = (size_t)(end - p->text);
+  }
+
+  value->raw = p->text + start;
+  value->raw_len = p->pos - start;
+  return ok;
+}
+
+static const struct json *json_get(const struct json *object,
+                                   const char *key) {
+  if (!object || object->type != JSON_OBJECT) {
+    return NULL;
+  }
+  size_t key_len = strlen(key);
+  for (size_t i = 0; i < object->count; i++) {
+    if (object->members[i].key_len == key_len &&
+        memcmp(object->members[i].key, key, key_len) == 0) {
+      return &object->members[i].value;
+    }
+  }
+  return NULL;
+}
+
+static bool json_is(const struct json *value, const char *string) {
+  return value && value->type == JSON_STRING &&
+         value->string_len == strlen(string) &&
+         memcmp(value->string, string, value->string_len) == 0;
+}
+
+static uint32_t json_uint(const struct json *value) {
+  return value && value->type == JSON_NUMBER && value->number > 0
+             ? (uint32_t)value->number
+             : 0;
+}
+
+// Documents
+
+struct document {
+  char *uri;
+  char *text;
+  uint32_t len;
+  uint32_t cap;
+  // The byte offset of the start of each line.
+  uint32_t *lines;
+  uint32_t line_count;
+  uint32_t line_cap;
+  TSTree *tree;
+};
+
+struct server {
+  TSParser *parser;
+  TSQuery *highlights;
+  // The semantic token type of each highlights capture, or -1.
+  int32_t *capture_token_types;
+  struct document *documents;
+  size_t document_count;
+  size_t document_cap;
+  // Whether positions count UTF-8 bytes rather than UTF-16 code units.
+  bool utf8_positions;
+  bool shut_down;
+  // Where messages are written.
+  FILE *output;
+  struct buffer message;
+  // The time spent reparsing documents, which benchmarks report separately
+  // from the rest of the handling.
+  double parse_seconds;
+};
+
+// Recomputes the line starts from the line holding byte onwards.
+static void update_lines(struct document *doc, uint32_t byte) {
+  uint32_t line = 0;
+  while (line + 1 < doc->line_count && doc->lines[line + 1] <= byte) {
+    line++;
+  }
+  doc->line_count = line + 1;
+  const char *text = doc->text;
+  const char *end = text + doc->len;
+  const char *p = text + doc->lines[line];
+  while ((p = memchr(p, '\n', (size_t)(end - p)))) {
+    p++;
+    if (doc->line_count == doc->line_cap) {
+      doc->line_cap *= 2;
+      doc->lines = realloc(doc->lines, sizeof(uint32_t) * doc->line_cap);
+    }
+    doc->lines[doc->line_count++] = (uint32_t)(p - text);
+  }
+}
+
+static uint32_t line_of_byte(const struct document *doc, uint32_t byte) {
+  uint32_t low = 0, high = doc->line_count;
+  while (high - low > 1) {
+    uint32_t middle = low + (high - low) / 2;
+    if (doc->lines[middle] <= byte) {
+      low = middle;
+    } else {
+      high = middle;
+    }
+  }
+  return low;
+}
+
+// The UTF-16 code units taken by the character with this leading byte.
+static uint32_t utf16_units(unsigned char c) {
+  if ((c & 0xC0) == 0x80) {
+    return 0;
+  }
+  return c >= 0xF0 ? 2 : 1;
+}
+
+// The number of position units in text[start, end).
+static uint32_t position_units(const struct server *server,
+                               const struct document *doc, uint32_t start,
+                               uint32_t end) {
+  if (server->utf8_positions) {
+    return end - start;
+  }
+  uint32_t units = 0;
+  for (uint32_t i = start; i < end; i++) {
+    units += utf16_units((unsigned char)doc->text[i]);
+  }
+  return units;
+}
+
+static uint32_t position_to_byte(const struct server *server,
+                                 const struct document *doc, uint32_t line,
+                                 uint32_t character) {
+  if (line >= doc->line_count) {
+    return doc->len;
+  }
+  uint32_t byte = doc->lines[line];
+  uint32_t line_end =
+      line + 1 < doc->line_count ? doc->lines[line + 1] - 1 : doc->len;
+  if (server->utf8_positions) {
+    return byte + character < line_end ? byte + character : line_end;
+  }
+  uint32_t units = 0;
+  while (byte < line_end && units < character) {
+    units += utf16_units((unsigned char)doc->text[byte++]);
+    while (byte < line_end &&
+           utf16_units((unsigned char)doc->text[byte]) == 0) {
+      byte++;
+    }
+  }
+  return byte;
+}
+
+static void put_position(struct server *server, const struct document *doc,
+                         uint32_t byte) {
+  uint32_t line = line_of_byte(doc, byte);
+  buffer_printf(&server->message, "{\"line\":%u,\"character\":%u}", line,
+                position_units(server, doc, doc->lines[line], byte));
+}
+
+static void put_range(struct server *server, const struct document *doc,
+                      uint32_t start, uint32_t end) {
+  buffer_puts(&server->message, "{\"start\":");
+  put_position(server, doc, start);
+  buffer_puts(&server->message, ",\"end\":");
+  put_position(server, doc, end);
+  buffer_puts(&server->message, "}");
+}
+
+static TSPoint point_of_byte(const struct document *doc, uint32_t byte) {
+  uint32_t line = line_of_byte(doc, byte);
+  return (TSPoint){line, byte - doc->lines[line]};
+}
+
+static struct document *find_document(struct server *server,
+                                      const struct json *uri) {
+  for (size_t i = 0; uri && i < server->document_count; i++) {
+    if (json_is(uri, server->documents[i].uri)) {
+      return &server->documents[i];
+    }
+  }
+  return NULL;
+}
+
+// Messages
+
+static void send_message(struct server *server) {
+  fprintf(server->output, "Content-Length: %zu\r\n\r\n", server->message.len);
+  fwrite(server->message.data, 1, server->message.len, server->output);
+  fflush(server->output);
+  server->message.len = 0;
+}
+
+static void begin_response(struct server *server, const struct json *id) {
+  buffer_puts(&server->message, "{\"jsonrpc\":\"2.0\",\"id\":");
+  buffer_append(&server->message, id->raw, id->raw_len);
+  buffer_puts(&server->message, ",\"result\":");
+}
+
+static void send_error(struct server *server, const struct json *id,
+                       int code, const char *text) {
+  buffer_puts(&server->message, "{\"jsonrpc\":\"2.0\",\"id\":");
+  buffer_append(&server->message, id->raw, id->raw_len);
+  buffer_printf(&server->message, ",\"error\":{\"code\":%d,\"message\":",
+                code);
+  buffer_put_string(&server->message, text, strlen(text));
+  buffer_puts(&server->message, "}}");
+  send_message(server);
+}
+
+// Diagnostics
+
+static void publish_diagnostics(struct server *server,
+                                const struct document *doc) {
+  struct buffer *out = &server->message;
+  buffer_puts(out, "{\"jsonrpc\":\"2.0\",\"method\":"
+                   "\"textDocument/publishDiagnostics\",\"params\":{\"uri\":");
+  buffer_put_string(out, doc->uri, strlen(doc->uri));
+  buffer_puts(out, ",\"diagnostics\":[");
+
+  // Only nodes that contain errors are descended into, so a file without
+  // errors costs nothing beyond the root.
+  uint32_t count = 0;
+  TSTreeCursor cursor = ts_tree_cursor_new(ts_tree_root_node(doc->tree));
+  bool done = !ts_node_has_error(ts_tree_root_node(doc->tree));
+  while (!done && count < MAX_DIAGNOSTICS) {
+    TSNode node = ts_tree_cursor_current_node(&cursor);
+    bool is_error = ts_node_is_error(node);
+    bool is_missing = ts_node_is_missing(node);
+    if (is_error || is_missing) {
+      buffer_puts(out, count > 0 ? ",{\"range\":" : "{\"range\":");
+      put_range(server, doc, ts_node_start_byte(node), ts_node_end_byte(node));
+      buffer_puts(out, ",\"severity\":1,\"source\":\"tree-sitter-koka\","
+                       "\"message\":");
+      if (is_missing) {
+        char text[128];
+        snprintf(text, sizeof(text), "missing %s", ts_node_type(node));
+        buffer_put_string(out, text, strlen(text));
+      } else {
+        buffer_puts(out, "\"syntax error\"");
+      }
+      buffer_puts(out, "}");
+      count++;
+    }
+
+    if (!is_error && ts_node_has_error(node) &&
+        ts_tree_cursor_goto_first_child(&cursor)) {
+      continue;
+    }
+    while (!ts_tree_cursor_goto_next_sibling(&cursor)) {
+      if (!ts_tree_cursor_goto_parent(&cursor)) {
+        done = true;
+        break;
+      }
+    }
+  }
+  ts_tree_cursor_delete(&cursor);
+
+  buffer_puts(out, "]}}");
+  send_message(server);
+}
+
+// Text synchronization
+
+static void open_document(struct server *server, const struct json *item) {
+  const struct json *uri = json_get(item, "uri");
+  const struct json *text = json_get(item, "text");
+  if (!uri || uri->type != JSON_STRING || !text ||
+      text->type != JSON_STRING) {
+    return;
+  }
+  struct document *doc = find_document(server, uri);
+  if (!doc) {
+    if (server->document_count == server->document_cap) {
+      server->document_cap =
+          server->document_cap == 0 ? 8 : server->document_cap * 2;
+      server->documents =
+          realloc(server->documents,
+                  sizeof(struct document) * server->document_cap);
+    }
+    doc = &server->documents[server->document_count++];
+    *doc = (struct document){0};
+    doc->uri = malloc(uri->string_len + 1);
+    memcpy(doc->uri, uri->string, uri->string_len + 1);
+    doc->line_cap = 256;
+    doc->lines = malloc(sizeof(uint32_t) * doc->line_cap);
+  }
+
+  doc->len = (uint32_t)text->string_len;
+  doc->cap = doc->len + 1;
+  doc->text = realloc(doc->text, doc->cap);
+  memcpy(doc->text, text->string, doc->len);
+  doc->lines[0] = 0;
+  doc->line_count = 1;
+  update_lines(doc, 0);
+  ts_tree_delete(doc->tree);
+  doc->tree = ts_parser_parse_string(server->parser, NULL, doc->text, doc->len);
+  publish_diagnostics(server, doc);
+}
+
+// Replaces text[start, old_end) with the change's text and edits the tree to
+// match, without reparsing it.
+static void apply_change(struct server *server, struct document *doc,
+                         const struct json *change) {
+  const struct json *range = json_get(change, "range");
+  const struct json *text = json_get(change, "text");
+  if (!text || text->type != JSON_STRING) {
+    return;
+  }
+  uint32_t start = 0, old_end = doc->len;
+  if (range) {
+    const struct json *start_pos = json_get(range, "start");
+    const struct json *end_pos = json_get(range, "end");
+    start = position_to_byte(server, doc,
+                             json_uint(json_get(start_pos, "line")),
+                             json_uint(json_get(start_pos, "character")));
+    old_end = position_to_byte(server, doc,
+                               json_uint(json_get(end_pos, "line")),
+                               json_uint(json_get(end_pos, "character")));
+    if (old_end < start) {
+      old_end = start;
+    }
+  }
+  TSPoint start_point = point_of_byte(doc, start);
+  TSPoint old_end_point = point_of_byte(doc, old_end);
+
+  uint32_t new_len = doc->len - (old_end - start) + (uint32_t)text->string_len;
+  if (new_len + 1 > doc->cap) {
+    doc->cap = new_len + 1 > doc->cap * 2 ? new_len + 1 : doc->cap * 2;
+    doc->text = realloc(doc->text, doc->cap);
+  }
+  memmove(doc->text + start + text->string_len, doc->text + old_end,
+          doc->len - old_end);
+  memcpy(doc->text + start, text->string, text->string_len);
+  doc->len = new_len;
+  update_lines(doc, start);
+
+  uint32_t new_end = start + (uint32_t)text->string_len;
+  TSInputEdit edit = {
+      .start_byte = start,
+      .old_end_byte = old_end,
+      .new_end_byte = new_end,
+      .start_point = start_point,
+      .old_end_point = old_end_point,
+      .new_end_point = point_of_byte(doc, new_end),
+  };
+  ts_tree_edit(doc->tree, &edit);
+}
+
+static void change_document(struct server *server,
+                            const struct json *params) {
+  struct document *doc =
+      find_document(server, json_get(json_get(params, "textDocument"), "uri"));
+  const struct json *changes = json_get(params, "contentChanges");
+  if (!doc || !changes || changes->type != JSON_ARRAY) {
+    return;
+  }
+  for (size_t i = 0; i < changes->count; i++) {
+    apply_change(server, doc, &changes->items[i]);
+  }
+  double start = now();
+  TSTree *tree =
+      ts_parser_parse_string(server->parser, doc->tree, doc->text, doc->len);
+  server->parse_seconds += now() - start;
+  ts_tree_delete(doc->tree);
+  doc->tree = tree;
+  publish_diagnostics(server, doc);
+}
+
+static void close_document(struct server *server, const struct json *params) {
+  struct document *doc =
+      find_document(server, json_get(json_get(params, "textDocument"), "uri"));
+  if (!doc) {
+    return;
+  }
+  free(doc->uri);
+  free(doc->text);
+  free(doc->lines);
+  ts_tree_delete(doc->tree);
+  *doc = server->documents[--server->document_count];
+}
+
+// Document symbols
+
+enum symbol_kind {
+  SYMBOL_CLASS = 5,
+  SYMBOL_INTERFACE = 11,
+  SYMBOL_FUNCTION = 12,
+  SYMBOL_VARIABLE = 13,
+  SYMBOL_STRUCT = 23,
+  SYMBOL_TYPE_PARAMETER = 26,
+};
+
+struct symbols {
+  TSSymbol topdecl, puredecl, externdecl, typedecl, aliasdecl, funid, binder,
+      typeid, varid;
+};
+
+static TSSymbol symbol(const TSLanguage *language, const char *name) {
+  return ts_language_symbol_for_name(language, name, (uint32_t)strlen(name),
+                                     true);
+}
+
+static void symbols_init(struct symbols *s, const TSLanguage *language) {
+  s->topdecl = symbol(language, "topdecl");
+  s->puredecl = symbol(language, "puredecl");
+  s->externdecl = symbol(language, "externdecl");
+  s->typedecl = symbol(language, "typedecl");
+  s->aliasdecl = symbol(language, "aliasdecl");
+  s->funid = symbol(language, "funid");
+  s->binder = symbol(language, "binder");
+  s->typeid = symbol(language, "typeid");
+  s->varid = symbol(language, "varid");
+}
+
+// Finds the name of a declaration and the kind of symbol it declares, or
+// returns false if it has no name, as an effect with a single operation.
+static bool declaration_name(const struct symbols *s, TSNode decl,
+                             TSNode *name, enum symbol_kind *kind) {
+  TSSymbol decl_symbol = ts_node_symbol(decl);
+  uint32_t count = ts_node_child_count(decl);
+  *kind = SYMBOL_CLASS;
+  for (uint32_t i = 0; i < count; i++) {
+    TSNode child = ts_node_child(decl, i);
+    TSSymbol child_symbol = ts_node_symbol(child);
+    if (!ts_node_is_named(child)) {
+      const char *keyword = ts_node_type(child);
+      if (strcmp(keyword, "val") == 0) {
+        *kind = SYMBOL_VARIABLE;
+      } else if (strcmp(keyword, "effect") == 0) {
+        *kind = SYMBOL_INTERFACE;
+      } else if (strcmp(keyword, "struct") == 0) {
+        *kind = SYMBOL_STRUCT;
+      }
+    } else if (child_symbol == s->funid) {
+      *name = child;
+      *kind = SYMBOL_FUNCTION;
+      return true;
+    } else if (child_symbol == s->binder) {
+      *name = ts_node_named_child(child, 0);
+      return true;
+    } else if (child_symbol == s->typeid ||
+               (child_symbol == s->varid && decl_symbol == s->typedecl)) {
+      *name = child;
+      if (decl_symbol == s->aliasdecl) {
+        *kind = SYMBOL_TYPE_PARAMETER;
+      }
+      return true;
+    }
+  }
+  return false;
+}
+
+static void document_symbols(struct server *server, const struct json *id,
+                             const struct document *doc) {
+  struct symbols s;
+  symbols_init(&s, ts_tree_language(doc->tree));
+  struct buffer *out = &server->message;
+  begin_response(server, id);
+  buffer_puts(out, "[");
+
+  // Declarations are children of topdecl nodes, found in the module body,
+  // which is found in the module declaration when the file has one.
+  bool first = true;
+  TSTreeCursor cursor = ts_tree_cursor_new(ts_tree_root_node(doc->tree));
+  bool done = false;
+  while (!done) {
+    TSNode node = ts_tree_cursor_current_node(&cursor);
+    bool is_topdecl = ts_node_symbol(node) == s.topdecl;
+    TSNode decl = is_topdecl ? ts_node_named_child(node, 0) : node;
+    TSNode name;
+    enum symbol_kind kind;
+    if (is_topdecl && !ts_node_is_null(decl) &&
+        declaration_name(&s, decl, &name, &kind)) {
+      uint32_t name_start = ts_node_start_byte(name);
+      buffer_puts(out, first ? "{\"name\":" : ",{\"name\":");
+      buffer_put_string(out, doc->text + name_start,
+                        ts_node_end_byte(name) - name_start);
+      buffer_printf(out, ",\"kind\":%d,\"range\":", kind);
+      put_range(server, doc, ts_node_start_byte(node), ts_node_end_byte(node));
+      buffer_puts(out, ",\"selectionRange\":");
+      put_range(server, doc, name_start, ts_node_end_byte(name));
+      buffer_puts(out, "}");
+      first = false;
+    }
+
+    if (!is_topdecl && ts_tree_cursor_goto_first_child(&cursor)) {
+      continue;
+    }
+    while (!ts_tree_cursor_goto_next_sibling(&cursor)) {
+      if (!ts_tree_cursor_goto_parent(&cursor)) {
+        done = true;
+        break;
+      }
+    }
+  }
+  ts_tree_cursor_delete(&cursor);
+
+  buffer_puts(out, "]}");
+  send_message(server);
+}
+
+// Folding ranges
+
+static void folding_ranges(struct server *server, const struct json *id,
+                           const struct document *doc) {
+  TSNode root = ts_tree_root_node(doc->tree);
+  uint32_t count =
+      tree_sitter_koka_folding_ranges(root, doc->text, doc->len, NULL, 0);
+  TSKokaFoldingRange *ranges = malloc(sizeof(TSKokaFoldingRange) * count + 1);
+  tree_sitter_koka_folding_ranges(root, doc->text, doc->len, ranges, count);
+
+  struct buffer *out = &server->message;
+  begin_response(server, id);
+  buffer_puts(out, "[");
+  for (uint32_t i = 0; i < count; i++) {
+    buffer_printf(out, "%s{\"startLine\":%u,\"endLine\":%u,\"kind\":\"%s\"}",
+                  i > 0 ? "," : "", ranges[i].start_line, ranges[i].end_line,
+                  ranges[i].kind == TSKokaFoldComment ? "comment" : "region");
+  }
+  buffer_puts(out, "]}");
+  send_message(server);
+  free(ranges);
+}
+
+// Semantic tokens
+
+static const char *TOKEN_TYPES[] = {
+    "namespace", "type",    "enumMember", "function", "parameter", "variable",
+    "keyword",   "comment", "string",     "number",   "operator",
+};
+
+#define TOKEN_TYPE_COUNT (sizeof(TOKEN_TYPES) / sizeof(TOKEN_TYPES[0]))
+
+// The token type of each highlights capture, matched by prefix, so that
+// variable.parameter also matches variable.parameter.builtin. The first
+// match wins. Captures that match nothing, such as punctuation, are left to
+// the editor's own syntax.
+static const struct {
+  const char *capture;
+  const char *token_type;
+} CAPTURE_TOKEN_TYPES[] = {
+    {"comment", "comment"},
+    {"constant.numeric", "number"},
+    {"constant.character", "string"},
+    {"constant", "enumMember"},
+    {"constructor", "enumMember"},
+    {"function", "function"},
+    {"keyword", "keyword"},
+    {"namespace", "namespace"},
+    {"operator", "operator"},
+    {"string", "string"},
+    {"type", "type"},
+    {"variable.parameter", "parameter"},
+    {"variable", "variable"},
+};
+
+#define CAPTURE_TOKEN_TYPE_COUNT                                               \
+  (sizeof(CAPTURE_TOKEN_TYPES) / sizeof(CAPTURE_TOKEN_TYPES[0]))
+
+static int32_t token_type_for_capture(const char *name, uint32_t name_len) {
+  for (size_t i = 0; i < CAPTURE_TOKEN_TYPE_COUNT; i++) {
+    size_t len = strlen(CAPTURE_TOKEN_TYPES[i].capture);
+    if (name_len >= len &&
+        memcmp(name, CAPTURE_TOKEN_TYPES[i].capture, len) == 0 &&
+        (name_len == len || name[len] == '.')) {
+      for (size_t j = 0; j < TOKEN_TYPE_COUNT; j++) {
+        if (strcmp(TOKEN_TYPES[j], CAPTURE_TOKEN_TYPES[i].token_type) == 0) {
+          return (int32_t)j;
+        }
+      }
+    }
+  }
+  return -1;
+}
+
+struct token_state {
+  uint32_t line;
+  uint32_t character;
+  bool first;
+};
+
+// Appends a token that doesn't span lines, relative to the previous one.
+static void put_token(struct server *server, struct token_state *state,
+                      uint32_t line, uint32_t character, uint32_t length,
+                      int32_t type) {
+  uint32_t delta_character =
+      line == state->line ? character - state->character : character;
+  buffer_printf(&server->message, "%s%u,%u,%u,%d,0", state->first ? "" : ",",
+                line - state->line, delta_character, length, type);
+  state->line = line;
+  state->character = character;
+  state->first = false;
+}
+
+static void semantic_tokens(struct server *server, const struct json *id,
+                            const struct document *doc) {
+  struct buffer *out = &server->message;
+  begin_response(server, id);
+  buffer_puts(out, "{\"data\":[");
+
+  // Tokens can't overlap, so a capture nested in an earlier one, such as an
+  // escape in a string, is dropped; a capture of the same node as the
+  // previous one replaces it, as later patterns take precedence.
+  struct token_state state = {0, 0, true};
+  uint32_t pending_start = 0, pending_end = 0;
+  int32_t pending_type = -1;
+  TSQueryCursor *cursor = ts_query_cursor_new();
+  ts_query_cursor_exec(cursor, server->highlights,
+                       ts_tree_root_node(doc->tree));
+  TSQueryMatch match;
+  uint32_t capture_index;
+  bool more = true;
+  while (more) {
+    more = ts_query_cursor_next_capture(cursor, &match, &capture_index);
+    uint32_t start = 0, end = 0;
+    int32_t type = -1;
+    if (more) {
+      const TSQueryCapture *capture = &match.captures[capture_index];
+      start = ts_node_start_byte(capture->node);
+      end = ts_node_end_byte(capture->node);
+      type = server->capture_token_types[capture->index];
+      if (type < 0) {
+        continue;
+      }
+      if (pending_type >= 0 && start == pending_start && end == pending_end) {
+        pending_type = type;
+        continue;
+      }
+      if (pending_type >= 0 && start < pending_end) {
+        continue;
+      }
+    }
+
+    // Tokens that span lines are split at line ends.
+    uint32_t token_start = pending_start;
+    while (pending_type >= 0 && token_start < pending_end) {
+      uint32_t line = line_of_byte(doc, token_start);
+      uint32_t line_end =
+          line + 1 < doc->line_count ? doc->lines[line + 1] - 1 : doc->len;
+      uint32_t token_end = pending_end < line_end ? pending_end : line_end;
+      if (token_end > token_start) {
+        put_token(server, &state, line,
+                  position_units(server, doc, doc->lines[line], token_start),
+                  position_units(server, doc, token_start, token_end),
+                  pending_type);
+      }
+      token_start = line + 1 < doc->line_count ? doc->lines[line + 1]
+                                               : pending_end;
+    }
+    pending_start = start;
+    pending_end = end;
+    pending_type = type;
+  }
+  ts_query_cursor_delete(cursor);
+
+  buffer_puts(out, "]}}");
+  send_message(server);
+}
+
+// Dispatch
+
+static void initialize(struct server *server, const struct json *id,
+                       const struct json *params) {
+  // UTF-8 positions save converting offsets, when the client allows them.
+  const struct json *encodings = json_get(
+      json_get(json_get(params, "capabilities"), "general"),
+      "positionEncodings");
+  for (size_t i = 0; encodings && encodings->type == JSON_ARRAY &&
+                     i < encodings->count;
+       i++) {
+    if (json_is(&encodings->items[i], "utf-8")) {
+      server->utf8_positions = true;
+    }
+  }
+
+  struct buffer *out = &server->message;
+  begin_response(server, id);
+  buffer_printf(out,
+                "{\"capabilities\":{\"positionEncoding\":\"%s\","
+                "\"textDocumentSync\":{\"openClose\":true,\"change\":2},",
+                server->utf8_positions ? "utf-8" : "utf-16");
+  buffer_puts(out, "\"documentSymbolProvider\":true,"
+                   "\"foldingRangeProvider\":true,"
+                   "\"semanticTokensProvider\":{\"legend\":{\"tokenTypes\":[");
+  for (size_t i = 0; i < TOKEN_TYPE_COUNT; i++) {
+    buffer_printf(out, "%s\"%s\"", i > 0 ? "," : "", TOKEN_TYPES[i]);
+  }
+  buffer_puts(out, "],\"tokenModifiers\":[]},\"full\":true}},"
+                   "\"serverInfo\":{\"name\":\"koka-lsp\"}}}");
+  send_message(server);
+}
+
+// Handles a message, returning false once the server should exit.
+static bool handle_message(struct server *server, const struct json *message) {
+  const struct json *id = json_get(message, "id");
+  const struct json *method = json_get(message, "method");
+  const struct json *params = json_get(message, "params");
+  if (!method || method->type != JSON_STRING) {
+    // A response to a request of ours, which are never sent.
+    return true;
+  }
+
+  if (json_is(method, "textDocument/didChange")) {
+    change_document(server, params);
+  } else if (json_is(method, "textDocument/didOpen")) {
+    open_document(server, json_get(params, "textDocument"));
+  } else if (json_is(method, "textDocument/didClose")) {
+    close_document(server, params);
+  } else if (json_is(method, "exit")) {
+    return false;
+  } else if (!id) {
+    // Other notifications, such as initialized, need nothing done.
+  } else if (json_is(method, "initialize")) {
+    initialize(server, id, params);
+  } else if (json_is(method, "shutdown")) {
+    server->shut_down = true;
+    begin_response(server, id);
+    buffer_puts(&server->message, "null}");
+    send_message(server);
+  } else if (json_is(method, "textDocument/documentSymbol") ||
+             json_is(method, "textDocument/foldingRange") ||
+             json_is(method, "textDocument/semanticTokens/full")) {
+    const struct document *doc = find_document(
+        server, json_get(json_get(params, "textDocument"), "uri"));
+    if (!doc) {
+      send_error(server, id, -32602, "unknown document");
+    } else if (json_is(method, "textDocument/documentSymbol")) {
+      document_symbols(server, id, doc);
+    } else if (json_is(method, "textDocument/foldingRange")) {
+      folding_ranges(server, id, doc);
+    } else {
+      semantic_tokens(server, id, doc);
+    }
+  } else {
+    send_error(server, id, -32601, "method not found");
+  }
+  return true;
+}
+
+// Parses and handles a message, returning false once the server should exit.
+static bool handle_text(struct server *server, const char *text, size_t len) {
+  struct arena arena = {NULL};
+  struct json_parser parser = {text, len, 0, &arena};
+  struct json message;
+  bool keep_going = true;
+  if (parse_value(&parser, &message, 0)) {
+    keep_going = handle_message(server, &message);
+  } else {
+    fprintf(stderr, "koka-lsp: ignoring a message that isn't valid JSON\n");
+  }
+  arena_clear(&arena);
+  return keep_going;
+}
+
+static void server_init(struct server *server, FILE *output) {
+  *server = (struct server){0};
+  server->output = output;
+  server->parser = ts_parser_new();
+  const TSLanguage *language = tree_sitter_koka();
+  ts_parser_set_language(server->parser, language);
+
+  const char *source = tree_sitter_koka_highlights_query();
+  uint32_t error_offset;
+  TSQueryError error_type;
+  server->highlights = ts_query_new(language, source, (uint32_t)strlen(source),
+                                    &error_offset, &error_type);
+  uint32_t capture_count = ts_query_capture_count(server->highlights);
+  server->capture_token_types = malloc(sizeof(int32_t) * (capture_count + 1));
+  for (uint32_t i = 0; i < capture_count; i++) {
+    uint32_t name_len;
+    const char *name =
+        ts_query_capture_name_for_id(server->highlights, i, &name_len);
+    server->capture_token_types[i] = token_type_for_capture(name, name_len);
+  }
+}
+
+static void server_delete(struct server *server) {
+  while (server->document_count > 0) {
+    struct document *doc = &server->documents[--server->document_count];
+    free(doc->uri);
+    free(doc->text);
+    free(doc->lines);
+    ts_tree_delete(doc->tree);
+  }
+  free(server->documents);
+  free(server->capture_token_types);
+  free(server->message.data);
+  ts_query_delete(server->highlights);
+  ts_parser_delete(server->parser);
+}
+
+// Reads and drops length bytes of input, returning false at its end.
+static bool skip_input(FILE *input, unsigned long long length) {
+  char chunk[4096];
+  while (length > 0) {
+    size_t size = length < sizeof(chunk) ? (size_t)length : sizeof(chunk);
+    if (fread(chunk, 1, size, input) != size) {
+      return false;
+    }
+    length -= size;
+  }
+  return true;
+}
+
+// Reads a message body framed by a Content-Length header, returning NULL at
+// the end of the input or when the header can't be read. Bodies longer than
+// MAX_MESSAGE_LENGTH are skipped.
+static char *read_message(FILE *input, size_t *len) {
+  char line[256];
+  unsigned long long content_length = 0;
+  bool have_length = false;
+  while (fgets(line, sizeof(line), input)) {
+    if (strcmp(line, "\r\n") == 0 || strcmp(line, "\n") == 0) {
+      if (!have_length) {
+        continue;
+      }
+      if (content_length > MAX_MESSAGE_LENGTH) {
+        fprintf(stderr, "koka-lsp: skipping a message of %llu bytes\n",
+                content_length);
+        if (!skip_input(input, content_length)) {
+          return NULL;
+        }
+        have_length = false;
+        continue;
+      }
+      char *body = malloc((size_t)content_length + 1);
+      if (!body || fread(body, 1, content_length, input) != content_length) {
+        free(body);
+        return NULL;
+      }
+      body[content_length] = '\0';
+      *len = (size_t)content_length;
+      return body;
+    }
+    if (strncmp(line, "Content-Length:", 15) == 0) {
+      // strtoull would wrap negative lengths around.
+      char *end;
+      errno = 0;
+      content_length = strtoull(line + 15, &end, 10);
+      if (end == line + 15 || errno == ERANGE || strchr(line + 15, '-')) {
+        fprintf(stderr, "koka-lsp: invalid Content-Length\n");
+        return NULL;
+      }
+      have_length = true;
+    }
+  }
+  return NULL;
+}
+
+// Benchmarking
+
+static int compare_doubles(const void *a, const void *b) {
+  double da = *(const double *)a, db = *(const double *)b;
+  return da < db ? -1 : da > db ? 1 : 0;
+}
+
+static int benchmark(const char *path, uint32_t edit_count) {
+  FILE *file = fopen(path, "rb");
+  if (!file) {
+    fprintf(stderr, "could not read %s\n", path);
+    return 1;
+  }
+  struct buffer source = {NULL, 0, 0};
+  char chunk[65536];
+  size_t read;
+  while ((read = fread(chunk, 1, sizeof(chunk), file)) > 0) {
+    buffer_append(&source, chunk, read);
+  }
+  fclose(file);
+
+  // Messages are written to /dev/null rather than dropped, so that the
+  // latencies include writing them out.
+  FILE *output = fopen("/dev/null", "w");
+  if (!output) {
+    fprintf(stderr, "could not open /dev/null\n");
+    free(source.data);
+    return 1;
+  }
+  struct server server;
+  server_init(&server, output);
+  struct buffer message = {NULL, 0, 0};
+  buffer_puts(&message, "{\"jsonrpc\":\"2.0\",\"method\":"
+                        "\"textDocument/didOpen\",\"params\":{"
+                        "\"textDocument\":{\"uri\":\"file:///bench.kk\","
+                        "\"languageId\":\"koka\",\"version\":0,\"text\":");
+  buffer_put_string(&message, source.data ? source.data : "", source.len);
+  buffer_puts(&message, "}}}");
+  double start = now();
+  handle_text(&server, message.data, message.len);
+  double open = now() - start;
+
+  // Edits type a character at the end of a line, then delete it again,
+  // spreading the lines through the file.
+  struct document *doc = &server.documents[0];
+  double *latencies = malloc(sizeof(double) * (edit_count + 1));
+  server.parse_seconds = 0;
+  uint32_t line = 0, character = 0;
+  for (uint32_t i = 0; i < edit_count; i++) {
+    if (i % 2 == 0) {
+      line = (uint32_t)(((uint64_t)i * 7919) % doc->line_count);
+      uint32_t line_end = line + 1 < doc->line_count
+                              ? doc->lines[line + 1] - 1
+                              : doc->len;
+      character = position_units(&server, doc, doc->lines[line], line_end);
+    }
+    message.len = 0;
+    buffer_printf(&message,
+                  "{\"jsonrpc\":\"2.0\",\"method\":\"textDocument/didChange\","
+                  "\"params\":{\"textDocument\":{\"uri\":\"file:///bench.kk\","
+                  "\"version\":%u},\"contentChanges\":[{\"range\":{"
+                  "\"start\":{\"line\":%u,\"character\":%u},",
+                  i + 1, line, character);
+    buffer_printf(&message,
+                  "\"end\":{\"line\":%u,\"character\":%u}},\"text\":\"%s\"}]}}",
+                  line, character + (i % 2), i % 2 == 0 ? "x" : "");
+    start = now();
+    handle_text(&server, message.data, message.len);
+    latencies[i] = now() - start;
+  }
+
+  double total = 0;
+  for (uint32_t i = 0; i < edit_count; i++) {
+    total += latencies[i];
+  }
+  qsort(latencies, edit_count, sizeof(double), compare_doubles);
+
+  const char *requests[] = {"documentSymbol", "foldingRange",
+                            "semanticTokens/full"};
+  double request_times[3];
+  for (int i = 0; i < 3; i++) {
+    message.len = 0;
+    buffer_printf(&message,
+                  "{\"jsonrpc\":\"2.0\",\"id\":%d,\"method\":"
+                  "\"textDocument/%s\",\"params\":{\"textDocument\":{"
+                  "\"uri\":\"file:///bench.kk\"}}}",
+                  i + 1, requests[i]);
+    start = now();
+    handle_text(&server, message.data, message.len);
+    request_times[i] = now() - start;
+  }
+
+  printf("%u bytes, %u lines\n", doc->len, doc->line_count);
+  printf("open:                %8.3f ms\n", open * 1e3);
+  if (edit_count > 0) {
+    printf("didChange (%u edits): mean %.3f ms, p50 %.3f ms, p99 %.3f ms, "
+           "max %.3f ms\n",
+           edit_count, total / edit_count * 1e3,
+           latencies[edit_count / 2] * 1e3,
+           latencies[(uint32_t)(edit_count * 0.99)] * 1e3,
+           latencies[edit_count - 1] * 1e3);
+    printf("  reparsing:          mean %.3f ms\n",
+           server.parse_seconds / edit_count * 1e3);
+    printf("  everything else:    mean %.3f ms\n",
+           (total - server.parse_seconds) / edit_count * 1e3);
+  }
+  for (int i = 0; i < 3; i++) {
+    printf("%-20s %8.3f ms\n", requests[i], request_times[i] * 1e3);
+  }
+
+  free(latencies);
+  free(message.data);
+  free(source.data);
+  server_delete(&server);
+  fclose(output);
+  return 0;
+}
+
+int main(int argc, char **argv) {
+  const char *bench_path = NULL;
+  uint32_t edit_count = 1000;
+  for (int arg = 1; arg < argc; arg++) {
+    if (strcmp(argv[arg], "-b") == 0 && arg + 1 < argc) {
+      bench_path = argv[++arg];
+    } else if (strcmp(argv[arg], "-n") == 0 && arg + 1 < argc) {
+      edit_count = (uint32_t)strtoul(argv[++arg], NULL, 10);
+    } else {
+      fprintf(stderr, "usage: koka-lsp [-b file.kk [-n edits]]\n");
+      return 1;
+    }
+  }
+  if (bench_path) {
+    return benchmark(bench_path, edit_count);
+  }
+
+  struct server server;
+  server_init(&server, stdout);
+  size_t len;
+  char *text;
+  bool keep_going = true;
+  while (keep_going && (text = read_message(stdin, &len))) {
+    keep_going = handle_text(&server, text, len);
+    free(text);
+  }
+  bool shut_down = server.shut_down;
+  server_delete(&server);
+  return shut_down ? 0 : 1;
+}
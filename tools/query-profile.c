@@ -0,0 +1,379 @@
+// Per-pattern cost profiler for the query files under queries/.
+//
+// Every .scm file is compiled once per pattern with all other patterns
+// disabled, then run over the parsed corpus with a capture cursor (which is
+// what highlighters and indenters use). The time, match count and capture
+// count of each pattern are reported per query file, followed by a ranking of
+// the most expensive patterns across all files.
+//
+// Usage: koka-query-profile [-q queries-dir] [-n iterations] [-t top] path...
+//
+// Each path is a .kk file or a directory that is searched recursively for
+// .kk files.
+
+#define _POSIX_C_SOURCE 200809L
+
+#include "tree-sitter-koka.h"
+#include <dirent.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/stat.h>
+#include <time.h>
+#include <tree_sitter/api.h>
+
+struct source {
+  char *path;
+  char *text;
+  size_t len;
+  TSTree *tree;
+};
+
+struct corpus {
+  size_t len;
+  size_t cap;
+  struct source *sources;
+};
+
+struct pattern_stats {
+  const char *query_name;
+  uint32_t pattern_index;
+  uint32_t line;
+  double seconds;
+  uint64_t matches;
+  uint64_t captures;
+};
+
+struct stats_list {
+  size_t len;
+  size_t cap;
+  struct pattern_stats *stats;
+};
+
+static double now(void) {
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (double)ts.tv_sec + (double)ts.tv_nsec / 1e9;
+}
+
+static bool has_suffix(const char *s, const char *suffix) {
+  size_t s_len = strlen(s), suffix_len = strlen(suffix);
+  return s_len >= suffix_len && strcmp(s + s_len - suffix_len, suffix) == 0;
+}
+
+static char *read_file(const char *path, size_t *len) {
+  FILE *file = fopen(path, "rb");
+  if (!file) {
+    return NULL;
+  }
+  fseek(file, 0, SEEK_END);
+  long size = ftell(file);
+  fseek(file, 0, SEEK_SET);
+  char *text = malloc((size_t)size + 1);
+  if (!text || fread(text, 1, (size_t)size, file) != (size_t)size) {
+    free(text);
+    fclose(file);
+    return NULL;
+  }
+  fclose(file);
+  text[size] = '\0';
+  *len = (size_t)size;
+  return text;
+}
+
+static char *join_path(const char *dir, const char *name) {
+  size_t len = strlen(dir) + strlen(name) + 2;
+  char *path = malloc(len);
+  snprintf(path, len, "%s/%s", dir, name);
+  return path;
+}
+
+static void corpus_add(struct corpus *corpus, TSParser *parser,
+                       const char *path) {
+  size_t len;
+  char *text = read_file(path, &len);
+  if (!text) {
+    fprintf(stderr, "warning: could not read %s\n", path);
+    return;
+  }
+  if (corpus->len == corpus->cap) {
+    corpus->cap = corpus->cap == 0 ? 16 : corpus->cap * 2;
+    corpus->sources =
+        realloc(corpus->sources, sizeof(struct source) * corpus->cap);
+  }
+  struct source *source = &corpus->sources[corpus->len++];
+  source->path = strdup(path);
+  source->text = text;
+  source->len = len;
+  source->tree = ts_parser_parse_string(parser, NULL, text, (uint32_t)len);
+}
+
+static void corpus_add_path(struct corpus *corpus, TSParser *parser,
+                            const char *path) {
+  struct stat st;
+  if (stat(path, &st) != 0) {
+    fprintf(stderr, "warning: could not stat %s\n", path);
+    return;
+  }
+  if (!S_ISDIR(st.st_mode)) {
+    corpus_add(corpus, parser, path);
+    return;
+  }
+
+  DIR *dir = opendir(path);
+  if (!dir) {
+    return;
+  }
+  struct dirent *entry;
+  while ((entry = readdir(dir))) {
+    if (entry->d_name[0] == '.') {
+      continue;
+    }
+    char *child = join_path(path, entry->d_name);
+    if (stat(child, &st) == 0 &&
+        (S_ISDIR(st.st_mode) || has_suffix(entry->d_name, ".kk"))) {
+      corpus_add_path(corpus, parser, child);
+    }
+    free(child);
+  }
+  closedir(dir);
+}
+
+static void stats_push(struct stats_list *list, struct pattern_stats stats) {
+  if (list->len == list->cap) {
+    list->cap = list->cap == 0 ? 64 : list->cap * 2;
+    list->stats = realloc(list->stats, sizeof(struct pattern_stats) * list->cap);
+  }
+  list->stats[list->len++] = stats;
+}
+
+static int compare_by_time(const void *a, const void *b) {
+  double ta = ((const struct pattern_stats *)a)->seconds;
+  double tb = ((const struct pattern_stats *)b)->seconds;
+  return ta < tb ? 1 : ta > tb ? -1 : 0;
+}
+
+static uint32_t line_for_byte(const char *text, uint32_t byte) {
+  uint32_t line = 1;
+  for (uint32_t i = 0; i < byte && text[i]; i++) {
+    if (text[i] == '\n') {
+      line++;
+    }
+  }
+  return line;
+}
+
+// Runs query over every tree in the corpus iterations times with a capture
+// cursor, accumulating the elapsed time. The match and capture counts are
+// taken once, outside the timed loop, with a match cursor: captures of
+// different matches interleave in the capture stream, so counting changes of
+// the match id there would count a match once per run of its captures.
+static void run_query(const TSQuery *query, TSQueryCursor *cursor,
+                      const struct corpus *corpus, int iterations,
+                      struct pattern_stats *stats) {
+  stats->seconds = 0;
+  stats->matches = 0;
+  stats->captures = 0;
+  for (int i = 0; i < iterations; i++) {
+    for (size_t s = 0; s < corpus->len; s++) {
+      TSQueryMatch match;
+      uint32_t capture_index;
+
+      double start = now();
+      ts_query_cursor_exec(cursor, query,
+                           ts_tree_root_node(corpus->sources[s].tree));
+      while (ts_query_cursor_next_capture(cursor, &match, &capture_index)) {
+      }
+      stats->seconds += now() - start;
+    }
+  }
+
+  for (size_t s = 0; s < corpus->len; s++) {
+    TSQueryMatch match;
+    ts_query_cursor_exec(cursor, query,
+                         ts_tree_root_node(corpus->sources[s].tree));
+    while (ts_query_cursor_next_match(cursor, &match)) {
+      stats->matches++;
+      stats->captures += match.capture_count;
+    }
+  }
+}
+
+static void profile_query_file(const char *queries_dir, const char *name,
+                               const struct corpus *corpus, int iterations,
+                               int top, struct stats_list *all) {
+  char *path = join_path(queries_dir, name);
+  size_t len;
+  char *source = read_file(path, &len);
+  free(path);
+  if (!source) {
+    fprintf(stderr, "warning: could not read %s/%s\n", queries_dir, name);
+    return;
+  }
+
+  uint32_t error_offset;
+  TSQueryError error_type;
+  TSQuery *full = ts_query_new(tree_sitter_koka(), source, (uint32_t)len,
+                               &error_offset, &error_type);
+  if (!full) {
+    fprintf(stderr, "%s: query error %d at line %u\n", name, (int)error_type,
+            line_for_byte(source, error_offset));
+    free(source);
+    return;
+  }
+
+  TSQueryCursor *cursor = ts_query_cursor_new();
+  struct pattern_stats total = {.query_name = name};
+  run_query(full, cursor, corpus, iterations, &total);
+
+  uint32_t pattern_count = ts_query_pattern_count(full);
+  struct stats_list file_stats = {0};
+  for (uint32_t p = 0; p < pattern_count; p++) {
+    TSQuery *single = ts_query_new(tree_sitter_koka(), source, (uint32_t)len,
+                                   &error_offset, &error_type);
+    for (uint32_t other = 0; other < pattern_count; other++) {
+      if (other != p) {
+        ts_query_disable_pattern(single, other);
+      }
+    }
+
+    struct pattern_stats stats = {
+        .query_name = name,
+        .pattern_index = p,
+        .line = line_for_byte(source, ts_query_start_byte_for_pattern(full, p)),
+    };
+    run_query(single, cursor, corpus, iterations, &stats);
+    stats_push(&file_stats, stats);
+    stats_push(all, stats);
+    ts_query_delete(single);
+  }
+
+  qsort(file_stats.stats, file_stats.len, sizeof(struct pattern_stats),
+        compare_by_time);
+  printf("%s: %u patterns, %.3f ms/iteration, %llu matches, %llu captures\n",
+         name, pattern_count, total.seconds * 1e3 / iterations,
+         (unsigned long long)total.matches, (unsigned long long)total.captures);
+  printf("  %-8s %-6s %12s %8s %10s %10s\n", "pattern", "line", "ms/iter",
+         "share", "matches", "captures");
+  for (size_t i = 0; i < file_stats.len && (int)i < top; i++) {
+    struct pattern_stats *stats = &file_stats.stats[i];
+    printf("  %-8u %-6u %12.3f %7.1f%% %10llu %10llu\n", stats->pattern_index,
+           stats->line, stats->seconds * 1e3 / iterations,
+           total.seconds > 0 ? 100 * stats->seconds / total.seconds : 0.0,
+           (unsigned long long)stats->matches,
+           (unsigned long long)stats->captures);
+  }
+  printf("\n");
+
+  free(file_stats.stats);
+  ts_query_cursor_delete(cursor);
+  ts_query_delete(full);
+  free(source);
+}
+
+static int compare_strings(const void *a, const void *b) {
+  return strcmp(*(char *const *)a, *(char *const *)b);
+}
+
+static void usage(const char *argv0) {
+  fprintf(stderr,
+          "usage: %s [-q queries-dir] [-n iterations] [-t top] path...\n",
+          argv0);
+}
+
+int main(int argc, char **argv) {
+  const char *queries_dir = "queries";
+  int iterations = 10;
+  int top = 10;
+
+  int arg = 1;
+  for (; arg < argc && argv[arg][0] == '-'; arg++) {
+    if (arg + 1 >= argc) {
+      usage(argv[0]);
+      return 1;
+    }
+    if (strcmp(argv[arg], "-q") == 0) {
+      queries_dir = argv[++arg];
+    } else if (strcmp(argv[arg], "-n") == 0) {
+      iterations = atoi(argv[++arg]);
+    } else if (strcmp(argv[arg], "-t") == 0) {
+      top = atoi(argv[++arg]);
+    } else {
+      usage(argv[0]);
+      return 1;
+    }
+  }
+  if (arg == argc || iterations <= 0) {
+    usage(argv[0]);
+    return 1;
+  }
+
+  TSParser *parser = ts_parser_new();
+  ts_parser_set_language(parser, tree_sitter_koka());
+  struct corpus corpus = {0};
+  double parse_start = now();
+  for (; arg < argc; arg++) {
+    corpus_add_path(&corpus, parser, argv[arg]);
+  }
+  double parse_seconds = now() - parse_start;
+  if (corpus.len == 0) {
+    fprintf(stderr, "no .kk files found\n");
+    return 1;
+  }
+  size_t corpus_bytes = 0;
+  for (size_t s = 0; s < corpus.len; s++) {
+    corpus_bytes += corpus.sources[s].len;
+  }
+  printf("corpus: %zu files, %zu bytes, parsed in %.3f ms\n\n", corpus.len,
+         corpus_bytes, parse_seconds * 1e3);
+
+  DIR *dir = opendir(queries_dir);
+  if (!dir) {
+    fprintf(stderr, "could not open %s\n", queries_dir);
+    return 1;
+  }
+  size_t name_count = 0, name_cap = 8;
+  char **names = malloc(sizeof(char *) * name_cap);
+  struct dirent *entry;
+  while ((entry = readdir(dir))) {
+    if (has_suffix(entry->d_name, ".scm")) {
+      if (name_count == name_cap) {
+        name_cap *= 2;
+        names = realloc(names, sizeof(char *) * name_cap);
+      }
+      names[name_count++] = strdup(entry->d_name);
+    }
+  }
+  closedir(dir);
+  qsort(names, name_count, sizeof(char *), compare_strings);
+
+  struct stats_list all = {0};
+  for (size_t i = 0; i < name_count; i++) {
+    profile_query_file(queries_dir, names[i], &corpus, iterations, top, &all);
+  }
+
+  qsort(all.stats, all.len, sizeof(struct pattern_stats), compare_by_time);
+  printf("most expensive patterns:\n");
+  printf("  %-4s %-18s %-8s %-6s %12s %10s\n", "rank", "query", "pattern",
+         "line", "ms/iter", "matches");
+  for (size_t i = 0; i < all.len && (int)i < top; i++) {
+    struct pattern_stats *stats = &all.stats[i];
+    printf("  %-4zu %-18s %-8u %-6u %12.3f %10llu\n", i + 1, stats->query_name,
+           stats->pattern_index, stats->line, stats->seconds * 1e3 / iterations,
+           (unsigned long long)stats->matches);
+  }
+
+  free(all.stats);
+  for (size_t i = 0; i < name_count; i++) {
+    free(names[i]);
+  }
+  free(names);
+  for (size_t s = 0; s < corpus.len; s++) {
+    ts_tree_delete(corpus.sources[s].tree);
+    free(corpus.sources[s].path);
+    free(corpus.sources[s].text);
+  }
+  free(corpus.sources);
+  ts_parser_delete(parser);
+  return 0;
+}
@@ -0,0 +1,302 @@
+#include "tree-sitter-koka-utils.h"
+#include <stdbool.h>
+#include <stdlib.h>
+#include <string.h>
+
+// The fixities std/core declares. Keep in sync with the standard library.
+static const struct {
+  const char *name;
+  int32_t precedence;
+  TSKokaAssociativity associativity;
+} DEFAULT_FIXITIES[] = {
+    {"^", 80, TSKokaAssociativityRight},
+    {"*", 70, TSKokaAssociativityLeft},
+    {"%", 70, TSKokaAssociativityLeft},
+    {"/", 70, TSKokaAssociativityLeft},
+    {"cdiv", 70, TSKokaAssociativityLeft},
+    {"cmod", 70, TSKokaAssociativityLeft},
+    {"++", 60, TSKokaAssociativityRight},
+    {"+", 60, TSKokaAssociativityLeft},
+    {"-", 60, TSKokaAssociativityLeft},
+    {"!=", 40, TSKokaAssociativityNone},
+    {"==", 40, TSKokaAssociativityNone},
+    {"<=", 40, TSKokaAssociativityNone},
+    {">=", 40, TSKokaAssociativityNone},
+    {"<", 40, TSKokaAssociativityNone},
+    {">", 40, TSKokaAssociativityNone},
+    {"&&", 30, TSKokaAssociativityRight},
+    {"||", 20, TSKokaAssociativityRight},
+};
+
+#define DEFAULT_FIXITY_COUNT                                                   \
+  (sizeof(DEFAULT_FIXITIES) / sizeof(DEFAULT_FIXITIES[0]))
+
+// Operators without a declaration.
+static const TSKokaFixity UNDECLARED = {50, TSKokaAssociativityLeft};
+
+// The depth of operator expression that reassociating doesn't allocate for.
+#define STACK_SIZE 32
+
+struct entry {
+  char *name;
+  uint32_t name_len;
+  TSKokaFixity fixity;
+};
+
+struct TSKokaFixityTable {
+  struct entry *entries;
+  uint32_t count;
+  uint32_t capacity;
+  TSSymbol modulebody, fixitydecl, fixity, oplist, idop, qoperator,
+      linecomment, blockcomment;
+};
+
+static TSSymbol symbol(const TSLanguage *language, const char *name) {
+  return ts_language_symbol_for_name(language, name, (uint32_t)strlen(name),
+                                     true);
+}
+
+TSKokaFixityTable *
+tree_sitter_koka_fixity_table_new(const TSLanguage *language) {
+  TSKokaFixityTable *table = calloc(1, sizeof(TSKokaFixityTable));
+  table->modulebody = symbol(language, "modulebody");
+  table->fixitydecl = symbol(language, "fixitydecl");
+  table->fixity = symbol(language, "fixity");
+  table->oplist = symbol(language, "oplist");
+  table->idop = symbol(language, "idop");
+  table->qoperator = symbol(language, "qoperator");
+  table->linecomment = symbol(language, "linecomment");
+  table->blockcomment = symbol(language, "blockcomment");
+  for (size_t i = 0; i < DEFAULT_FIXITY_COUNT; i++) {
+    tree_sitter_koka_fixity_table_set(
+        table, DEFAULT_FIXITIES[i].name,
+        (uint32_t)strlen(DEFAULT_FIXITIES[i].name),
+        (TSKokaFixity){DEFAULT_FIXITIES[i].precedence,
+                       DEFAULT_FIXITIES[i].associativity});
+  }
+  return table;
+}
+
+void tree_sitter_koka_fixity_table_delete(TSKokaFixityTable *table) {
+  for (uint32_t i = 0; i < table->count; i++) {
+    free(table->entries[i].name);
+  }
+  free(table->entries);
+  free(table);
+}
+
+static struct entry *find(const TSKokaFixityTable *table, const char *name,
+                          uint32_t name_len) {
+  for (uint32_t i = 0; i < table->count; i++) {
+    struct entry *entry = &table->entries[i];
+    if (entry->name_len == name_len &&
+        memcmp(entry->name, name, name_len) == 0) {
+      return entry;
+    }
+  }
+  return NULL;
+}
+
+void tree_sitter_koka_fixity_table_set(TSKokaFixityTable *table,
+                                       const char *name, uint32_t name_len,
+                                       TSKokaFixity fixity) {
+  struct entry *entry = find(table, name, name_len);
+  if (!entry) {
+    if (table->count == table->capacity) {
+      table->capacity = table->capacity == 0 ? 32 : table->capacity * 2;
+      table->entries =
+          realloc(table->entries, sizeof(struct entry) * table->capacity);
+    }
+    entry = &table->entries[table->count++];
+    entry->name = malloc(name_len);
+    memcpy(entry->name, name, name_len);
+    entry->name_len = name_len;
+  }
+  entry->fixity = fixity;
+}
+
+TSKokaFixity tree_sitter_koka_fixity_table_get(const TSKokaFixityTable *table,
+                                               const char *name,
+                                               uint32_t name_len) {
+  const struct entry *entry = find(table, name, name_len);
+  return entry ? entry->fixity : UNDECLARED;
+}
+
+// Adds the operators of a fixitydecl node.
+static void add_declaration(TSKokaFixityTable *table, TSNode decl,
+                            const char *source, uint32_t source_len) {
+  TSNode fixity = {0}, oplist = {0};
+  uint32_t count = ts_node_named_child_count(decl);
+  for (uint32_t i = 0; i < count; i++) {
+    TSNode child = ts_node_named_child(decl, i);
+    if (ts_node_symbol(child) == table->fixity) {
+      fixity = child;
+    } else if (ts_node_symbol(child) == table->oplist) {
+      oplist = child;
+    }
+  }
+  if (ts_node_is_null(fixity) || ts_node_is_null(oplist) ||
+      ts_node_end_byte(decl) > source_len) {
+    return;
+  }
+
+  // The keyword is infix, infixl or infixr, followed by the precedence.
+  TSNode keyword = ts_node_child(fixity, 0);
+  uint32_t keyword_end = ts_node_end_byte(keyword);
+  TSKokaFixity value = {0, TSKokaAssociativityNone};
+  if (source[keyword_end - 1] == 'l') {
+    value.associativity = TSKokaAssociativityLeft;
+  } else if (source[keyword_end - 1] == 'r') {
+    value.associativity = TSKokaAssociativityRight;
+  }
+  TSNode level = ts_node_named_child(fixity, 0);
+  for (uint32_t i = ts_node_start_byte(level); i < ts_node_end_byte(level);
+       i++) {
+    if (source[i] >= '0' && source[i] <= '9') {
+      value.precedence = value.precedence * 10 + (source[i] - '0');
+    }
+  }
+
+  uint32_t op_count = ts_node_named_child_count(oplist);
+  for (uint32_t i = 0; i < op_count; i++) {
+    // An identifier, whose only child is a varid or an idop such as (+).
+    TSNode name = ts_node_named_child(ts_node_named_child(oplist, i), 0);
+    uint32_t start = ts_node_start_byte(name);
+    uint32_t end = ts_node_end_byte(name);
+    if (ts_node_symbol(name) == table->idop && end - start > 2) {
+      start++;
+      end--;
+    }
+    tree_sitter_koka_fixity_table_set(table, source + start, end - start,
+                                      value);
+  }
+}
+
+void tree_sitter_koka_fixity_table_add_module(TSKokaFixityTable *table,
+                                              TSNode root, const char *source,
+                                              uint32_t source_len) {
+  // Fixity declarations are children of the module bodies under the program,
+  // after the imports.
+  uint32_t body_count = ts_node_named_child_count(root);
+  for (uint32_t i = 0; i < body_count; i++) {
+    TSNode body = ts_node_named_child(root, i);
+    if (ts_node_symbol(body) != table->modulebody) {
+      continue;
+    }
+    uint32_t decl_count = ts_node_named_child_count(body);
+    for (uint32_t j = 0; j < decl_count; j++) {
+      TSNode decl = ts_node_named_child(body, j);
+      if (ts_node_symbol(decl) == table->fixitydecl) {
+        add_declaration(table, decl, source, source_len);
+      }
+    }
+  }
+}
+
+struct pending_operator {
+  TSNode op;
+  TSKokaFixity fixity;
+  bool ambiguous;
+};
+
+// Whether the operator on top of the stack binds tighter than next, which
+// follows it, marking both as ambiguous if neither does.
+static bool binds_tighter(struct pending_operator *top,
+                          struct pending_operator *next) {
+  if (top->fixity.precedence != next->fixity.precedence) {
+    return top->fixity.precedence > next->fixity.precedence;
+  }
+  if (top->fixity.associativity == next->fixity.associativity &&
+      top->fixity.associativity != TSKokaAssociativityNone) {
+    return top->fixity.associativity == TSKokaAssociativityLeft;
+  }
+  top->ambiguous = true;
+  next->ambiguous = true;
+  return true;
+}
+
+uint32_t tree_sitter_koka_reassociate(const TSKokaFixityTable *table,
+                                      TSNode opexpr, const char *source,
+                                      TSKokaOperatorNode *nodes,
+                                      uint32_t capacity) {
+  uint32_t child_count = ts_node_child_count(opexpr);
+  uint32_t operand_count = 0;
+  for (uint32_t i = 0; i < child_count; i++) {
+    TSNode child = ts_node_child(opexpr, i);
+    TSSymbol sym = ts_node_symbol(child);
+    if (ts_node_is_named(child) && sym != table->qoperator &&
+        sym != table->linecomment && sym != table->blockcomment) {
+      operand_count++;
+    }
+  }
+  uint32_t node_count = operand_count > 0 ? operand_count * 2 - 1 : 0;
+  if (node_count > capacity || node_count == 0) {
+    return node_count;
+  }
+
+  // The operands and operators that haven't been combined yet.
+  uint32_t operand_stack_buffer[STACK_SIZE];
+  struct pending_operator operator_stack_buffer[STACK_SIZE];
+  uint32_t *operands = operand_stack_buffer;
+  struct pending_operator *operators = operator_stack_buffer;
+  if (child_count > STACK_SIZE) {
+    operands = malloc(sizeof(uint32_t) * child_count);
+    operators = malloc(sizeof(struct pending_operator) * child_count);
+  }
+  uint32_t operand_top = 0, operator_top = 0, count = 0;
+
+  for (uint32_t i = 0; i <= child_count; i++) {
+    TSNode child = {0};
+    bool is_operator = false;
+    if (i < child_count) {
+      child = ts_node_child(opexpr, i);
+      TSSymbol sym = ts_node_symbol(child);
+      if (!ts_node_is_named(child) || sym == table->linecomment ||
+          sym == table->blockcomment) {
+        continue;
+      }
+      if (sym != table->qoperator) {
+        nodes[count] = (TSKokaOperatorNode){
+            .node = child,
+            .left = TS_KOKA_OPERATOR_NONE,
+            .right = TS_KOKA_OPERATOR_NONE,
+        };
+        operands[operand_top++] = count++;
+        continue;
+      }
+      is_operator = true;
+    }
+
+    struct pending_operator next = {0};
+    if (is_operator) {
+      next.op = ts_node_named_child(child, 0);
+      uint32_t start = ts_node_start_byte(next.op);
+      next.fixity = tree_sitter_koka_fixity_table_get(
+          table, source + start, ts_node_end_byte(next.op) - start);
+    }
+    // At the end, every remaining operator is combined.
+    while (operator_top > 0 && operand_top >= 2 &&
+           (!is_operator ||
+            binds_tighter(&operators[operator_top - 1], &next))) {
+      struct pending_operator *top = &operators[--operator_top];
+      uint32_t right = operands[--operand_top];
+      uint32_t left = operands[--operand_top];
+      nodes[count] = (TSKokaOperatorNode){
+          .node = top->op,
+          .left = left,
+          .right = right,
+          .ambiguous = top->ambiguous,
+      };
+      operands[operand_top++] = count++;
+    }
+    if (is_operator) {
+      operators[operator_top++] = next;
+    }
+  }
+
+  if (operands != operand_stack_buffer) {
+    free(operands);
+    free(operators);
+  }
+  return count;
+}
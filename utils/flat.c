@@ -0,0 +1,174 @@
+#include "tree-sitter-koka-utils.h"
+#include <string.h>
+
+// The arrays of 32-bit values come first, then 16-bit and then 8-bit ones, so
+// that every array is aligned.
+#define FLAT_WIDE_ARRAYS 5
+#define FLAT_NARROW_ARRAYS 2
+#define FLAT_BYTE_ARRAYS 1
+
+#define FLAT_MAGIC "TSKOKAFT"
+#define FLAT_BYTE_ORDER 0x01020304u
+
+typedef struct {
+  char magic[8];
+  uint32_t version;
+  uint32_t byte_order;
+  uint32_t node_count;
+  uint32_t symbol_count;
+  uint32_t field_count;
+  uint32_t language_version;
+  uint32_t reserved;
+} FlatHeader;
+
+static size_t flat_arrays_size(uint32_t node_count) {
+  return (size_t)node_count *
+         (FLAT_WIDE_ARRAYS * sizeof(uint32_t) +
+          FLAT_NARROW_ARRAYS * sizeof(uint16_t) + FLAT_BYTE_ARRAYS);
+}
+
+// Lays out the arrays of a tree of node_count nodes from base.
+static TSKokaFlatTree flat_tree_at(void *base, uint32_t node_count) {
+  TSKokaFlatTree tree = {.node_count = node_count};
+  tree.start_bytes = base;
+  tree.end_bytes = tree.start_bytes + node_count;
+  tree.parents = tree.end_bytes + node_count;
+  tree.first_children = tree.parents + node_count;
+  tree.next_siblings = tree.first_children + node_count;
+  tree.symbols = (TSSymbol *)(tree.next_siblings + node_count);
+  tree.fields = tree.symbols + node_count;
+  tree.flags = (uint8_t *)(tree.fields + node_count);
+  return tree;
+}
+
+static uint8_t node_flags(TSNode node) {
+  uint8_t flags = 0;
+  if (ts_node_is_named(node)) {
+    flags |= TSKokaFlatNamed;
+  }
+  if (ts_node_is_error(node)) {
+    flags |= TSKokaFlatError;
+  }
+  if (ts_node_is_missing(node)) {
+    flags |= TSKokaFlatMissing;
+  }
+  if (ts_node_has_error(node)) {
+    flags |= TSKokaFlatHasError;
+  }
+  return flags;
+}
+
+size_t tree_sitter_koka_flat_tree_size(TSNode root) {
+  return flat_arrays_size(ts_node_descendant_count(root));
+}
+
+bool tree_sitter_koka_flatten(TSNode root, void *arena, size_t arena_size,
+                              TSKokaFlatTree *tree) {
+  uint32_t node_count = ts_node_descendant_count(root);
+  if (arena_size < flat_arrays_size(node_count)) {
+    return false;
+  }
+  TSKokaFlatTree flat = flat_tree_at(arena, node_count);
+
+  TSTreeCursor cursor = ts_tree_cursor_new(root);
+  uint32_t count = 0;
+  uint32_t current = TS_KOKA_FLAT_NONE;
+  uint32_t parent = TS_KOKA_FLAT_NONE;
+  bool walking = true;
+  while (walking && count < node_count) {
+    TSNode node = ts_tree_cursor_current_node(&cursor);
+    uint32_t index = count++;
+    flat.start_bytes[index] = ts_node_start_byte(node);
+    flat.end_bytes[index] = ts_node_end_byte(node);
+    flat.parents[index] = parent;
+    flat.first_children[index] = TS_KOKA_FLAT_NONE;
+    flat.next_siblings[index] = TS_KOKA_FLAT_NONE;
+    flat.symbols[index] = ts_node_symbol(node);
+    flat.fields[index] = ts_tree_cursor_current_field_id(&cursor);
+    flat.flags[index] = node_flags(node);
+    if (current != TS_KOKA_FLAT_NONE) {
+      // The node we just came from is either our parent or our previous
+      // sibling.
+      if (current == parent) {
+        flat.first_children[current] = index;
+      } else {
+        flat.next_siblings[current] = index;
+      }
+    }
+    current = index;
+
+    if (ts_tree_cursor_goto_first_child(&cursor)) {
+      parent = current;
+      continue;
+    }
+    while (!ts_tree_cursor_goto_next_sibling(&cursor)) {
+      if (!ts_tree_cursor_goto_parent(&cursor)) {
+        walking = false;
+        break;
+      }
+      current = parent;
+      parent = flat.parents[current];
+    }
+  }
+
+  ts_tree_cursor_delete(&cursor);
+  flat.node_count = count;
+  *tree = flat;
+  return true;
+}
+
+size_t tree_sitter_koka_flat_tree_serialize(const TSKokaFlatTree *tree,
+                                            const TSLanguage *language,
+                                            void *buffer, size_t capacity) {
+  size_t size = sizeof(FlatHeader) + flat_arrays_size(tree->node_count);
+  if (size > capacity) {
+    return size;
+  }
+
+  FlatHeader header = {
+      .version = TS_KOKA_FLAT_FORMAT_VERSION,
+      .byte_order = FLAT_BYTE_ORDER,
+      .node_count = tree->node_count,
+      .symbol_count = ts_language_symbol_count(language),
+      .field_count = ts_language_field_count(language),
+      .language_version = ts_language_version(language),
+  };
+  memcpy(header.magic, FLAT_MAGIC, sizeof(header.magic));
+  memcpy(buffer, &header, sizeof(header));
+
+  uint32_t n = tree->node_count;
+  TSKokaFlatTree out = flat_tree_at((char *)buffer + sizeof(header), n);
+  memcpy(out.start_bytes, tree->start_bytes, n * sizeof(uint32_t));
+  memcpy(out.end_bytes, tree->end_bytes, n * sizeof(uint32_t));
+  memcpy(out.parents, tree->parents, n * sizeof(uint32_t));
+  memcpy(out.first_children, tree->first_children, n * sizeof(uint32_t));
+  memcpy(out.next_siblings, tree->next_siblings, n * sizeof(uint32_t));
+  memcpy(out.symbols, tree->symbols, n * sizeof(TSSymbol));
+  memcpy(out.fields, tree->fields, n * sizeof(TSFieldId));
+  memcpy(out.flags, tree->flags, n);
+  return size;
+}
+
+bool tree_sitter_koka_flat_tree_load(const void *data, size_t size,
+                                     const TSLanguage *language,
+                                     TSKokaFlatTree *tree) {
+  FlatHeader header;
+  if (size < sizeof(header)) {
+    return false;
+  }
+  memcpy(&header, data, sizeof(header));
+  if (memcmp(header.magic, FLAT_MAGIC, sizeof(header.magic)) != 0 ||
+      header.version != TS_KOKA_FLAT_FORMAT_VERSION ||
+      header.byte_order != FLAT_BYTE_ORDER ||
+      header.symbol_count != ts_language_symbol_count(language) ||
+      header.field_count != ts_language_field_count(language) ||
+      header.language_version != ts_language_version(language) ||
+      size - sizeof(header) < flat_arrays_size(header.node_count)) {
+    return false;
+  }
+
+  // The arrays aren't const so that loaded and flattened trees have the same
+  // type; callers must not write through them if data is read-only.
+  *tree = flat_tree_at((char *)data + sizeof(header), header.node_count);
+  return true;
+}
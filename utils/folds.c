@@ -0,0 +1,106 @@
+#include "tree-sitter-koka-utils.h"
+#include <stdbool.h>
+#include <string.h>
+
+// Keep in sync with queries/folds.scm.
+static const char *const FOLD_NODE_TYPES[] = {
+    "block",      "funbody",    "matchexpr",    "handlerexpr",
+    "opdecls",    "externbody", "blockcomment",
+};
+
+#define FOLD_NODE_TYPE_COUNT                                                   \
+  (sizeof(FOLD_NODE_TYPES) / sizeof(FOLD_NODE_TYPES[0]))
+
+// Whether the part of the node's last line that it covers holds nothing but
+// whitespace and closing brackets, in which case that line stays visible when
+// the node is folded.
+static bool ends_with_closing_line(const char *source, uint32_t source_len,
+                                   TSNode node) {
+  TSPoint end = ts_node_end_point(node);
+  uint32_t end_byte = ts_node_end_byte(node);
+  if (end_byte > source_len || end.column > end_byte) {
+    return false;
+  }
+
+  for (uint32_t i = end_byte - end.column; i < end_byte; i++) {
+    switch (source[i]) {
+    case ' ':
+    case '\t':
+    case '\r':
+    case '}':
+    case ')':
+    case ']':
+      break;
+
+    default:
+      return false;
+    }
+  }
+  return true;
+}
+
+uint32_t tree_sitter_koka_folding_ranges(TSNode root, const char *source,
+                                         uint32_t source_len,
+                                         TSKokaFoldingRange *ranges,
+                                         uint32_t capacity) {
+  const TSLanguage *language = ts_node_language(root);
+  TSSymbol fold_symbols[FOLD_NODE_TYPE_COUNT];
+  for (size_t i = 0; i < FOLD_NODE_TYPE_COUNT; i++) {
+    fold_symbols[i] = ts_language_symbol_for_name(
+        language, FOLD_NODE_TYPES[i], (uint32_t)strlen(FOLD_NODE_TYPES[i]),
+        true);
+  }
+  TSSymbol blockcomment = fold_symbols[FOLD_NODE_TYPE_COUNT - 1];
+
+  uint32_t count = 0;
+  bool have_last_start_line = false;
+  uint32_t last_start_line = 0;
+
+  TSTreeCursor cursor = ts_tree_cursor_new(root);
+  while (true) {
+    TSNode node = ts_tree_cursor_current_node(&cursor);
+    uint32_t start_line = ts_node_start_point(node).row;
+    uint32_t end_line = ts_node_end_point(node).row;
+
+    // Nothing inside a single-line node can span lines, so don't descend.
+    bool multiline = end_line > start_line;
+    if (multiline) {
+      TSSymbol symbol = ts_node_symbol(node);
+      bool is_fold = false;
+      for (size_t i = 0; i < FOLD_NODE_TYPE_COUNT && !is_fold; i++) {
+        is_fold = symbol == fold_symbols[i];
+      }
+
+      if (is_fold && ends_with_closing_line(source, source_len, node)) {
+        end_line--;
+      }
+      if (is_fold && end_line > start_line &&
+          (!have_last_start_line || start_line != last_start_line)) {
+        if (count < capacity) {
+          ranges[count] = (TSKokaFoldingRange){
+              .start_byte = ts_node_start_byte(node),
+              .end_byte = ts_node_end_byte(node),
+              .start_line = start_line,
+              .end_line = end_line,
+              .symbol = symbol,
+              .kind = symbol == blockcomment ? TSKokaFoldComment
+                                             : TSKokaFoldRegion,
+          };
+        }
+        count++;
+        have_last_start_line = true;
+        last_start_line = start_line;
+      }
+    }
+
+    if (multiline && ts_tree_cursor_goto_first_child(&cursor)) {
+      continue;
+    }
+    while (!ts_tree_cursor_goto_next_sibling(&cursor)) {
+      if (!ts_tree_cursor_goto_parent(&cursor)) {
+        ts_tree_cursor_delete(&cursor);
+        return count;
+      }
+    }
+  }
+}
@@ -0,0 +1,568 @@
+#include "tree-sitter-koka-utils.h"
+#include <stdbool.h>
+#include <stdlib.h>
+#include <string.h>
+
+// The formatter only ever changes whitespace between tokens, and never adds
+// or removes line breaks, so the layout of a declaration is decided by the
+// same virtual braces and semicolons before and after formatting. Lines are
+// reindented block by block: the items of a layout block get the block's new
+// column, and every other line keeps its offset from the block's first item.
+
+// Same as in src/scanner.c.
+#define TABWIDTH 8
+
+struct symbols {
+  TSSymbol modulebody, opexpr, qoperator, op, string, char_, linecomment,
+      blockcomment, idop, qidop;
+  TSSymbol lbrace, rbrace, semi;
+};
+
+static TSSymbol symbol(const TSLanguage *language, const char *name,
+                       bool named) {
+  return ts_language_symbol_for_name(language, name, (uint32_t)strlen(name),
+                                     named);
+}
+
+static void symbols_init(struct symbols *s, const TSLanguage *language) {
+  s->modulebody = symbol(language, "modulebody", true);
+  s->opexpr = symbol(language, "opexpr", true);
+  s->qoperator = symbol(language, "qoperator", true);
+  s->op = symbol(language, "op", true);
+  s->string = symbol(language, "string", true);
+  s->char_ = symbol(language, "char", true);
+  s->linecomment = symbol(language, "linecomment", true);
+  s->blockcomment = symbol(language, "blockcomment", true);
+  s->idop = symbol(language, "idop", true);
+  s->qidop = symbol(language, "qidop", true);
+  s->lbrace = symbol(language, "{", false);
+  s->rbrace = symbol(language, "}", false);
+  s->semi = symbol(language, ";", false);
+}
+
+// Nodes whose text is copied as it is, since the whitespace inside them is
+// either significant or part of one token.
+static bool is_atomic(const struct symbols *s, TSSymbol sym) {
+  return sym == s->string || sym == s->char_ || sym == s->linecomment ||
+         sym == s->blockcomment || sym == s->idop || sym == s->qidop ||
+         sym == s->op;
+}
+
+static bool is_comment(const struct symbols *s, TSSymbol sym) {
+  return sym == s->linecomment || sym == s->blockcomment;
+}
+
+struct token {
+  uint32_t start;
+  uint32_t end;
+  TSSymbol symbol;
+  // The operator of a binary operator expression.
+  bool binary;
+};
+
+struct block {
+  // The columns of the block's first item before and after formatting.
+  uint32_t old_column;
+  uint32_t new_column;
+  // The indentation of the line the block was opened on.
+  uint32_t opener_indent;
+  // Whether the first item hasn't been reached yet.
+  bool pending;
+};
+
+struct formatter {
+  struct symbols s;
+  const char *source;
+  uint32_t indent_width;
+  TSTreeCursor cursor;
+  TSParser *parser;
+
+  struct token *tokens;
+  uint32_t token_count, token_capacity;
+  TSSymbol *path;
+  uint32_t path_capacity;
+  struct block *blocks;
+  uint32_t block_count, block_capacity;
+
+  char *text;
+  size_t text_len, text_capacity;
+  TSKokaFormatEdit *edits;
+  uint32_t edit_count, edit_capacity;
+
+  // The state of the line being written.
+  uint32_t column;
+  uint32_t line_indent;
+  // Whether the last token was a brace or semicolon, so the next line starts
+  // a new item.
+  bool separated;
+};
+
+static void append(struct formatter *f, const char *text, size_t len) {
+  if (f->text_len + len > f->text_capacity) {
+    size_t capacity = f->text_capacity == 0 ? 4096 : f->text_capacity * 2;
+    while (capacity < f->text_len + len) {
+      capacity *= 2;
+    }
+    f->text = realloc(f->text, capacity);
+    f->text_capacity = capacity;
+  }
+  memcpy(f->text + f->text_len, text, len);
+  f->text_len += len;
+
+  for (size_t i = 0; i < len; i++) {
+    if (text[i] == '\n') {
+      f->column = 0;
+    } else if (text[i] == '\t') {
+      f->column += TABWIDTH - f->column % TABWIDTH;
+    } else if (((unsigned char)text[i] & 0xc0) != 0x80) {
+      f->column++;
+    }
+  }
+}
+
+static void append_spaces(struct formatter *f, uint32_t count) {
+  static const char SPACES[] = "                                ";
+  while (count > 0) {
+    uint32_t n = count < sizeof(SPACES) - 1 ? count : sizeof(SPACES) - 1;
+    append(f, SPACES, n);
+    count -= n;
+  }
+}
+
+static void push_token(struct formatter *f, struct token token) {
+  if (f->token_count == f->token_capacity) {
+    f->token_capacity = f->token_capacity == 0 ? 256 : f->token_capacity * 2;
+    f->tokens = realloc(f->tokens, sizeof(struct token) * f->token_capacity);
+  }
+  f->tokens[f->token_count++] = token;
+}
+
+static void push_block(struct formatter *f) {
+  if (f->block_count == f->block_capacity) {
+    f->block_capacity = f->block_capacity == 0 ? 16 : f->block_capacity * 2;
+    f->blocks = realloc(f->blocks, sizeof(struct block) * f->block_capacity);
+  }
+  f->blocks[f->block_count++] = (struct block){
+      .opener_indent = f->line_indent,
+      .pending = true,
+  };
+  f->separated = true;
+}
+
+// The column that byte is at in the source.
+static uint32_t source_column(const char *source, uint32_t byte) {
+  uint32_t line_start = byte;
+  while (line_start > 0 && source[line_start - 1] != '\n') {
+    line_start--;
+  }
+  uint32_t column = 0;
+  for (uint32_t i = line_start; i < byte; i++) {
+    if (source[i] == '\t') {
+      column += TABWIDTH - column % TABWIDTH;
+    } else if (((unsigned char)source[i] & 0xc0) != 0x80) {
+      column++;
+    }
+  }
+  return column;
+}
+
+// Collects the tokens of unit in order, including the zero-width braces and
+// semicolons inserted by the scanner.
+static void collect_tokens(struct formatter *f, TSNode unit) {
+  f->token_count = 0;
+  uint32_t depth = 0;
+  ts_tree_cursor_reset(&f->cursor, unit);
+  while (true) {
+    TSNode node = ts_tree_cursor_current_node(&f->cursor);
+    TSSymbol sym = ts_node_symbol(node);
+    if (depth == f->path_capacity) {
+      f->path_capacity = f->path_capacity == 0 ? 64 : f->path_capacity * 2;
+      f->path = realloc(f->path, sizeof(TSSymbol) * f->path_capacity);
+    }
+    f->path[depth] = sym;
+
+    if (!is_atomic(&f->s, sym) && ts_tree_cursor_goto_first_child(&f->cursor)) {
+      depth++;
+      continue;
+    }
+    push_token(f, (struct token){
+                      .start = ts_node_start_byte(node),
+                      .end = ts_node_end_byte(node),
+                      .symbol = sym,
+                      .binary = sym == f->s.op && depth >= 2 &&
+                                f->path[depth - 1] == f->s.qoperator &&
+                                f->path[depth - 2] == f->s.opexpr,
+                  });
+
+    while (!ts_tree_cursor_goto_next_sibling(&f->cursor)) {
+      if (depth == 0 || !ts_tree_cursor_goto_parent(&f->cursor)) {
+        return;
+      }
+      depth--;
+    }
+  }
+}
+
+static bool token_is(const struct formatter *f, const struct token *token,
+                     const char *text) {
+  size_t len = strlen(text);
+  return token->end - token->start == len &&
+         memcmp(f->source + token->start, text, len) == 0;
+}
+
+static bool is_open_bracket(const struct formatter *f,
+                            const struct token *token) {
+  return token_is(f, token, "(") || token_is(f, token, "[");
+}
+
+static bool is_close_bracket(const struct formatter *f,
+                             const struct token *token) {
+  return token_is(f, token, ")") || token_is(f, token, "]");
+}
+
+static bool is_spaced(const struct formatter *f, const struct token *token) {
+  return token->binary || token_is(f, token, "=") ||
+         token_is(f, token, "->") || token_is(f, token, ":=") ||
+         token_is(f, token, "<-");
+}
+
+// The spacing between two tokens on the same line that had had_space between
+// them.
+static uint32_t spaces_between(const struct formatter *f,
+                               const struct token *before,
+                               const struct token *after, bool had_space) {
+  if (token_is(f, after, ",") || token_is(f, after, ";") ||
+      is_close_bracket(f, after)) {
+    return 0;
+  }
+  if (token_is(f, before, ",")) {
+    return 1;
+  }
+  if (is_open_bracket(f, before)) {
+    return 0;
+  }
+  if (is_spaced(f, before) || is_spaced(f, after)) {
+    return 1;
+  }
+  return had_space ? 1 : 0;
+}
+
+// The number of zero-width closing braces following the token at index,
+// which is how many blocks an explicit closing brace ends.
+static uint32_t closes_after(const struct formatter *f, uint32_t index) {
+  uint32_t count = 0;
+  for (uint32_t i = index + 1; i < f->token_count; i++) {
+    const struct token *token = &f->tokens[i];
+    if (token->start != token->end) {
+      break;
+    }
+    if (token->symbol == f->s.rbrace) {
+      count++;
+    }
+  }
+  return count;
+}
+
+// The indentation of a line starting with the token at index.
+static uint32_t line_indent(const struct formatter *f, uint32_t index) {
+  const struct token *token = &f->tokens[index];
+  const struct block *top = &f->blocks[f->block_count - 1];
+
+  // An explicit closing brace lines up with the line its block was opened on.
+  if (token_is(f, token, "}")) {
+    uint32_t closes = closes_after(f, index);
+    if (closes > 0 && closes < f->block_count) {
+      return f->blocks[f->block_count - closes].opener_indent;
+    }
+  }
+
+  if (top->pending) {
+    uint32_t indent = top->opener_indent + f->indent_width;
+    if (f->block_count < 2) {
+      return indent;
+    }
+    uint32_t nested =
+        f->blocks[f->block_count - 2].new_column + f->indent_width;
+    return indent > nested ? indent : nested;
+  }
+  if (f->separated) {
+    return top->new_column;
+  }
+  int64_t indent = (int64_t)top->new_column +
+                   source_column(f->source, token->start) - top->old_column;
+  return indent > 0 ? (uint32_t)indent : 0;
+}
+
+static bool gap_is_blank(const char *source, uint32_t start, uint32_t end,
+                         uint32_t *newlines) {
+  *newlines = 0;
+  for (uint32_t i = start; i < end; i++) {
+    switch (source[i]) {
+    case '\n':
+      (*newlines)++;
+      break;
+
+    case ' ':
+    case '\t':
+    case '\r':
+      break;
+
+    default:
+      return false;
+    }
+  }
+  return true;
+}
+
+// Writes the whitespace between the previous token and the token at index.
+static void write_gap(struct formatter *f, uint32_t previous, uint32_t index) {
+  const struct token *token = &f->tokens[index];
+  uint32_t start = f->tokens[previous].end;
+  uint32_t newlines;
+  if (!gap_is_blank(f->source, start, token->start, &newlines)) {
+    append(f, f->source + start, token->start - start);
+  } else if (newlines == 0) {
+    append_spaces(f, spaces_between(f, &f->tokens[previous], token,
+                                    token->start > start));
+  } else {
+    // Keep at most one blank line.
+    append(f, "\n\n", newlines > 1 ? 2 : 1);
+    f->line_indent = line_indent(f, index);
+    append_spaces(f, f->line_indent);
+  }
+
+  // A comment after an opening brace doesn't decide where the block's items
+  // go.
+  struct block *top = &f->blocks[f->block_count - 1];
+  if (top->pending && !is_comment(&f->s, token->symbol)) {
+    top->old_column = source_column(f->source, token->start);
+    top->new_column = f->column;
+    top->pending = false;
+  }
+}
+
+// Formats the declaration from start to end, whose tokens have been
+// collected, appending it to the text.
+static void write_unit(struct formatter *f, uint32_t start, uint32_t end,
+                       bool at_eof) {
+  f->block_count = 0;
+  f->line_indent = 0;
+  f->column = 0;
+  push_block(f);
+  f->blocks[0].pending = false;
+
+  uint32_t previous = UINT32_MAX;
+  for (uint32_t i = 0; i < f->token_count; i++) {
+    const struct token *token = &f->tokens[i];
+    if (token->start != token->end) {
+      if (previous != UINT32_MAX) {
+        write_gap(f, previous, i);
+      }
+      append(f, f->source + token->start, token->end - token->start);
+      previous = i;
+      if (!is_comment(&f->s, token->symbol)) {
+        f->separated = false;
+      }
+    }
+
+    if (token->symbol == f->s.lbrace) {
+      push_block(f);
+    } else if (token->symbol == f->s.rbrace) {
+      if (f->block_count > 1) {
+        f->block_count--;
+      }
+    } else if (token->symbol == f->s.semi) {
+      f->separated = true;
+    }
+  }
+
+  // What follows the last token up to the next declaration, which the
+  // declaration's virtual closing braces are attached to.
+  uint32_t last = previous == UINT32_MAX ? start : f->tokens[previous].end;
+  uint32_t newlines;
+  bool at_line_start = f->source[end - 1] == '\n';
+  if (gap_is_blank(f->source, last, end, &newlines) && newlines > 0 &&
+      at_line_start) {
+    append(f, "\n\n", newlines > 1 && !at_eof ? 2 : 1);
+  } else {
+    append(f, f->source + last, end - last);
+  }
+}
+
+// The declaration in a tree parsed from the text of a single one.
+static bool lone_unit(const struct symbols *s, TSTree *tree, TSNode *unit) {
+  TSNode root = ts_tree_root_node(tree);
+  if (ts_node_has_error(root)) {
+    return false;
+  }
+  uint32_t units = 0;
+  uint32_t count = ts_node_named_child_count(root);
+  for (uint32_t i = 0; i < count; i++) {
+    TSNode body = ts_node_named_child(root, i);
+    if (ts_node_symbol(body) != s->modulebody) {
+      continue;
+    }
+    uint32_t body_count = ts_node_named_child_count(body);
+    for (uint32_t j = 0; j < body_count; j++) {
+      *unit = ts_node_named_child(body, j);
+      units++;
+    }
+  }
+  return units == 1;
+}
+
+// Whether two subtrees have the same nodes, ignoring where they are.
+static bool same_shape(TSNode a, TSNode b) {
+  TSTreeCursor ca = ts_tree_cursor_new(a);
+  TSTreeCursor cb = ts_tree_cursor_new(b);
+  bool same = true;
+  while (same) {
+    TSNode na = ts_tree_cursor_current_node(&ca);
+    TSNode nb = ts_tree_cursor_current_node(&cb);
+    if (ts_node_symbol(na) != ts_node_symbol(nb) ||
+        ts_node_child_count(na) != ts_node_child_count(nb)) {
+      same = false;
+      break;
+    }
+    if (ts_tree_cursor_goto_first_child(&ca)) {
+      ts_tree_cursor_goto_first_child(&cb);
+      continue;
+    }
+    bool more = true;
+    while (!ts_tree_cursor_goto_next_sibling(&ca)) {
+      if (!ts_tree_cursor_goto_parent(&ca)) {
+        more = false;
+        break;
+      }
+      ts_tree_cursor_goto_parent(&cb);
+    }
+    if (!more) {
+      break;
+    }
+    ts_tree_cursor_goto_next_sibling(&cb);
+  }
+  ts_tree_cursor_delete(&ca);
+  ts_tree_cursor_delete(&cb);
+  return same;
+}
+
+// Whether the formatted text of unit parses the same way it did. The unit is
+// parsed on its own, which for most declarations gives the same tree as in
+// the module, and otherwise is compared with its original text parsed on its
+// own.
+static bool parses_same(struct formatter *f, TSNode unit, const char *text,
+                        uint32_t len) {
+  TSTree *formatted = ts_parser_parse_string(f->parser, NULL, text, len);
+  TSNode formatted_unit;
+  bool same = lone_unit(&f->s, formatted, &formatted_unit);
+  if (same && !same_shape(unit, formatted_unit)) {
+    uint32_t start = ts_node_start_byte(unit);
+    TSTree *original =
+        ts_parser_parse_string(f->parser, NULL, f->source + start,
+                               ts_node_end_byte(unit) - start);
+    TSNode original_unit;
+    same = lone_unit(&f->s, original, &original_unit) &&
+           same_shape(original_unit, formatted_unit);
+    ts_tree_delete(original);
+  }
+  ts_tree_delete(formatted);
+  return same;
+}
+
+static bool overlaps(const TSRange *ranges, uint32_t range_count,
+                     uint32_t start, uint32_t end) {
+  if (range_count == 0) {
+    return true;
+  }
+  for (uint32_t i = 0; i < range_count; i++) {
+    uint32_t range_start = ranges[i].start_byte;
+    uint32_t range_end = ranges[i].end_byte;
+    if (range_start == range_end ? start <= range_start && range_start < end
+                                 : range_start < end && start < range_end) {
+      return true;
+    }
+  }
+  return false;
+}
+
+static void format_unit(struct formatter *f, TSNode unit, uint32_t source_len) {
+  uint32_t start = ts_node_start_byte(unit);
+  uint32_t end = ts_node_end_byte(unit);
+  if (ts_node_has_error(unit) || end <= start || end > source_len ||
+      (start > 0 && f->source[start - 1] != '\n')) {
+    return;
+  }
+
+  collect_tokens(f, unit);
+  size_t text_start = f->text_len;
+  write_unit(f, start, end, end == source_len);
+  size_t len = f->text_len - text_start;
+  if ((len == end - start &&
+       memcmp(f->text + text_start, f->source + start, len) == 0) ||
+      !parses_same(f, unit, f->text + text_start, (uint32_t)len)) {
+    f->text_len = text_start;
+    return;
+  }
+
+  if (f->edit_count == f->edit_capacity) {
+    f->edit_capacity = f->edit_capacity == 0 ? 16 : f->edit_capacity * 2;
+    f->edits = realloc(f->edits, sizeof(TSKokaFormatEdit) * f->edit_capacity);
+  }
+  f->edits[f->edit_count++] = (TSKokaFormatEdit){
+      .start_byte = start,
+      .end_byte = end,
+      .text_start = (uint32_t)text_start,
+      .text_length = (uint32_t)len,
+  };
+}
+
+void tree_sitter_koka_format(const TSTree *tree, const char *source,
+                             uint32_t source_len, uint32_t indent_width,
+                             const TSRange *ranges, uint32_t range_count,
+                             TSKokaFormatResult *result) {
+  *result = (TSKokaFormatResult){0};
+  const TSLanguage *language = ts_tree_language(tree);
+  TSNode root = ts_tree_root_node(tree);
+
+  struct formatter f = {
+      .source = source,
+      .indent_width = indent_width,
+      .cursor = ts_tree_cursor_new(root),
+      .parser = ts_parser_new(),
+  };
+  symbols_init(&f.s, language);
+  ts_parser_set_language(f.parser, language);
+
+  // The declarations are the children of the module bodies, which are
+  // children of the program beside its modulepath and moduledecl.
+  uint32_t root_children = ts_node_named_child_count(root);
+  for (uint32_t i = 0; i < root_children; i++) {
+    TSNode body = ts_node_named_child(root, i);
+    if (ts_node_symbol(body) != f.s.modulebody) {
+      continue;
+    }
+    uint32_t count = ts_node_named_child_count(body);
+    for (uint32_t j = 0; j < count; j++) {
+      TSNode unit = ts_node_named_child(body, j);
+      if (overlaps(ranges, range_count, ts_node_start_byte(unit),
+                   ts_node_end_byte(unit))) {
+        format_unit(&f, unit, source_len);
+      }
+    }
+  }
+
+  ts_tree_cursor_delete(&f.cursor);
+  ts_parser_delete(f.parser);
+  free(f.tokens);
+  free(f.path);
+  free(f.blocks);
+  result->edits = f.edits;
+  result->edit_count = f.edit_count;
+  result->text = f.text;
+}
+
+void tree_sitter_koka_format_result_delete(TSKokaFormatResult *result) {
+  free(result->edits);
+  free(result->text);
+  *result = (TSKokaFormatResult){0};
+}
@@ -0,0 +1,122 @@
+#include "tree-sitter-koka-utils.h"
+#include <stdbool.h>
+#include <string.h>
+
+static bool is_ident_char(char c) {
+  return (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') ||
+         (c >= '0' && c <= '9') || c == '_' || c == '-';
+}
+
+// Whether the word at i is one of words, a NULL-terminated list.
+static bool word_is_one_of(const char *source, uint32_t source_len,
+                           uint32_t i, const char *const *words) {
+  uint32_t end = i;
+  while (end < source_len && is_ident_char(source[end])) {
+    end++;
+  }
+  for (; *words; words++) {
+    if (strlen(*words) == end - i && memcmp(source + i, *words, end - i) == 0) {
+      return true;
+    }
+  }
+  return false;
+}
+
+// Whether the line from i, its start or the end of the block comments it
+// starts with, can be part of the header: it's blank, indented, a comment or
+// a module, import or fixity declaration.
+static bool in_header(const char *source, uint32_t source_len, uint32_t i) {
+  static const char *const HEADER_WORDS[] = {
+      "module", "import", "infix", "infixl", "infixr", NULL,
+  };
+  static const char *const VISIBILITY[] = {"pub", "public", NULL};
+
+  switch (source[i]) {
+  case ' ':
+  case '\t':
+  case '\r':
+  case '\n':
+    return true;
+
+  case '/':
+    return i + 1 < source_len && (source[i + 1] == '/' || source[i + 1] == '*');
+
+  default:
+    break;
+  }
+  if (word_is_one_of(source, source_len, i, HEADER_WORDS)) {
+    return true;
+  }
+  if (!word_is_one_of(source, source_len, i, VISIBILITY)) {
+    // Anything else is a declaration, or the braces of a module body.
+    return false;
+  }
+  while (i < source_len && is_ident_char(source[i])) {
+    i++;
+  }
+  while (i < source_len && (source[i] == ' ' || source[i] == '\t')) {
+    i++;
+  }
+  return word_is_one_of(source, source_len, i, HEADER_WORDS);
+}
+
+static bool starts_block_comment(const char *source, uint32_t source_len,
+                                 uint32_t i) {
+  return i + 1 < source_len && source[i] == '/' && source[i + 1] == '*';
+}
+
+// Returns the end of the block comment, which can nest, starting at i.
+static uint32_t skip_block_comment(const char *source, uint32_t source_len,
+                                   uint32_t i) {
+  int depth = 0;
+  while (i < source_len) {
+    if (starts_block_comment(source, source_len, i)) {
+      depth++;
+      i += 2;
+    } else if (source[i] == '*' && i + 1 < source_len &&
+               source[i + 1] == '/') {
+      i += 2;
+      if (--depth == 0) {
+        break;
+      }
+    } else {
+      i++;
+    }
+  }
+  return i;
+}
+
+uint32_t tree_sitter_koka_header_length(const char *source,
+                                        uint32_t source_len) {
+  uint32_t i = 0;
+  while (i < source_len) {
+    // i is at the start of a line. Block comments at its start, which can
+    // span lines, are skipped, and the line is judged by what follows them.
+    uint32_t line_start = i;
+    while (starts_block_comment(source, source_len, i)) {
+      i = skip_block_comment(source, source_len, i);
+      while (i < source_len && (source[i] == ' ' || source[i] == '\t')) {
+        i++;
+      }
+    }
+    if (i == source_len) {
+      break;
+    }
+    if (!in_header(source, source_len, i)) {
+      return line_start;
+    }
+
+    const char *newline = memchr(source + i, '\n', source_len - i);
+    if (!newline) {
+      return source_len;
+    }
+    i = (uint32_t)(newline - source) + 1;
+  }
+  return source_len;
+}
+
+TSTree *tree_sitter_koka_parse_header(TSParser *parser, const char *source,
+                                      uint32_t source_len) {
+  return ts_parser_parse_string(
+      parser, NULL, source, tree_sitter_koka_header_length(source, source_len));
+}
@@ -0,0 +1,118 @@
+#include "tree-sitter-koka-utils.h"
+#include <stdbool.h>
+#include <stdlib.h>
+#include <string.h>
+
+static int compare_ranges(const void *a, const void *b) {
+  uint32_t sa = ((const TSRange *)a)->start_byte;
+  uint32_t sb = ((const TSRange *)b)->start_byte;
+  return sa < sb ? -1 : sa > sb ? 1 : 0;
+}
+
+static void push_span(TSKokaHighlightDelta *delta, uint32_t *cap,
+                      TSKokaHighlightSpan span) {
+  if (delta->span_count == *cap) {
+    *cap = *cap == 0 ? 64 : *cap * 2;
+    delta->spans = realloc(delta->spans, sizeof(TSKokaHighlightSpan) * *cap);
+  }
+  delta->spans[delta->span_count++] = span;
+}
+
+void tree_sitter_koka_highlight_delta(const TSTree *old_tree,
+                                      const TSTree *new_tree,
+                                      const TSQuery *query,
+                                      TSQueryCursor *cursor,
+                                      const TSRange *extra_ranges,
+                                      uint32_t extra_range_count,
+                                      TSKokaHighlightDelta *delta) {
+  *delta = (TSKokaHighlightDelta){0};
+
+  uint32_t changed_count;
+  TSRange *changed =
+      ts_tree_get_changed_ranges(old_tree, new_tree, &changed_count);
+
+  // Sort and coalesce the ranges, so no span is reported twice.
+  uint32_t range_count = changed_count + extra_range_count;
+  if (range_count == 0) {
+    free(changed);
+    return;
+  }
+  TSRange *ranges = malloc(sizeof(TSRange) * range_count);
+  if (changed_count > 0) {
+    memcpy(ranges, changed, sizeof(TSRange) * changed_count);
+  }
+  if (extra_range_count > 0) {
+    memcpy(ranges + changed_count, extra_ranges,
+           sizeof(TSRange) * extra_range_count);
+  }
+  free(changed);
+  qsort(ranges, range_count, sizeof(TSRange), compare_ranges);
+
+  uint32_t merged_count = 0;
+  for (uint32_t i = 0; i < range_count; i++) {
+    if (ranges[i].end_byte <= ranges[i].start_byte) {
+      continue;
+    }
+    if (merged_count > 0 &&
+        ranges[i].start_byte <= ranges[merged_count - 1].end_byte) {
+      TSRange *last = &ranges[merged_count - 1];
+      if (ranges[i].end_byte > last->end_byte) {
+        last->end_byte = ranges[i].end_byte;
+        last->end_point = ranges[i].end_point;
+      }
+    } else {
+      ranges[merged_count++] = ranges[i];
+    }
+  }
+  delta->invalidated = ranges;
+  delta->invalidated_count = merged_count;
+
+  TSNode root = ts_tree_root_node(new_tree);
+  uint32_t span_cap = 0;
+  for (uint32_t r = 0; r < merged_count; r++) {
+    uint32_t start = ranges[r].start_byte, end = ranges[r].end_byte;
+    ts_query_cursor_set_byte_range(cursor, start, end);
+    ts_query_cursor_exec(cursor, query, root);
+
+    TSQueryMatch match;
+    uint32_t capture_index;
+    TSNode last_node = {0};
+    bool have_last_node = false;
+    while (ts_query_cursor_next_capture(cursor, &match, &capture_index)) {
+      TSQueryCapture capture = match.captures[capture_index];
+      uint32_t span_start = ts_node_start_byte(capture.node);
+      uint32_t span_end = ts_node_end_byte(capture.node);
+      if (span_start < start) {
+        span_start = start;
+      }
+      if (span_end > end) {
+        span_end = end;
+      }
+      if (span_start >= span_end) {
+        continue;
+      }
+
+      TSKokaHighlightSpan span = {
+          .start_byte = span_start,
+          .end_byte = span_end,
+          .capture = capture.index,
+      };
+      // Captures of one node arrive in pattern order, and the last pattern
+      // wins.
+      if (have_last_node && ts_node_eq(capture.node, last_node)) {
+        delta->spans[delta->span_count - 1] = span;
+      } else {
+        push_span(delta, &span_cap, span);
+      }
+      last_node = capture.node;
+      have_last_node = true;
+    }
+  }
+  ts_query_cursor_set_byte_range(cursor, 0, UINT32_MAX);
+}
+
+void tree_sitter_koka_highlight_delta_delete(TSKokaHighlightDelta *delta) {
+  free(delta->invalidated);
+  free(delta->spans);
+  *delta = (TSKokaHighlightDelta){0};
+}
@@ -0,0 +1,418 @@
+#include "tree-sitter-koka-utils.h"
+#include <stdbool.h>
+#include <string.h>
+
+// This follows Helix's interpretation of the captures in queries/indents.scm,
+// with the patterns of that file matched directly against nodes instead of
+// through a query. Keep captures_for_node in sync with it.
+
+// Same as in src/scanner.c.
+#define TABWIDTH 8
+
+enum {
+  CAPTURE_INDENT = 1 << 0,
+  CAPTURE_INDENT_ALWAYS = 1 << 1,
+  CAPTURE_OUTDENT = 1 << 2,
+  CAPTURE_EXTEND = 1 << 3,
+  CAPTURE_EXTEND_PREVENT_ONCE = 1 << 4,
+};
+
+struct symbols {
+  TSSymbol appexpr, atom, program, moduledecl, funbody, block, handlerexpr,
+      opclausex, typedecl, typeid, opdecls, externdecl, matchexpr, matchrule,
+      opexpr, qoperator, ifexpr, elifs;
+  TSSymbol lparen, rparen, lbracket, rbracket, lbrace, rbrace, then, else_,
+      elif, arrow, fun, match;
+};
+
+static TSSymbol symbol(const TSLanguage *language, const char *name,
+                       bool named) {
+  return ts_language_symbol_for_name(language, name, (uint32_t)strlen(name),
+                                     named);
+}
+
+static void symbols_init(struct symbols *s, const TSLanguage *language) {
+  s->appexpr = symbol(language, "appexpr", true);
+  s->atom = symbol(language, "atom", true);
+  s->program = symbol(language, "program", true);
+  s->moduledecl = symbol(language, "moduledecl", true);
+  s->funbody = symbol(language, "funbody", true);
+  s->block = symbol(language, "block", true);
+  s->handlerexpr = symbol(language, "handlerexpr", true);
+  s->opclausex = symbol(language, "opclausex", true);
+  s->typedecl = symbol(language, "typedecl", true);
+  s->typeid = symbol(language, "typeid", true);
+  s->opdecls = symbol(language, "opdecls", true);
+  s->externdecl = symbol(language, "externdecl", true);
+  s->matchexpr = symbol(language, "matchexpr", true);
+  s->matchrule = symbol(language, "matchrule", true);
+  s->opexpr = symbol(language, "opexpr", true);
+  s->qoperator = symbol(language, "qoperator", true);
+  s->ifexpr = symbol(language, "ifexpr", true);
+  s->elifs = symbol(language, "elifs", true);
+  s->lparen = symbol(language, "(", false);
+  s->rparen = symbol(language, ")", false);
+  s->lbracket = symbol(language, "[", false);
+  s->rbracket = symbol(language, "]", false);
+  s->lbrace = symbol(language, "{", false);
+  s->rbrace = symbol(language, "}", false);
+  s->then = symbol(language, "then", false);
+  s->else_ = symbol(language, "else", false);
+  s->elif = symbol(language, "elif", false);
+  s->arrow = symbol(language, "->", false);
+  s->fun = symbol(language, "fun", false);
+  s->match = symbol(language, "match", false);
+}
+
+static bool has_child(TSNode node, TSSymbol a, TSSymbol b) {
+  uint32_t count = ts_node_child_count(node);
+  for (uint32_t i = 0; i < count; i++) {
+    TSSymbol child = ts_node_symbol(ts_node_child(node, i));
+    if (child == a || child == b) {
+      return true;
+    }
+  }
+  return false;
+}
+
+static bool child_is(TSNode node, uint32_t index, TSSymbol a, TSSymbol b) {
+  if (index >= ts_node_child_count(node)) {
+    return false;
+  }
+  TSSymbol child = ts_node_symbol(ts_node_child(node, index));
+  return child == a || child == b;
+}
+
+static unsigned captures_for_node(const struct symbols *s, TSNode node) {
+  TSSymbol sym = ts_node_symbol(node);
+
+  if (ts_node_is_error(node)) {
+    return has_child(node, s->fun, s->match) ? CAPTURE_INDENT | CAPTURE_EXTEND
+                                             : 0;
+  }
+
+  if (sym == s->appexpr) {
+    // Applications, i.e. a function followed by an argument list.
+    return child_is(node, 0, s->appexpr, s->appexpr) &&
+                   child_is(node, 1, s->lparen, s->lbracket)
+               ? CAPTURE_INDENT
+               : 0;
+  }
+  if (sym == s->atom) {
+    // Lists and tuples.
+    return child_is(node, 0, s->lparen, s->lbracket) ? CAPTURE_INDENT : 0;
+  }
+  if (sym == s->moduledecl) {
+    // Braced module declarations.
+    TSNode parent = ts_node_parent(node);
+    return !ts_node_is_null(parent) && ts_node_symbol(parent) == s->program &&
+                   has_child(node, s->lbrace, s->lbrace)
+               ? CAPTURE_INDENT
+               : 0;
+  }
+  if (sym == s->funbody || sym == s->block || sym == s->handlerexpr ||
+      sym == s->opclausex) {
+    return CAPTURE_INDENT;
+  }
+  if (sym == s->typedecl) {
+    // Avoid matching single-operation effects.
+    return has_child(node, s->typeid, s->opdecls)
+               ? CAPTURE_INDENT | CAPTURE_EXTEND
+               : 0;
+  }
+  if (sym == s->externdecl || sym == s->matchexpr || sym == s->matchrule ||
+      sym == s->then || sym == s->else_) {
+    return CAPTURE_INDENT | CAPTURE_EXTEND;
+  }
+  if (sym == s->arrow) {
+    TSNode parent = ts_node_parent(node);
+    if (ts_node_is_null(parent)) {
+      return 0;
+    }
+    if (ts_node_symbol(parent) == s->matchrule) {
+      return CAPTURE_INDENT | CAPTURE_EXTEND;
+    }
+    if (ts_node_is_error(parent)) {
+      return CAPTURE_INDENT_ALWAYS | CAPTURE_EXTEND;
+    }
+    return 0;
+  }
+  if (sym == s->rparen) {
+    // Don't outdent on function parameter declarations.
+    TSNode parent = ts_node_parent(node);
+    return !ts_node_is_null(parent) && ts_node_symbol(parent) == s->atom
+               ? CAPTURE_OUTDENT | CAPTURE_EXTEND_PREVENT_ONCE
+               : 0;
+  }
+  if (sym == s->rbracket || sym == s->rbrace) {
+    return CAPTURE_OUTDENT | CAPTURE_EXTEND_PREVENT_ONCE;
+  }
+  return 0;
+}
+
+struct added_indent {
+  bool indent;
+  bool outdent;
+  int indent_always;
+  int outdent_always;
+};
+
+static void added_indent_add(struct added_indent *added, unsigned captures) {
+  if (captures & CAPTURE_INDENT_ALWAYS) {
+    added->indent = false;
+    added->indent_always++;
+  } else if ((captures & CAPTURE_INDENT) && added->indent_always == 0) {
+    added->indent = true;
+  }
+  if ((captures & CAPTURE_OUTDENT) && added->outdent_always == 0) {
+    added->outdent = true;
+  }
+}
+
+// Multiple captures of the same kind on one line don't stack, and an indent
+// and outdent on the same line cancel out.
+static int added_indent_levels(const struct added_indent *added) {
+  int levels = added->indent_always - added->outdent_always;
+  if (added->indent && !added->outdent) {
+    levels++;
+  } else if (added->outdent && !added->indent) {
+    levels--;
+  }
+  return levels;
+}
+
+static bool is_space(char c) { return c == ' ' || c == '\t' || c == '\r'; }
+
+static uint32_t indent_columns(const char *source, uint32_t source_len,
+                               uint32_t line_start) {
+  uint32_t columns = 0;
+  for (uint32_t i = line_start; i < source_len && is_space(source[i]); i++) {
+    columns = source[i] == '\t' ? columns + TABWIDTH : columns + 1;
+  }
+  return columns;
+}
+
+static uint32_t line_start_for_byte(const char *source, uint32_t byte) {
+  while (byte > 0 && source[byte - 1] != '\n') {
+    byte--;
+  }
+  return byte;
+}
+
+static bool is_first_in_line(const char *source, uint32_t source_len,
+                             TSNode node) {
+  uint32_t start = ts_node_start_byte(node);
+  uint32_t column = ts_node_start_point(node).column;
+  if (start > source_len || column > start) {
+    return false;
+  }
+  for (uint32_t i = start - column; i < start; i++) {
+    if (!is_space(source[i])) {
+      return false;
+    }
+  }
+  return true;
+}
+
+// The row of the line starting at line_start, counted from the deepest node
+// containing it rather than from the start of the file.
+static uint32_t row_for_line_start(TSNode root, const char *source,
+                                   uint32_t line_start) {
+  TSNode node = ts_node_descendant_for_byte_range(root, line_start, line_start);
+  uint32_t start = ts_node_start_byte(node);
+  uint32_t row = ts_node_start_point(node).row;
+  if (start > line_start) {
+    start = 0;
+    row = 0;
+  }
+  for (const char *p = source + start, *end = source + line_start; p < end;
+       p++) {
+    p = memchr(p, '\n', (size_t)(end - p));
+    if (!p) {
+      break;
+    }
+    row++;
+  }
+  return row;
+}
+
+// The row a node starts on, where nodes at or after new_line_byte count as
+// being on the line after it.
+static uint32_t node_start_row(TSNode node, bool new_line,
+                               uint32_t new_line_byte) {
+  uint32_t row = ts_node_start_point(node).row;
+  return new_line && ts_node_start_byte(node) >= new_line_byte ? row + 1 : row;
+}
+
+static void extend_node(const struct symbols *s, const char *source,
+                        uint32_t source_len, TSNode *node,
+                        TSNode deepest_preceding, uint32_t row,
+                        uint32_t line_indent) {
+  bool stop_extend = false;
+  while (!ts_node_eq(deepest_preceding, *node)) {
+    unsigned captures = captures_for_node(s, deepest_preceding);
+    bool extend = false;
+    if (captures & CAPTURE_EXTEND_PREVENT_ONCE) {
+      stop_extend = true;
+    }
+    if (captures & CAPTURE_EXTEND) {
+      // Extend if the line ends the node, or is indented more than the node's
+      // first line.
+      if (ts_node_end_point(deepest_preceding).row == row) {
+        extend = true;
+      } else {
+        uint32_t node_start = ts_node_start_byte(deepest_preceding);
+        extend = line_indent > indent_columns(source, source_len,
+                                              line_start_for_byte(
+                                                  source, node_start));
+      }
+    }
+
+    if ((captures & CAPTURE_EXTEND) && stop_extend) {
+      stop_extend = false;
+    } else if (extend && !stop_extend) {
+      *node = deepest_preceding;
+      return;
+    }
+
+    deepest_preceding = ts_node_parent(deepest_preceding);
+    if (ts_node_is_null(deepest_preceding)) {
+      return;
+    }
+  }
+}
+
+// Layout: a line starting with a start continuation token (an operator, or
+// then/elif/else) continues the expression on the line before it, so it's
+// indented one level past that expression's first line.
+static bool continues_expression(const struct symbols *s, TSNode node,
+                                 uint32_t row) {
+  TSSymbol sym = ts_node_symbol(node);
+  TSNode parent = ts_node_parent(node);
+  if (sym == s->then || sym == s->elif || sym == s->else_) {
+    while (!ts_node_is_null(parent) && ts_node_symbol(parent) == s->elifs) {
+      parent = ts_node_parent(parent);
+    }
+    return !ts_node_is_null(parent) && ts_node_symbol(parent) == s->ifexpr &&
+           ts_node_start_point(parent).row < row;
+  }
+
+  for (int depth = 0; depth < 2 && !ts_node_is_null(parent); depth++) {
+    if (ts_node_symbol(parent) == s->qoperator) {
+      TSNode opexpr = ts_node_parent(parent);
+      return !ts_node_is_null(opexpr) && ts_node_symbol(opexpr) == s->opexpr &&
+             ts_node_start_point(opexpr).row < row;
+    }
+    parent = ts_node_parent(parent);
+  }
+  return false;
+}
+
+uint32_t tree_sitter_koka_indent_for_line(const TSTree *tree,
+                                          const char *source,
+                                          uint32_t source_len, uint32_t byte,
+                                          uint32_t indent_width) {
+  if (byte > source_len) {
+    byte = source_len;
+  }
+  struct symbols s;
+  symbols_init(&s, ts_tree_language(tree));
+  TSNode root = ts_tree_root_node(tree);
+
+  uint32_t line_start = line_start_for_byte(source, byte);
+  uint32_t content_start = line_start;
+  while (content_start < source_len && is_space(source[content_start])) {
+    content_start++;
+  }
+  uint32_t row = row_for_line_start(root, source, line_start);
+  uint32_t line_indent = indent_columns(source, source_len, line_start);
+
+  // A blank line is treated as if it had just been inserted by breaking the
+  // previous non-blank line at its end.
+  bool new_line = content_start == source_len || source[content_start] == '\n';
+  uint32_t query_byte = content_start;
+  uint32_t query_row = row;
+  if (new_line) {
+    uint32_t prev_end = line_start;
+    while (prev_end > 0 && (source[prev_end - 1] == '\n' ||
+                            is_space(source[prev_end - 1]))) {
+      prev_end--;
+    }
+    if (prev_end == 0) {
+      return 0;
+    }
+    query_byte = prev_end;
+    query_row = row_for_line_start(root, source,
+                                   line_start_for_byte(source, prev_end));
+  }
+
+  TSNode node = ts_node_descendant_for_byte_range(root, query_byte, query_byte);
+  bool continuation = !new_line && continues_expression(&s, node, row);
+
+  // Extend the query node to the deepest node that ends before the line and
+  // is captured with @extend, if the line belongs to it.
+  TSNode deepest_preceding = {0};
+  bool have_preceding = false;
+  uint32_t child_count = ts_node_child_count(node);
+  for (uint32_t i = 0; i < child_count; i++) {
+    TSNode child = ts_node_child(node, i);
+    if (ts_node_end_byte(child) <= query_byte &&
+        ts_node_start_byte(child) < query_byte) {
+      deepest_preceding = child;
+      have_preceding = true;
+    }
+  }
+  if (have_preceding) {
+    while (ts_node_child_count(deepest_preceding) > 0) {
+      deepest_preceding = ts_node_child(
+          deepest_preceding, ts_node_child_count(deepest_preceding) - 1);
+    }
+    extend_node(&s, source, source_len, &node, deepest_preceding, query_row,
+                new_line ? UINT32_MAX : line_indent);
+  }
+
+  // Walk up the tree, grouping captures by the line their node starts on.
+  int levels = continuation ? 1 : 0;
+  struct added_indent for_line = {0}, for_line_below = {0};
+  uint32_t line = new_line ? query_row + 1 : row;
+  while (true) {
+    unsigned captures = captures_for_node(&s, node);
+    // @outdent applies to the node's own line, @indent only to the lines
+    // below it.
+    unsigned all_scope = captures & CAPTURE_OUTDENT;
+    unsigned tail_scope = captures & (CAPTURE_INDENT | CAPTURE_INDENT_ALWAYS);
+    if (all_scope) {
+      bool first = new_line ? ts_node_start_byte(node) >= query_byte
+                            : is_first_in_line(source, source_len, node);
+      added_indent_add(first ? &for_line : &for_line_below, all_scope);
+    }
+    added_indent_add(&for_line_below, tail_scope);
+
+    uint32_t node_row = node_start_row(node, new_line, query_byte);
+    TSNode parent = ts_node_parent(node);
+    if (ts_node_is_null(parent)) {
+      if (node_row < line) {
+        levels += added_indent_levels(&for_line_below);
+      }
+      levels += added_indent_levels(&for_line);
+      break;
+    }
+
+    uint32_t parent_row = node_start_row(parent, new_line, query_byte);
+    if (node_row != parent_row) {
+      if (node_row < line) {
+        levels += added_indent_levels(&for_line_below);
+      }
+      if (node_row == parent_row + 1) {
+        for_line_below = for_line;
+      } else {
+        levels += added_indent_levels(&for_line);
+        for_line_below = (struct added_indent){0};
+      }
+      for_line = (struct added_indent){0};
+    }
+    node = parent;
+  }
+
+  return levels > 0 ? (uint32_t)levels * indent_width : 0;
+}
@@ -0,0 +1,165 @@
+#include "tree-sitter-koka-utils.h"
+#include <stdbool.h>
+#include <string.h>
+
+// Keep in sync with queries/injections.scm.
+
+struct symbols {
+  TSSymbol program, moduledecl, modulebody, topdecl, externdecl, externbody,
+      externimpbody, externimp, externstat, externtarget, varid, string;
+};
+
+static TSSymbol symbol(const TSLanguage *language, const char *name) {
+  return ts_language_symbol_for_name(language, name, (uint32_t)strlen(name),
+                                     true);
+}
+
+static void symbols_init(struct symbols *s, const TSLanguage *language) {
+  s->program = symbol(language, "program");
+  s->moduledecl = symbol(language, "moduledecl");
+  s->modulebody = symbol(language, "modulebody");
+  s->topdecl = symbol(language, "topdecl");
+  s->externdecl = symbol(language, "externdecl");
+  s->externbody = symbol(language, "externbody");
+  s->externimpbody = symbol(language, "externimpbody");
+  s->externimp = symbol(language, "externimp");
+  s->externstat = symbol(language, "externstat");
+  s->externtarget = symbol(language, "externtarget");
+  s->varid = symbol(language, "varid");
+  s->string = symbol(language, "string");
+}
+
+// The nodes that can contain an extern declaration's strings. Nothing else is
+// descended into, so only the top level of the module is visited outside of
+// extern declarations.
+static bool is_container(const struct symbols *s, TSSymbol sym) {
+  return sym == s->program || sym == s->moduledecl || sym == s->modulebody ||
+         sym == s->topdecl || sym == s->externdecl || sym == s->externbody ||
+         sym == s->externimpbody;
+}
+
+static bool node_text_is(const char *source, uint32_t source_len, TSNode node,
+                         const char *text) {
+  uint32_t start = ts_node_start_byte(node), end = ts_node_end_byte(node);
+  size_t len = strlen(text);
+  return end <= source_len && end - start == len &&
+         memcmp(source + start, text, len) == 0;
+}
+
+static bool node_text_ends_with(const char *source, uint32_t source_len,
+                                TSNode node, const char *suffix) {
+  uint32_t start = ts_node_start_byte(node), end = ts_node_end_byte(node);
+  size_t len = strlen(suffix);
+  return end <= source_len && end - start >= len &&
+         memcmp(source + end - len, suffix, len) == 0;
+}
+
+static const char *target_language(const char *source, uint32_t source_len,
+                                   TSNode target) {
+  if (node_text_is(source, source_len, target, "c")) {
+    return "c";
+  }
+  if (node_text_is(source, source_len, target, "js")) {
+    return "javascript";
+  }
+  if (node_text_is(source, source_len, target, "cs")) {
+    return "c-sharp";
+  }
+  return NULL;
+}
+
+// The range of a string literal's contents, without its quotes or, for raw
+// strings, the r and pound signs around them.
+static bool string_contents(const char *source, uint32_t source_len,
+                            TSNode string, TSRange *range) {
+  uint32_t start = ts_node_start_byte(string), end = ts_node_end_byte(string);
+  if (end > source_len || start >= end) {
+    return false;
+  }
+
+  uint32_t open = 1, close = 1;
+  if (source[start] == 'r') {
+    uint32_t pounds = 0;
+    while (start + 1 + pounds < end && source[start + 1 + pounds] == '#') {
+      pounds++;
+    }
+    open = 2 + pounds;
+    close = 1 + pounds;
+  }
+  if (end - start < open + close) {
+    return false;
+  }
+
+  TSPoint start_point = ts_node_start_point(string);
+  TSPoint end_point = ts_node_end_point(string);
+  *range = (TSRange){
+      .start_point = {start_point.row, start_point.column + open},
+      .end_point = {end_point.row, end_point.column - close},
+      .start_byte = start + open,
+      .end_byte = end - close,
+  };
+  return true;
+}
+
+uint32_t tree_sitter_koka_injections(TSNode root, const char *source,
+                                     uint32_t source_len,
+                                     TSKokaInjection *injections,
+                                     uint32_t capacity) {
+  struct symbols s;
+  symbols_init(&s, ts_node_language(root));
+
+  uint32_t count = 0;
+  TSTreeCursor cursor = ts_tree_cursor_new(root);
+  while (true) {
+    TSNode node = ts_tree_cursor_current_node(&cursor);
+    TSSymbol sym = ts_node_symbol(node);
+
+    if (sym == s.externstat || sym == s.externimp) {
+      TSNode target = {0}, kind = {0}, string = {0};
+      bool have_target = false, have_kind = false, have_string = false;
+      uint32_t child_count = ts_node_named_child_count(node);
+      for (uint32_t i = 0; i < child_count; i++) {
+        TSNode child = ts_node_named_child(node, i);
+        TSSymbol child_sym = ts_node_symbol(child);
+        if (child_sym == s.externtarget) {
+          target = child;
+          have_target = true;
+        } else if (child_sym == s.varid) {
+          kind = child;
+          have_kind = true;
+        } else if (child_sym == s.string) {
+          string = child;
+          have_string = true;
+        }
+      }
+
+      // Only inline imports hold code, the others name files.
+      bool is_code = sym == s.externstat ||
+                     (have_kind && node_text_ends_with(source, source_len,
+                                                       kind, "inline"));
+      const char *language =
+          have_target ? target_language(source, source_len, target) : NULL;
+      TSRange range;
+      if (is_code && language && have_string &&
+          string_contents(source, source_len, string, &range)) {
+        if (count < capacity) {
+          injections[count] = (TSKokaInjection){
+              .range = range,
+              .language = language,
+          };
+        }
+        count++;
+      }
+    } else if (is_container(&s, sym) &&
+               ts_tree_cursor_goto_first_child(&cursor)) {
+      continue;
+    }
+
+    while (!ts_tree_cursor_goto_next_sibling(&cursor)) {
+      if (!ts_tree_cursor_goto_parent(&cursor)) {
+        ts_tree_cursor_delete(&cursor);
+        return count;
+      }
+    }
+  }
+}